@@ -0,0 +1,126 @@
+#ifndef COMMANDHANDLER_H
+#define COMMANDHANDLER_H
+
+#include <XPLMUtilities.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * CommandHandler - Create, find and handle X-Plane commands in bulk
+ *
+ * Commands are kept in one flat table. Each registered handler is a plain
+ * function pointer plus a context pointer, and the SDK refcon points
+ * straight at the table entry, so begin/continue/end phases are dispatched
+ * without lookups or heap-allocated closures. member<T, &T::method> turns a
+ * member function into such a handler. Every entry counts its phases and
+ * the time spent in the handler.
+ *
+ * Menus bind to commands with MenuItem::addCommandItem() or
+ * MenuSpec::commandItem(), so a menu click and a joystick button run the same
+ * handler.
+ *
+ * Example usage:
+ *   class MyPlugin {
+ *       int onToggle(XPLMCommandPhase phase) {
+ *           if (phase == xplm_CommandBegin) toggle();
+ *           return 0;  // handled, stop other handlers
+ *       }
+ *   };
+ *
+ *   CommandHandler commands;
+ *   int toggle = commands.add("myplugin/window/toggle", "Toggle window",
+ *                             CommandHandler::member<MyPlugin, &MyPlugin::onToggle>, this);
+ *   commands.add({
+ *       {"myplugin/view/next", "Next view", &onNextView, this},
+ *       {"myplugin/view/prev", "Previous view", &onPrevView, this},
+ *   });
+ *   menu.addCommandItem("Toggle window", commands.getCommand(toggle));
+ */
+class CommandHandler
+{
+public:
+    // Return 1 to let X-Plane and other handlers process the command, 0 to consume it
+    using Callback = int (*)(XPLMCommandPhase phase, void *context);
+
+    struct Definition
+    {
+        const char *name;
+        const char *description;
+        Callback callback; // Null: only create/find the command
+        void *context;
+        bool before = false; // Run before X-Plane's own handling
+    };
+
+    struct Stats
+    {
+        std::uint64_t begins = 0;
+        std::uint64_t continues = 0;
+        std::uint64_t ends = 0;
+        std::uint64_t handlerNs = 0; // Total time spent in the callback
+    };
+
+    CommandHandler() = default;
+    ~CommandHandler();
+
+    // Prevent copying (X-Plane holds pointers into the table)
+    CommandHandler(const CommandHandler&) = delete;
+    CommandHandler& operator=(const CommandHandler&) = delete;
+
+    // Create (or find, if it already exists) a command and attach the
+    // handler. Returns the table index or -1.
+    int add(const char *name, const char *description, Callback callback, void *context,
+            bool before = false);
+    int add(const Definition &definition);
+
+    // Register many commands in one pass; returns how many succeeded
+    std::size_t add(const std::vector<Definition> &definitions);
+
+    // Look up an existing X-Plane command, e.g. "sim/operation/pause_toggle",
+    // without handling it. Returns the table index or -1.
+    int find(const char *name);
+
+    // Table index of a command added or found before, or -1
+    int indexOf(const std::string &name) const;
+
+    XPLMCommandRef getCommand(int index) const;
+    const Stats &getStats(int index) const;
+    std::size_t size() const { return entries.size(); }
+
+    // Trigger a command through X-Plane so every handler sees it
+    void once(int index) const;
+    void begin(int index) const;
+    void end(int index) const;
+
+    // Detach all handlers and forget the table
+    void clear();
+
+    // Adapter for int T::method(XPLMCommandPhase)
+    template<typename T, int (T::*Method)(XPLMCommandPhase)>
+    static int member(XPLMCommandPhase phase, void *context)
+    {
+        return (static_cast<T *>(context)->*Method)(phase);
+    }
+
+private:
+    struct Entry
+    {
+        XPLMCommandRef command = nullptr;
+        Callback callback = nullptr;
+        void *context = nullptr;
+        bool before = false;
+        std::string name;
+        Stats stats;
+    };
+
+    static int dispatch(XPLMCommandRef command, XPLMCommandPhase phase, void *refcon);
+
+    // Entries never move, so their addresses serve as SDK refcons
+    std::deque<Entry> entries;
+    std::unordered_map<std::string, int> byName;
+};
+
+#endif // COMMANDHANDLER_H
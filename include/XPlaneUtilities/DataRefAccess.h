@@ -2,6 +2,7 @@
 #define DATAREFACCESS_H
 
 #include <XPLMDataAccess.h>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
 
@@ -14,6 +15,9 @@ namespace XPlaneUtilities {
  * exposes typed read/write access for datarefs owned by X-Plane or other
  * plugins. Unlike DataRefExport, this class does not register a new dataref.
  *
+ * While a DataRefWriteBatch is active, set() records the write into the
+ * batch instead of calling the SDK, and reads return the pending value.
+ *
  * Example usage:
  *   DataRefAccess<int> beaconOn("sim/cockpit/electrical/beacon_lights_on");
  *   beaconOn = 1;
@@ -38,7 +42,7 @@ public:
     XPLMDataTypeID getTypes() const { return supportedTypes; }
 
 private:
-    std::string dataRefName;
+    std::pmr::string dataRefName; // MemoryComponent::DataRefs
     T overrideValue{};
     XPLMDataRef handle = nullptr;
     XPLMDataTypeID supportedTypes = xplmType_Unknown;
@@ -0,0 +1,140 @@
+#ifndef DATAREFCATALOG_H
+#define DATAREFCATALOG_H
+
+/*
+ *   XPlaneUtilities - Index of the simulator's published DataRefs.txt
+ *
+ *   This header is independent of the X-Plane SDK so that offline tools can
+ *   validate dataref tables without running the simulator.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+/**
+ * DataRefCatalog - O(1) lookup of dataref names, types, writability and units
+ *
+ * loadText() memory-maps DataRefs.txt and builds a minimal perfect hash
+ * (hash-and-displace) over the names: one probe into a displacement table
+ * gives the only slot a name can occupy, and one string compare confirms it.
+ * The finished index is a single flat image (header, displacements, records,
+ * string pool) that save() writes out and loadIndex() maps back in without
+ * any parsing, so later starts only pay for an mmap.
+ *
+ * Types use the XPLMDataTypeID bit values, so they can be compared with
+ * XPLMGetDataRefTypes(). "double" datarefs are listed as float | double,
+ * matching what the simulator advertises for them.
+ *
+ * Example usage:
+ *   DataRefCatalog catalog;
+ *   if (catalog.load(xplaneDir + "/Resources/plugins/DataRefs.txt",
+ *                    pluginDir + "/DataRefs.idx")) {
+ *       DataRefCatalog::Entry entry;
+ *       if (catalog.find("sim/cockpit/electrical/beacon_lights_on", entry) && entry.writable) {
+ *           ...
+ *       }
+ *   } else {
+ *       XPlaneLog::warn(catalog.error());
+ *   }
+ */
+class DataRefCatalog
+{
+public:
+    // XPLMDataTypeID bits
+    enum Type : std::uint32_t
+    {
+        Int = 1,
+        Float = 2,
+        Double = 4,
+        FloatArray = 8,
+        IntArray = 16,
+        Data = 32
+    };
+
+    struct Entry
+    {
+        std::string_view name;
+        std::uint32_t types = 0;
+        std::uint32_t arraySize = 0; // Elements (bytes for Data); 0 for scalars
+        bool writable = false;
+        std::string_view units;
+    };
+
+    enum class Check
+    {
+        Ok,
+        Unknown,      // Name not in the catalog
+        TypeMismatch, // None of the expected types is available
+        ReadOnly      // Write access expected but the dataref is read-only
+    };
+
+    DataRefCatalog() = default;
+    ~DataRefCatalog();
+
+    DataRefCatalog(const DataRefCatalog&) = delete;
+    DataRefCatalog& operator=(const DataRefCatalog&) = delete;
+
+    // Parse DataRefs.txt and build the index
+    bool loadText(const std::string &path);
+
+    // Write / map a serialized index. save() writes a temporary file and
+    // renames it over path; loadIndex() rejects a truncated or corrupt index.
+    bool save(const std::string &path) const;
+    bool loadIndex(const std::string &path);
+
+    // Use cachePath if it was built from the current sourcePath, otherwise
+    // parse sourcePath and rewrite the cache (a failed write is not an error).
+    // On failure the catalog is left empty.
+    bool load(const std::string &sourcePath, const std::string &cachePath);
+
+    void clear();
+    bool isLoaded() const { return header != nullptr; }
+
+    // Look up a name; entry views stay valid until the catalog is cleared or reloaded
+    bool find(std::string_view name, Entry &entry) const;
+    bool contains(std::string_view name) const;
+
+    // expectedTypes of 0 only checks the name
+    Check check(std::string_view name, std::uint32_t expectedTypes, bool needWrite) const;
+
+    std::size_t size() const;
+
+    // First line of DataRefs.txt (file format and simulator version)
+    std::string_view sourceVersion() const;
+
+    // Parse a DataRefs.txt type column such as "float", "int[8]" or "byte[40]"
+    static bool parseType(std::string_view text, std::uint32_t &types, std::uint32_t &arraySize);
+
+    // Readable form of a type mask, e.g. "float|double"
+    static std::string typeName(std::uint32_t types);
+
+    // Description of the last failure
+    const std::string& error() const { return lastError; }
+
+private:
+    struct Header;
+    struct Record;
+
+    // Validate an index image in O(n) and point at it
+    bool adopt(const char *data, std::size_t size);
+    const Record *slotFor(std::string_view name) const;
+
+    std::vector<char> storage; // Index built by loadText()
+    void *mapping = nullptr;   // Index mapped by loadIndex()
+    std::size_t mappingSize = 0;
+
+    const Header *header = nullptr;
+    const std::int32_t *displacements = nullptr;
+    const Record *records = nullptr;
+    const char *pool = nullptr;
+    std::string lastError;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DATAREFCATALOG_H
@@ -2,25 +2,70 @@
 #define DATAREFEXPORT_H
 
 #include <XPLMDataAccess.h>
-#include <string>
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
 
 namespace XPlaneUtilities {
 
+// Convert between the int, float and double views of an exported dataref.
+// A plain static_cast is undefined for NaN and for values outside the target
+// range, and both come from other plugins, so NaN becomes 0 and finite values
+// are clamped to the target range. Infinities are kept for float targets.
+template<typename U, typename T>
+U convertScalar(T value)
+{
+    if constexpr (std::is_floating_point<T>::value && !std::is_same<T, U>::value)
+    {
+        if (std::isnan(value))
+        {
+            return std::is_integral<U>::value ? U(0) : static_cast<U>(value);
+        }
+        if (std::is_integral<U>::value || std::isfinite(value))
+        {
+            constexpr U lowest = std::numeric_limits<U>::lowest();
+            constexpr U highest = std::numeric_limits<U>::max();
+            if (value <= static_cast<T>(lowest))
+            {
+                return lowest;
+            }
+            if (value >= static_cast<T>(highest))
+            {
+                return highest;
+            }
+        }
+    }
+    return static_cast<U>(value);
+}
+
 /**
  * DataRefExport - Export custom datarefs to X-Plane
- * 
+ *
  * Based on AviTab's implementation, this template class simplifies
  * the creation of custom datarefs that other plugins or systems can read.
- * 
- * Supports read-only and read-write datarefs for int and float types.
- * 
+ *
+ * Supports read-only and read-write datarefs for int, float and double types.
+ * A dataref can additionally advertise other scalar types (for example
+ * xplmType_Float | xplmType_Double); readers may then fetch whichever type
+ * they prefer and the value is converted once with convertScalar().
+ *
+ * The owning plugin can read or write its own value through get()/set(),
+ * which call the callbacks directly instead of going through the SDK.
+ *
  * Example usage:
  *   auto myDataRef = std::make_unique<DataRefExport<int>>(
  *       "simbreviloquent/flight_plan/loaded",
  *       this,
  *       [](void *ref) { return static_cast<MyClass*>(ref)->isLoaded() ? 1 : 0; }
  *   );
+ *
+ *   DataRefExport<double> latitude(
+ *       "simbreviloquent/position/latitude", this,
+ *       [](void *ref) { return static_cast<MyClass*>(ref)->latitude(); },
+ *       xplmType_Float | xplmType_Double);
+ *   double lat = latitude.get();  // no SDK round-trip
  */
 template<typename T>
 class DataRefExport final
@@ -28,22 +73,47 @@ class DataRefExport final
 public:
     // Read-only dataref
     DataRefExport(const std::string &name, void *owner, std::function<T(void *)> onRead);
-    
+
+    // Read-only dataref advertising additional scalar types
+    DataRefExport(const std::string &name, void *owner, std::function<T(void *)> onRead,
+                  XPLMDataTypeID types);
+
     // Read-write dataref
-    DataRefExport(const std::string &name, void *owner, 
+    DataRefExport(const std::string &name, void *owner,
                   std::function<T(void *)> onRead,
                   std::function<void(void *, T)> onWrite);
-    
+
+    // Read-write dataref advertising additional scalar types
+    DataRefExport(const std::string &name, void *owner,
+                  std::function<T(void *)> onRead,
+                  std::function<void(void *, T)> onWrite,
+                  XPLMDataTypeID types);
+
     ~DataRefExport();
 
     // Prevent copying
     DataRefExport(const DataRefExport&) = delete;
     DataRefExport& operator=(const DataRefExport&) = delete;
 
+    // Read the exported value locally (calls onRead directly)
+    T get() const { return onRead(ownerRef); }
+    operator T() const { return get(); }
+
+    // Write the exported value locally; returns false for read-only exports
+    bool set(T value);
+
+    bool isValid() const { return xpDataRef != nullptr; }
+    bool isWritable() const { return static_cast<bool>(onWrite); }
+    XPLMDataTypeID getTypes() const { return dataTypes; }
+    XPLMDataRef getHandle() const { return xpDataRef; }
+
 private:
+    void registerAccessor(const std::string &name);
+
     void *ownerRef;
     std::function<T(void *)> onRead;
     std::function<void(void *, T)> onWrite;
+    XPLMDataTypeID dataTypes = xplmType_Unknown;
     XPLMDataRef xpDataRef = nullptr;
 };
 
@@ -0,0 +1,213 @@
+#ifndef DATAREFEXPORTGROUP_H
+#define DATAREFEXPORTGROUP_H
+
+#include "DataRefExport.h"
+#include "StartupProfiler.h"
+#include <XPLMDataAccess.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace XPlaneUtilities {
+
+/**
+ * DataRefExportGroup - Exported datarefs served from a struct published once per frame
+ *
+ * Each dataref of the group is a member of State. The owner fills in the
+ * next state and publish()es it; until the next publish every dataref of
+ * the group is read from that committed copy. A reader fetching latitude,
+ * longitude and altitude one after the other therefore gets values from the
+ * same update even if the owner is half-way through preparing the next one,
+ * and a read is a plain load with no user callback or recomputation.
+ *
+ * State is double-buffered: edit() returns the back buffer (holding the
+ * committed values the first time it is called after a publish), so
+ * building the next state never disturbs the one being served. Exports are
+ * read-only and, like all accessors, called on the sim thread; publish()
+ * belongs on the sim thread too, typically at the end of a flight loop.
+ *
+ * Example usage:
+ *   struct Position { double latitude, longitude; float altitude; int onGround; };
+ *
+ *   DataRefExportGroup<Position> position;
+ *   position.add("myplugin/position/latitude", &Position::latitude,
+ *                xplmType_Float | xplmType_Double);
+ *   position.add("myplugin/position/longitude", &Position::longitude,
+ *                xplmType_Float | xplmType_Double);
+ *   position.add("myplugin/position/altitude_m", &Position::altitude);
+ *   position.add("myplugin/position/on_ground", &Position::onGround);
+ *   position.registerAll();       // XPluginEnable
+ *
+ *   // Flight loop
+ *   Position &next = position.edit();
+ *   next.latitude = ...;
+ *   next.altitude = ...;
+ *   position.publish();
+ */
+template<typename State>
+class DataRefExportGroup
+{
+public:
+    DataRefExportGroup() = default;
+    explicit DataRefExportGroup(const State &initial) : buffers{initial, initial} {}
+    ~DataRefExportGroup() { unregisterAll(); }
+
+    // Prevent copying (registered accessors point into the group)
+    DataRefExportGroup(const DataRefExportGroup&) = delete;
+    DataRefExportGroup& operator=(const DataRefExportGroup&) = delete;
+
+    // Declare a dataref for an int, float or double member of State,
+    // optionally advertising additional scalar types. Fields declared after
+    // registerAll() are registered by the next registerAll().
+    template<typename T>
+    void add(const std::string &name, T State::*member, XPLMDataTypeID types = xplmType_Unknown)
+    {
+        fields<T>().push_back({name, member, (types & kScalarTypes) | nativeType<T>(), nullptr,
+                               this});
+    }
+
+    // Register every declared field that is not registered yet
+    void registerAll()
+    {
+        registerFields<int>();
+        registerFields<float>();
+        registerFields<double>();
+    }
+
+    void unregisterAll()
+    {
+        unregisterFields<int>();
+        unregisterFields<float>();
+        unregisterFields<double>();
+    }
+
+    // Back buffer for the next state
+    State &edit()
+    {
+        if (backStale)
+        {
+            buffers[1 - front] = buffers[front];
+            backStale = false;
+        }
+        return buffers[1 - front];
+    }
+
+    // Commit the back buffer; the datarefs serve it from now on
+    void publish()
+    {
+        edit(); // An unedited publish repeats the committed state
+        front = 1 - front;
+        backStale = true;
+        ++publishCount;
+    }
+
+    void publish(const State &state)
+    {
+        buffers[1 - front] = state;
+        backStale = false;
+        publish();
+    }
+
+    // State the datarefs currently serve
+    const State &committed() const { return buffers[front]; }
+
+    std::uint64_t generation() const { return publishCount; }
+    std::size_t size() const
+    {
+        return std::get<0>(declared).size() + std::get<1>(declared).size() +
+               std::get<2>(declared).size();
+    }
+
+private:
+    static constexpr XPLMDataTypeID kScalarTypes = xplmType_Int | xplmType_Float | xplmType_Double;
+
+    template<typename T>
+    static constexpr XPLMDataTypeID nativeType()
+    {
+        return std::is_same<T, int>::value     ? xplmType_Int
+               : std::is_same<T, float>::value ? xplmType_Float
+                                               : xplmType_Double;
+    }
+
+    template<typename T>
+    struct Field
+    {
+        std::string name;
+        T State::*member;
+        XPLMDataTypeID types;
+        XPLMDataRef handle;
+        const DataRefExportGroup *group;
+    };
+
+    // A deque keeps registered fields in place while more are declared
+    template<typename T>
+    using FieldList = std::deque<Field<T>>;
+
+    template<typename T>
+    FieldList<T> &fields()
+    {
+        static_assert(std::is_same<T, int>::value || std::is_same<T, float>::value ||
+                          std::is_same<T, double>::value,
+                      "DataRefExportGroup fields must be int, float or double");
+        return std::get<FieldList<T>>(declared);
+    }
+
+    // C callback handed to XPLMRegisterDataAccessor; the refcon is the Field
+    template<typename T, typename U>
+    static U read(void *refcon)
+    {
+        const Field<T> *field = static_cast<const Field<T> *>(refcon);
+        return convertScalar<U>(field->group->committed().*(field->member));
+    }
+
+    template<typename T>
+    void registerFields()
+    {
+        for (Field<T> &field : fields<T>())
+        {
+            if (field.handle)
+            {
+                continue;
+            }
+
+            StartupProfiler::Scope profile("DataRefs", field.name);
+            const bool hasInt = (field.types & xplmType_Int) != 0;
+            const bool hasFloat = (field.types & xplmType_Float) != 0;
+            const bool hasDouble = (field.types & xplmType_Double) != 0;
+            field.handle = XPLMRegisterDataAccessor(
+                field.name.c_str(), field.types, 0,
+                hasInt ? &read<T, int> : nullptr, nullptr,
+                hasFloat ? &read<T, float> : nullptr, nullptr,
+                hasDouble ? &read<T, double> : nullptr, nullptr,
+                nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                &field, nullptr);
+        }
+    }
+
+    template<typename T>
+    void unregisterFields()
+    {
+        for (Field<T> &field : fields<T>())
+        {
+            if (field.handle)
+            {
+                XPLMUnregisterDataAccessor(field.handle);
+                field.handle = nullptr;
+            }
+        }
+    }
+
+    State buffers[2] = {};
+    int front = 0;
+    bool backStale = true; // Back buffer is older than the committed state
+    std::uint64_t publishCount = 0;
+
+    std::tuple<FieldList<int>, FieldList<float>, FieldList<double>> declared;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DATAREFEXPORTGROUP_H
@@ -0,0 +1,123 @@
+#ifndef DATAREFEXPORTREGISTRY_H
+#define DATAREFEXPORTREGISTRY_H
+
+#include "DataRefExport.h"
+#include <XPLMDataAccess.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+/**
+ * DataRefExportRegistry - Declare many exported datarefs and register them in one pass
+ *
+ * Declarations are cheap and do not touch the SDK. registerAll() creates every
+ * DataRefExport, then resolves the dataref browser plugins (DataRefEditor,
+ * DataRefTool) once and announces all names to them in a single loop.
+ * Exports that fail to register (usually because another plugin owns the
+ * name) are logged and dropped; they are neither counted nor announced.
+ * unregisterAll() tears everything down again, typically from XPluginDisable.
+ * Both phases are timed and reported through XPlaneLog.
+ *
+ * Example usage:
+ *   DataRefExportRegistry exports;
+ *   exports.declare<int>("myplugin/state/loaded", this,
+ *       [](void *ref) { return static_cast<MyClass*>(ref)->isLoaded() ? 1 : 0; });
+ *   exports.declare<double>("myplugin/position/latitude", this,
+ *       [](void *ref) { return static_cast<MyClass*>(ref)->latitude(); },
+ *       xplmType_Float | xplmType_Double);
+ *
+ *   exports.registerAll();    // XPluginEnable
+ *   exports.unregisterAll();  // XPluginDisable
+ */
+class DataRefExportRegistry
+{
+public:
+    DataRefExportRegistry() = default;
+    ~DataRefExportRegistry();
+
+    // Prevent copying (registered accessors point back into the registry)
+    DataRefExportRegistry(const DataRefExportRegistry&) = delete;
+    DataRefExportRegistry& operator=(const DataRefExportRegistry&) = delete;
+
+    // Pre-size storage for a known number of declarations
+    void reserve(std::size_t count);
+
+    // Declare a read-only export (T is int, float or double)
+    template<typename T>
+    void declare(const std::string &name, void *owner, std::function<T(void *)> onRead,
+                 XPLMDataTypeID types = xplmType_Unknown)
+    {
+        declarations<T>().push_back({name, owner, std::move(onRead), nullptr, types});
+    }
+
+    // Declare a read-write export (T is int, float or double)
+    template<typename T>
+    void declare(const std::string &name, void *owner, std::function<T(void *)> onRead,
+                 std::function<void(void *, T)> onWrite,
+                 XPLMDataTypeID types = xplmType_Unknown)
+    {
+        declarations<T>().push_back(
+            {name, owner, std::move(onRead), std::move(onWrite), types});
+    }
+
+    // Register all pending declarations and notify dataref browser plugins
+    void registerAll();
+
+    // Unregister every export created by registerAll(); declarations are kept
+    void unregisterAll();
+
+    bool isRegistered() const { return registered; }
+    std::size_t declaredCount() const;
+    std::size_t registeredCount() const;
+
+    // Declarations the last registerAll() could not register
+    std::size_t failedCount() const { return failures; }
+
+    // Duration of the most recent registerAll()/unregisterAll() in milliseconds
+    double lastRegisterMs() const { return registerMs; }
+    double lastUnregisterMs() const { return unregisterMs; }
+
+private:
+    template<typename T>
+    struct Declaration
+    {
+        std::string name;
+        void *owner;
+        std::function<T(void *)> onRead;
+        std::function<void(void *, T)> onWrite;
+        XPLMDataTypeID types;
+    };
+
+    template<typename T>
+    using DeclarationList = std::vector<Declaration<T>>;
+
+    template<typename T>
+    using ExportList = std::vector<std::unique_ptr<DataRefExport<T>>>;
+
+    template<typename T>
+    DeclarationList<T> &declarations() { return std::get<DeclarationList<T>>(decls); }
+
+    template<typename T>
+    ExportList<T> &exports() { return std::get<ExportList<T>>(exported); }
+
+    template<typename T> void createExports(std::vector<const std::string *> &names);
+
+    void notifyBrowsers(const std::vector<const std::string *> &names) const;
+
+    std::tuple<DeclarationList<int>, DeclarationList<float>, DeclarationList<double>> decls;
+    std::tuple<ExportList<int>, ExportList<float>, ExportList<double>> exported;
+
+    bool registered = false;
+    std::size_t failures = 0;
+    double registerMs = 0.0;
+    double unregisterMs = 0.0;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DATAREFEXPORTREGISTRY_H
@@ -0,0 +1,145 @@
+#ifndef DATAREFINTERPOLATOR_H
+#define DATAREFINTERPOLATOR_H
+
+#include "FlightLoop.h"
+#include "ScalarDataRef.h"
+#include <XPLMDataAccess.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+class FlightDataProvider;
+
+/**
+ * DataRefInterpolator - Smooth reads of sampled datarefs at arbitrary times
+ *
+ * sample() runs on the sim thread once per frame and stores a timestamped
+ * copy of every channel in a small ring of recent samples. Any thread can
+ * then read the channels at any time: between two samples the values are
+ * interpolated linearly, after the newest sample they are extrapolated from
+ * the last two (for at most maxExtrapolation seconds). Readers never call
+ * the SDK and never block the sim thread.
+ *
+ * Storage is structure-of-arrays: sample times in one array and one
+ * contiguous row of channel values per sample, so a full read is a single
+ * a + (b - a) * f loop over two rows that the compiler vectorizes. Rows are
+ * published with a seqlock; a reader only retries if the sim thread
+ * overwrote one of the two rows it used while it was copying.
+ *
+ * Timestamps are seconds on the steady clock returned by now().
+ *
+ * Example usage:
+ *   DataRefInterpolator smooth;
+ *   smooth.addFlightData(flightData);
+ *   int pitch = smooth.addDataRef("sim/flightmodel/position/theta");
+ *   smooth.enableFlightLoop();
+ *
+ *   // Render or display thread
+ *   std::vector<double> values;
+ *   smooth.read(DataRefInterpolator::now(), values);
+ *   double theta = smooth.read(pitch, DataRefInterpolator::now());
+ */
+class DataRefInterpolator
+{
+public:
+    // capacity: number of samples kept (at least 3)
+    explicit DataRefInterpolator(std::size_t capacity = 8);
+    ~DataRefInterpolator();
+
+    // Prevent copying (readers and the flight loop hold pointers into it)
+    DataRefInterpolator(const DataRefInterpolator&) = delete;
+    DataRefInterpolator& operator=(const DataRefInterpolator&) = delete;
+
+    // Add a channel read from an int, float or double dataref. A channel with
+    // wrapMax > wrapMin is an angle that wraps (e.g. -180..180 for longitude,
+    // 0..360 for headings) and is interpolated across the seam.
+    // Returns the channel index or -1. Channels can only be added before the
+    // first sample().
+    int addDataRef(const std::string &name, double wrapMin = 0.0, double wrapMax = 0.0);
+
+    // Add a channel computed by the plugin
+    int addChannel(const std::string &name, std::function<double()> source, double wrapMin = 0.0,
+                   double wrapMax = 0.0);
+
+    // Add the standard FlightDataProvider channels
+    void addFlightData(FlightDataProvider &provider);
+
+    // Channel index by name, or -1
+    int find(const std::string &name) const;
+    std::size_t channelCount() const { return channels.size(); }
+
+    // Longest time past the newest sample that values are extrapolated for;
+    // later reads hold the extrapolated value at that limit
+    void setMaxExtrapolation(double seconds) { maxExtrapolation = seconds; }
+
+    // Read all channels and store a sample stamped now() or timestamp (sim thread)
+    void sample();
+    void sample(double timestamp);
+
+    // Run sample() from an internal flight loop every frame
+    void enableFlightLoop();
+    void disableFlightLoop();
+
+    // Values of all channels at time into out (channelCount() doubles).
+    // Returns false before the first sample. Thread-safe and lock-free.
+    bool read(double time, double *out) const;
+    bool read(double time, std::vector<double> &out) const;
+
+    // Value of one channel at time; 0 before the first sample
+    double read(int channel, double time) const;
+
+    // Time of the newest sample, or 0 before the first sample
+    double latestTime() const;
+
+    std::uint64_t sampleCount() const { return sequence.load(std::memory_order_relaxed) / 2; }
+
+    // Seconds on the clock used for sample timestamps
+    static double now();
+
+private:
+    struct Channel
+    {
+        std::string name;
+        ScalarDataRef dataRef;
+        std::function<double()> custom; // Read instead of dataRef if set
+        double wrapMin;
+        double wrapMax;
+    };
+
+    // Samples chosen for one read: values = a + (b - a) * f
+    struct Span
+    {
+        std::uint64_t first; // Oldest sample number used
+        const double *a;
+        const double *b;
+        double f;
+    };
+
+    int addChannelInternal(Channel channel);
+    bool findSpan(double time, std::uint64_t completed, Span &span) const;
+    bool stillValid(const Span &span) const;
+    double interpolate(std::size_t channel, const Span &span) const;
+
+    std::size_t capacity;
+    double maxExtrapolation = 0.1;
+    std::vector<Channel> channels;
+    std::vector<std::size_t> wrapped; // Indices of wrapping channels
+
+    // Ring of samples: times[slot] and values[slot * channels.size() + channel]
+    std::vector<double> times;
+    std::vector<double> values;
+
+    // Seqlock over the ring: odd while a sample is being written;
+    // sequence / 2 is the number of completed samples
+    std::atomic<std::uint64_t> sequence{0};
+    FlightLoop flightLoop;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DATAREFINTERPOLATOR_H
@@ -0,0 +1,148 @@
+#ifndef DATAREFWRITEBATCH_H
+#define DATAREFWRITEBATCH_H
+
+#include "FlightLoop.h"
+#include <XPLMDataAccess.h>
+#include <XPLMProcessing.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+/**
+ * DataRefWriteBatch - Defer and coalesce dataref writes until one flush per frame
+ *
+ * Systems logic often writes the same switch or annunciator dataref many
+ * times per frame from different modules, and every XPLMSetData* call runs
+ * the owning plugin's write callback. A batch records writes instead: the
+ * last value written to each dataref (or array element) wins, and flush()
+ * applies them once, in the order each dataref was first written. Array
+ * element writes are sorted and merged into contiguous XPLMSetDatavi/vf
+ * ranges.
+ *
+ * While a batch is active, DataRefAccess::set() and operator= record into
+ * it, and DataRefAccess::get() returns the pending value so modules read
+ * their own writes. The batch can flush itself from a flight loop at a
+ * chosen phase. Batches are used from the sim thread only.
+ *
+ * Entries stay allocated across flushes: a dataref written once keeps its
+ * slot (and its element buffer), so a frame that writes the same datarefs
+ * as the one before makes no heap allocation.
+ *
+ * Example usage:
+ *   DataRefWriteBatch writes;
+ *   writes.activate();
+ *   writes.enableFlightLoop(xplm_FlightLoop_Phase_BeforeFlightModel);
+ *
+ *   beaconOn = 1;                              // DataRefAccess<int>, recorded
+ *   writes.setFloatElement(annunciators, 3, 1.0f);
+ *   writes.setFloatElement(annunciators, 4, 1.0f);  // one XPLMSetDatavf(..., 3, 2)
+ */
+class DataRefWriteBatch
+{
+public:
+    struct Stats
+    {
+        std::uint64_t writes = 0;     // Values recorded
+        std::uint64_t coalesced = 0;  // Recorded values replaced before reaching the SDK
+        std::uint64_t sdkCalls = 0;   // XPLMSetData* calls made by flush()
+        std::uint64_t elements = 0;   // Array elements written by flush()
+        std::uint64_t flushes = 0;
+    };
+
+    DataRefWriteBatch() = default;
+    ~DataRefWriteBatch();
+
+    // Prevent copying (the flight loop and current() point at the batch)
+    DataRefWriteBatch(const DataRefWriteBatch&) = delete;
+    DataRefWriteBatch& operator=(const DataRefWriteBatch&) = delete;
+
+    // Route DataRefAccess writes through this batch / back to immediate
+    // writes. deactivate() flushes first.
+    void activate();
+    void deactivate();
+    bool isActive() const { return current() == this; }
+
+    // The active batch, or nullptr
+    static DataRefWriteBatch *current() { return active; }
+
+    // Scalar writes
+    void setInt(XPLMDataRef handle, int value);
+    void setFloat(XPLMDataRef handle, float value);
+    void setDouble(XPLMDataRef handle, double value);
+
+    // Array element writes, merged into ranges on flush
+    void setIntElement(XPLMDataRef handle, int index, int value);
+    void setFloatElement(XPLMDataRef handle, int index, float value);
+    void setIntArray(XPLMDataRef handle, const int *values, int offset, int count);
+    void setFloatArray(XPLMDataRef handle, const float *values, int offset, int count);
+
+    // Pending scalar value for handle, if one was recorded since the last flush
+    bool pending(XPLMDataRef handle, double &value) const;
+
+    // Apply all recorded writes
+    void flush();
+
+    // Discard recorded writes without applying them
+    void clear();
+
+    // Flush from an internal flight loop every frame at the given phase
+    void enableFlightLoop(XPLMFlightLoopPhaseType phase = xplm_FlightLoop_Phase_BeforeFlightModel);
+    void disableFlightLoop();
+
+    std::size_t pendingCount() const { return pendingWrites.size(); }
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats(); }
+
+private:
+    enum class Type
+    {
+        Int,
+        Float,
+        Double,
+        IntArray,
+        FloatArray
+    };
+
+    struct Element
+    {
+        int index;
+        std::uint32_t sequence; // Write order; the last write to an index wins
+        double value;
+    };
+
+    struct Write
+    {
+        XPLMDataRef handle;
+        Type type;
+        double value;                  // Scalars
+        std::vector<Element> elements; // Arrays; capacity kept across flushes
+        bool dirty = false;            // Recorded since the last flush
+    };
+
+    Write &entry(XPLMDataRef handle, Type type);
+    void setScalar(XPLMDataRef handle, Type type, double value);
+    void setElement(XPLMDataRef handle, Type type, int index, double value);
+    void flushArray(XPLMDataRef handle, Type type, std::vector<Element> &elements);
+
+    static DataRefWriteBatch *active;
+
+    // Every dataref written so far; a deque so entries stay in place when
+    // a write callback records a new dataref during flush()
+    std::deque<Write> writes;
+    std::unordered_map<XPLMDataRef, std::size_t> index;
+    std::vector<std::size_t> pendingWrites; // Dirty entries in order of first write
+    std::vector<std::size_t> flushing;      // pendingWrites being applied by flush()
+    std::vector<Element> elementScratch;
+    std::vector<int> intScratch;
+    std::vector<float> floatScratch;
+    Stats stats;
+    FlightLoop flightLoop;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DATAREFWRITEBATCH_H
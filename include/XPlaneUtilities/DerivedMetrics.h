@@ -0,0 +1,212 @@
+#ifndef DERIVEDMETRICS_H
+#define DERIVEDMETRICS_H
+
+#include "DataRefExport.h"
+#include "FlightLoop.h"
+#include "ScalarDataRef.h"
+#include <XPLMDataAccess.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+class FlightDataProvider;
+
+/**
+ * DerivedMetrics - Shared, incrementally updated values derived from datarefs
+ *
+ * A small computation graph. Input nodes read a dataref or a plugin
+ * callback; derived nodes are formulas over earlier nodes or streaming
+ * statistics of one node (rate of change, integral, EMA, rolling mean, min
+ * and max over a time window). A node can only use nodes added before it,
+ * so the table order is already a topological order and update() is a
+ * single pass over it.
+ *
+ * update() reads the inputs and evaluates a formula only if one of its
+ * inputs changed this pass. Statistics are stateful and run every pass,
+ * each in O(1) (amortized for rolling windows). A node passes a change on
+ * only if its value actually changed, so an unchanged input costs nothing
+ * further down the graph. Every panel then reads the same values with get().
+ *
+ * Example usage:
+ *   DerivedMetrics metrics;
+ *   metrics.addFlightData(flightData);   // fuel_flow, time_to_empty, distance_flown, ...
+ *   int fuel = metrics.find("fuel");
+ *   int pct = metrics.addFormula("fuel_percent", {fuel},
+ *                                [](const double *in) { return in[0] / 20000.0 * 100.0; });
+ *   metrics.exportNode(pct, "myplugin/fuel/percent");
+ *   metrics.enableFlightLoop();
+ *
+ *   double flow = metrics.get(metrics.find("fuel_flow"));  // kg/s
+ */
+class DerivedMetrics
+{
+public:
+    using Formula = std::function<double(const double *inputs)>;
+
+    struct Stats
+    {
+        std::uint64_t updates = 0;
+        std::uint64_t evaluations = 0; // Nodes computed
+        std::uint64_t skipped = 0;     // Formula nodes skipped because no input changed
+    };
+
+    DerivedMetrics() = default;
+    ~DerivedMetrics();
+
+    // Prevent copying (exports and the flight loop point into the graph)
+    DerivedMetrics(const DerivedMetrics&) = delete;
+    DerivedMetrics& operator=(const DerivedMetrics&) = delete;
+
+    //==========================================================================
+    // Building the graph (node ids are returned, -1 on error)
+    //==========================================================================
+
+    // Input read from an int, float or double dataref
+    int addDataRef(const std::string &name, const std::string &datarefName);
+
+    // Input computed by the plugin
+    int addInput(const std::string &name, std::function<double()> source);
+
+    // Formula over earlier nodes; inputs[] holds their values in order
+    int addFormula(const std::string &name, const std::vector<int> &inputs, Formula formula);
+
+    // Change per second of input
+    int addRate(const std::string &name, int input);
+
+    // Running integral of input over time (e.g. distance from speed)
+    int addIntegral(const std::string &name, int input);
+
+    // Exponential moving average with the given time constant in seconds
+    int addEma(const std::string &name, int input, double timeConstant);
+
+    // Mean, minimum and maximum of input over the last windowSeconds
+    int addRollingMean(const std::string &name, int input, double windowSeconds);
+    int addRollingMin(const std::string &name, int input, double windowSeconds);
+    int addRollingMax(const std::string &name, int input, double windowSeconds);
+
+    // Inputs fuel, zulu_time, groundspeed, latitude, longitude, airspeed and
+    // elevation, plus fuel_flow (kg/s, 30 s EMA), groundspeed_avg (m/s over
+    // 60 s), distance_flown (m), time_to_empty (s) and range_remaining (m).
+    // time_to_empty and range_remaining are +infinity while no fuel flows.
+    void addFlightData(FlightDataProvider &provider);
+
+    // Publish a node as a read-only float/double dataref
+    bool exportNode(int node, const std::string &datarefName);
+
+    //==========================================================================
+    // Evaluation
+    //==========================================================================
+
+    // Read inputs and recompute affected nodes; dt is seconds since the last update
+    void update(double dt);
+
+    // Run update() from an internal flight loop with dt in simulator seconds
+    // (sim/time/total_running_time_sec), so statistics follow time
+    // acceleration and frames while the sim is paused are skipped
+    void enableFlightLoop();
+    void disableFlightLoop();
+
+    // Reset statistics and integrals (e.g. on a new flight)
+    void reset();
+
+    double get(int node) const;
+    bool changed(int node) const; // Value changed in the last update()
+    int find(const std::string &name) const;
+    std::string name(int node) const;
+    std::size_t nodeCount() const { return nodes.size(); }
+    const Stats& getStats() const { return stats; }
+
+private:
+    enum class Kind
+    {
+        DataRef,
+        Input,
+        Formula,
+        Rate,
+        Integral,
+        Ema,
+        RollingMean,
+        RollingMin,
+        RollingMax
+    };
+
+    // (time, value) samples, oldest first. A ring over a vector that only
+    // grows, so a window that slides at a steady rate stops allocating.
+    class Samples
+    {
+    public:
+        bool empty() const { return count == 0; }
+        std::size_t size() const { return count; }
+        const std::pair<double, double> &front() const { return slots[head]; }
+        const std::pair<double, double> &back() const
+        {
+            return slots[(head + count - 1) % slots.size()];
+        }
+        void push_back(double time, double value);
+        void pop_front()
+        {
+            head = (head + 1) % slots.size();
+            --count;
+        }
+        void pop_back() { --count; }
+        void clear()
+        {
+            head = 0;
+            count = 0;
+        }
+
+    private:
+        std::vector<std::pair<double, double>> slots;
+        std::size_t head = 0;
+        std::size_t count = 0;
+    };
+
+    struct Node
+    {
+        std::string name;
+        Kind kind;
+        std::size_t firstInput = 0; // Into inputIds
+        std::size_t inputCount = 0;
+        ScalarDataRef dataRef;
+        std::function<double()> source;
+        Formula formula;
+        double parameter = 0.0; // Time constant or window length
+
+        // Statistic state
+        bool primed = false;
+        double previous = 0.0;
+        double sum = 0.0;
+        Samples window;    // Rolling mean inputs
+        Samples monotonic; // Candidates for min/max
+    };
+
+    int addNode(Node node, const std::vector<int> &inputs);
+    int addStatistic(const std::string &name, Kind kind, int input, double parameter);
+    double evaluate(Node &node, std::size_t index, double dt);
+    double rolling(Node &node, double value);
+    void flightLoopUpdate(float elapsed);
+
+    std::vector<Node> nodes;
+    std::vector<int> inputIds; // Inputs of all nodes, flattened
+    std::vector<double> values;
+    std::vector<char> changedFlags;
+    std::vector<double> scratch; // Formula arguments
+    double clock = 0.0;          // Sum of dt, for rolling windows
+    bool evaluateAll = true;     // First update after construction or reset()
+    Stats stats;
+
+    std::vector<std::unique_ptr<DataRefExport<double>>> exports;
+    FlightLoop flightLoop;
+    ScalarDataRef simTime;     // Wall time is used if the dataref is missing
+    double lastSimTime = -1.0; // -1 until the first flight loop call
+};
+
+} // namespace XPlaneUtilities
+
+#endif // DERIVEDMETRICS_H
@@ -0,0 +1,124 @@
+#ifndef DYNAMICMENU_H
+#define DYNAMICMENU_H
+
+#include "MenuHandler.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * DynamicMenu - Large submenu filled from a data source on demand
+ *
+ * Items come from a source callback instead of individual addSubItem calls.
+ * Above pageSize items they are split into bucket submenus, either pages of
+ * pageSize items or one bucket per initial letter. A bucket only contains a
+ * single "Show N items" entry until it is materialized, either by clicking
+ * that entry or incrementally through update() from a flight loop, so
+ * plugin start costs one XPLM item per bucket instead of one per entry.
+ *
+ * refresh() re-reads the source and diffs it against the built items: items
+ * whose key and position are unchanged are only renamed or re-checked when
+ * needed; XPLM can only append, so everything after the first changed
+ * position is removed and appended again.
+ *
+ * Example usage:
+ *   DynamicMenu airports(pluginMenu, "Airports",
+ *       [this](std::vector<DynamicMenu::Entry> &out) {
+ *           for (const auto &apt : database.airports())
+ *               out.push_back({apt.icao, apt.icao + " " + apt.name, apt.icao == selected});
+ *       },
+ *       [this](const std::string &icao) { selectAirport(icao); },
+ *       DynamicMenu::Bucketing::Alphabetical);
+ *   airports.refresh();
+ *
+ *   // In a flight loop: build at most 50 XPLM items per frame
+ *   airports.update(50);
+ */
+class DynamicMenu
+{
+public:
+    struct Entry
+    {
+        std::string key;   // Identity used for diffing and selection
+        std::string title; // Text shown in the menu
+        bool checked = false;
+    };
+
+    enum class Bucketing
+    {
+        Pages,       // Consecutive runs of pageSize entries
+        Alphabetical // One bucket per initial letter of the title, "#" for the rest
+    };
+
+    struct Stats
+    {
+        std::size_t sourceItems = 0; // Entries returned by the source
+        std::size_t builtItems = 0;  // Entries that exist as XPLM items
+        std::size_t buckets = 0;
+        std::size_t pendingBuckets = 0;
+        std::uint64_t itemsAppended = 0; // XPLM items appended since construction
+        std::uint64_t itemsUpdated = 0;  // Renames and check changes
+        std::uint64_t itemsRemoved = 0;
+        double lastRefreshMs = 0.0; // Source call plus bucket diff
+        double lastBuildMs = 0.0;   // Last bucket materialization
+    };
+
+    using Source = std::function<void(std::vector<Entry> &)>;
+    using OnSelect = std::function<void(const std::string &key)>;
+
+    DynamicMenu(MenuItem &parent, const std::string &title, Source source, OnSelect onSelect,
+                Bucketing bucketing = Bucketing::Pages, std::size_t pageSize = 40);
+    ~DynamicMenu();
+
+    // Prevent copying (menu callbacks point back into this object)
+    DynamicMenu(const DynamicMenu&) = delete;
+    DynamicMenu& operator=(const DynamicMenu&) = delete;
+
+    // Re-read the source and update buckets and already built items
+    void refresh();
+
+    // Materialize pending buckets, appending at most maxItems XPLM items.
+    // Returns true while buckets are still pending.
+    bool update(std::size_t maxItems);
+
+    // Materialize every bucket now
+    void buildAll();
+
+    Stats getStats() const { return stats; }
+
+private:
+    struct Bucket
+    {
+        std::string label;
+        std::unique_ptr<MenuItem> menu; // Null when entries go straight into root
+        std::vector<Entry> entries;     // Wanted contents from the last refresh
+        std::vector<Entry> builtEntries; // Contents of the XPLM items, in order
+        std::vector<MenuItem::Item> items;
+        MenuItem::Item placeholder;
+        bool materialized = false;
+    };
+
+    MenuItem &target(Bucket &bucket) { return bucket.menu ? *bucket.menu : *root; }
+
+    void assignBuckets(std::vector<Entry> &entries, std::vector<Bucket> &wanted) const;
+    void showPlaceholder(Bucket &bucket);
+
+    // Bring a bucket's XPLM items in line with its entries; returns items appended
+    std::size_t materialize(Bucket &bucket, std::size_t maxItems);
+    void clearItems(Bucket &bucket);
+
+    Source source;
+    OnSelect onSelect;
+    Bucketing bucketing;
+    std::size_t pageSize;
+
+    std::unique_ptr<MenuItem> root;
+    std::vector<Bucket> buckets;
+    std::vector<Entry> scratch; // Reused source buffer
+    Stats stats;
+};
+
+#endif // DYNAMICMENU_H
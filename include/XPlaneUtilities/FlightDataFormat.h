@@ -0,0 +1,84 @@
+#ifndef FLIGHTDATAFORMAT_H
+#define FLIGHTDATAFORMAT_H
+
+/*
+ *   XPlaneUtilities - Allocation-free formatting of flight data for display
+ *
+ *   This header is independent of the X-Plane SDK.
+ */
+
+#include <cstddef>
+#include <fmt/format.h>
+
+namespace XPlaneUtilities {
+
+/**
+ * FlightDataFormat - Fixed-format text for clocks, positions and altitudes
+ *
+ * Every function writes into a caller-provided buffer and returns the number
+ * of characters written, not counting the terminating '\0' that is always
+ * appended. Buffers must hold at least the matching k...Size constant. The
+ * fmt::memory_buffer overloads append instead (no terminator), so several
+ * fields can be assembled into one line.
+ *
+ * Digits come from a two-digit lookup table; nothing allocates, and nothing
+ * depends on the C locale, so the functions are cheap enough for per-frame
+ * UI text.
+ *
+ * Example usage:
+ *   char utc[FlightDataFormat::kTimeHHMMSSSize];
+ *   FlightDataFormat::formatTimeHHMMSS(utc, flightData.getZuluTimeSec());  // "14:30:05"
+ *
+ *   fmt::memory_buffer line;
+ *   FlightDataFormat::formatLatitudeDMS(line, flightData.getLatitude());    // "N47 27 53.4"
+ *   line.push_back(' ');
+ *   FlightDataFormat::formatAltitude(line, flightData.getElevation(), 18000.0);  // "FL350"
+ */
+namespace FlightDataFormat {
+
+constexpr std::size_t kTimeHHMMSize = 5;      // "1430"
+constexpr std::size_t kTimeHHMMSSSize = 9;    // "14:30:05"
+constexpr std::size_t kTimeDDHHMMZSize = 8;   // "181430Z"
+constexpr std::size_t kLatitudeDMSSize = 12;  // "N47 27 53.4"
+constexpr std::size_t kLongitudeDMSSize = 13; // "E008 32 56.0"
+constexpr std::size_t kDecimalSize = 32;      // "-122.123456789"
+constexpr std::size_t kAltitudeSize = 24;     // "-1250", "FL350"
+
+// Seconds since midnight (wrapped to 24 h, truncated to the minute/second)
+std::size_t formatTimeHHMM(char *out, float seconds);
+std::size_t formatTimeHHMMSS(char *out, float seconds);
+
+// Day of month and seconds since midnight as a DTG, e.g. "181430Z"
+std::size_t formatTimeDDHHMMZ(char *out, int day, float seconds);
+
+// Degrees, minutes and seconds to a tenth, with hemisphere letter
+std::size_t formatLatitudeDMS(char *out, double degrees);
+std::size_t formatLongitudeDMS(char *out, double degrees);
+
+// Signed decimal with a fixed number of decimals (0-9), e.g. coordinates
+std::size_t formatDecimal(char *out, double value, int decimals);
+
+// Feet rounded to an integer
+std::size_t formatAltitudeFeet(char *out, double feet);
+
+// Flight level from feet, e.g. "FL050"
+std::size_t formatFlightLevel(char *out, double feet);
+
+// Feet below transitionAltitude, flight level at or above it
+std::size_t formatAltitude(char *out, double feet, double transitionAltitude);
+
+void formatTimeHHMM(fmt::memory_buffer &out, float seconds);
+void formatTimeHHMMSS(fmt::memory_buffer &out, float seconds);
+void formatTimeDDHHMMZ(fmt::memory_buffer &out, int day, float seconds);
+void formatLatitudeDMS(fmt::memory_buffer &out, double degrees);
+void formatLongitudeDMS(fmt::memory_buffer &out, double degrees);
+void formatDecimal(fmt::memory_buffer &out, double value, int decimals);
+void formatAltitudeFeet(fmt::memory_buffer &out, double feet);
+void formatFlightLevel(fmt::memory_buffer &out, double feet);
+void formatAltitude(fmt::memory_buffer &out, double feet, double transitionAltitude);
+
+} // namespace FlightDataFormat
+
+} // namespace XPlaneUtilities
+
+#endif // FLIGHTDATAFORMAT_H
@@ -11,6 +11,8 @@
 
 #include "DataRefImport.h"
 #include "DataRefExport.h"
+#include "FlightDataFormat.h"
+#include "MemoryResources.h"
 #include <string>
 #include <memory>
 
@@ -96,6 +98,20 @@ public:
      */
     std::string getZuluTimeFormatted();
 
+    /**
+     * @brief Write current Zulu time as HHMM without allocating
+     * @param out Buffer of at least FlightDataFormat::kTimeHHMMSize chars
+     * @return Number of characters written (excluding the terminator)
+     *
+     * See FlightDataFormat.h for the other clock, position and altitude formats.
+     */
+    std::size_t getZuluTimeFormatted(char *out);
+
+    /**
+     * @brief Append current Zulu time as HHMM to a fmt buffer
+     */
+    void getZuluTimeFormatted(fmt::memory_buffer &out);
+
     /**
      * @brief Convert fuel from kg to tons
      */
@@ -112,14 +128,15 @@ public:
     static float msToKnots(float ms) { return ms * 1.94384f; }
 
 private:
-    // X-Plane dataref imports (AviTab pattern - cached handles)
-    std::unique_ptr<DataRefImport<float>> m_fuelTotal;
-    std::unique_ptr<DataRefImport<float>> m_zuluTime;
-    std::unique_ptr<DataRefImport<float>> m_groundSpeed;
-    std::unique_ptr<DataRefImport<double>> m_latitude;
-    std::unique_ptr<DataRefImport<double>> m_longitude;
-    std::unique_ptr<DataRefImport<float>> m_airspeed;
-    std::unique_ptr<DataRefImport<double>> m_elevation;
+    // X-Plane dataref imports (AviTab pattern - cached handles), allocated
+    // from MemoryComponent::FlightData
+    ResourcePtr<DataRefImport<float>> m_fuelTotal;
+    ResourcePtr<DataRefImport<float>> m_zuluTime;
+    ResourcePtr<DataRefImport<float>> m_groundSpeed;
+    ResourcePtr<DataRefImport<double>> m_latitude;
+    ResourcePtr<DataRefImport<double>> m_longitude;
+    ResourcePtr<DataRefImport<float>> m_airspeed;
+    ResourcePtr<DataRefImport<double>> m_elevation;
 };
 
 } // namespace XPlaneUtilities
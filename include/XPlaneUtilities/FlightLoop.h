@@ -0,0 +1,57 @@
+#ifndef FLIGHTLOOP_H
+#define FLIGHTLOOP_H
+
+#include <XPLMProcessing.h>
+
+namespace XPlaneUtilities {
+
+/**
+ * FlightLoop - Owns a flight loop that calls back every frame
+ *
+ * start() creates the loop in the given phase and schedules it for every
+ * frame; stop() and the destructor destroy it, so a member FlightLoop stops
+ * calling back before its owner goes away. The callback is a plain function
+ * taking the refcon and the elapsed time since the previous call.
+ *
+ * Example usage:
+ *   class Gauge {
+ *   public:
+ *       void enable() {
+ *           loop.start([](void *self, float) { static_cast<Gauge*>(self)->update(); }, this);
+ *       }
+ *   private:
+ *       void update();
+ *       FlightLoop loop;
+ *   };
+ */
+class FlightLoop
+{
+public:
+    using Callback = void (*)(void *refcon, float elapsedSinceLastCall);
+
+    FlightLoop() = default;
+    ~FlightLoop() { stop(); }
+
+    // Prevent copying (X-Plane holds a pointer to this object)
+    FlightLoop(const FlightLoop&) = delete;
+    FlightLoop& operator=(const FlightLoop&) = delete;
+
+    // Create and schedule the loop for every frame; does nothing if running
+    void start(Callback callback, void *refcon,
+               XPLMFlightLoopPhaseType phase = xplm_FlightLoop_Phase_AfterFlightModel);
+    void stop();
+
+    bool isRunning() const { return id != nullptr; }
+
+private:
+    static float dispatch(float elapsedSinceLastCall, float elapsedSinceLastLoop, int counter,
+                          void *refcon);
+
+    XPLMFlightLoopID id = nullptr;
+    Callback callback = nullptr;
+    void *refcon = nullptr;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // FLIGHTLOOP_H
@@ -0,0 +1,75 @@
+#ifndef LOGLEVELCONTROLS_H
+#define LOGLEVELCONTROLS_H
+
+#include "DataRefExport.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Third-Party Library Headers
+#include <spdlog/spdlog.h>
+
+class MenuItem;
+
+namespace XPlaneUtilities {
+
+/**
+ * LogLevelControls - Runtime level switches for XPlaneLog subsystem loggers
+ *
+ * Each added subsystem gets a writable int dataref "<prefix>/<subsystem>"
+ * holding its spdlog level (0 = trace ... 5 = critical, 6 = off) and, once
+ * buildMenu() is called, a submenu listing the levels. Both act on the
+ * logger's atomic level, so messages below it are dropped before they are
+ * formatted.
+ *
+ * Example usage:
+ *   auto datarefLog = XPlaneLog::getLogger("datarefs");
+ *   LogLevelControls logLevels("myplugin/log_level");
+ *   logLevels.add("datarefs");
+ *   logLevels.add("network");
+ *   logLevels.buildMenu(*pluginMenu);
+ *
+ *   XPLANE_LOG_TO(datarefLog, spdlog::level::trace, "Resolved {}", name);
+ *   // DataRefTool: set myplugin/log_level/datarefs to 0 to see the traces
+ */
+class LogLevelControls
+{
+public:
+    explicit LogLevelControls(const std::string &datarefPrefix);
+    ~LogLevelControls();
+
+    // Prevent copying (exports and menu callbacks point back into this object)
+    LogLevelControls(const LogLevelControls&) = delete;
+    LogLevelControls& operator=(const LogLevelControls&) = delete;
+
+    // Export the level of a subsystem logger, creating the logger if needed
+    bool add(const std::string &subsystem);
+
+    // Add every subsystem logger created so far
+    void addAll();
+
+    // Create a "Log Levels" submenu under parent with one level list per
+    // subsystem. The controls must be destroyed before parent.
+    void buildMenu(MenuItem &parent);
+
+    // Set a subsystem's level; returns false for an unknown subsystem
+    bool setLevel(const std::string &subsystem, spdlog::level::level_enum level);
+
+private:
+    struct Control
+    {
+        std::string subsystem;
+        std::shared_ptr<spdlog::logger> logger;
+        std::unique_ptr<DataRefExport<int>> dataRef;
+    };
+
+    static void applyLevel(Control &control, int level);
+
+    std::string prefix;
+    std::vector<std::unique_ptr<Control>> controls;
+    std::vector<std::unique_ptr<MenuItem>> menus;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // LOGLEVELCONTROLS_H
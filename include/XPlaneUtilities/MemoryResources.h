@@ -0,0 +1,195 @@
+#ifndef MEMORYRESOURCES_H
+#define MEMORYRESOURCES_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace XPlaneUtilities {
+
+// Library components that take their memory from a pluggable resource
+enum class MemoryComponent
+{
+    DataRefs,   // DataRefAccess names
+    Menus,      // MenuItem entries, titles and free lists
+    Logging,    // XPlaneLog thread rings, black box and collector buffers
+    FlightData, // FlightDataProvider imports
+    Count
+};
+
+/**
+ * CountingResource - Pass-through memory_resource that counts what goes through it
+ *
+ * Forwards to an upstream resource and keeps atomic totals, so it can sit in
+ * front of resources used from logging and worker threads.
+ *
+ * Example usage:
+ *   CountingResource counter;
+ *   std::pmr::vector<int> values(&counter);
+ *   values.resize(100);
+ *   counter.getStats().allocations;   // 1
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    struct Stats
+    {
+        std::uint64_t allocations = 0;
+        std::uint64_t deallocations = 0;
+        std::uint64_t bytesAllocated = 0; // Total requested since the last reset
+        std::uint64_t bytesInUse = 0;
+        std::uint64_t peakBytesInUse = 0;
+    };
+
+    explicit CountingResource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+    std::pmr::memory_resource *upstream() const { return upstreamResource; }
+
+    Stats getStats() const;
+
+    // Clear the totals; bytesInUse is kept and becomes the new peak
+    void resetStats();
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    std::pmr::memory_resource *upstreamResource;
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> bytesAllocated{0};
+    std::atomic<std::uint64_t> bytesInUse{0};
+    std::atomic<std::uint64_t> peakBytesInUse{0};
+};
+
+/**
+ * SetupArena - Thread-safe monotonic arena for objects that live until unload
+ *
+ * Allocation is a pointer bump under a mutex; deallocation does nothing and
+ * the memory is returned all at once by release() or the destructor. Meant
+ * for menus, dataref handles and similar objects created in XPluginStart or
+ * XPluginEnable and kept for the whole session. Components that keep
+ * allocating while running (logging) would grow it without bound.
+ *
+ * Example usage:
+ *   static SetupArena arena(64 * 1024);
+ *   MemoryResources::set(MemoryComponent::Menus, &arena);
+ *   MemoryResources::set(MemoryComponent::DataRefs, &arena);
+ */
+class SetupArena : public std::pmr::memory_resource
+{
+public:
+    explicit SetupArena(std::size_t initialSize = 64 * 1024,
+                        std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+
+    SetupArena(const SetupArena&) = delete;
+    SetupArena& operator=(const SetupArena&) = delete;
+
+    // Bytes handed out since construction or the last release()
+    std::size_t bytesAllocated() const;
+
+    // Free everything; only when no object allocated from the arena is alive
+    void release();
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    mutable std::mutex mutex;
+    std::pmr::monotonic_buffer_resource arena;
+    std::size_t allocated = 0;
+};
+
+/**
+ * MemoryResources - Per-component allocator hook for the library
+ *
+ * Every component listed in MemoryComponent takes its heap memory from the
+ * resource returned by get(). By default that is std::pmr::get_default_resource()
+ * (the global heap). A resource must outlive every object that allocated
+ * from it, so set resources before creating menus, accessors or loggers and
+ * keep them alive until the plugin is unloaded. std::function targets and
+ * spdlog internals are not allocator-aware and stay on the global heap.
+ *
+ * enableAccounting() puts a CountingResource in front of each component's
+ * resource, which makes it possible to check that per-frame code does not
+ * allocate.
+ *
+ * Example usage:
+ *   // XPluginStart
+ *   static SetupArena arena;
+ *   MemoryResources::set(MemoryComponent::Menus, &arena);
+ *   MemoryResources::enableAccounting();
+ *   ...
+ *   MemoryResources::logStats();
+ */
+class MemoryResources
+{
+public:
+    // Resource used by a component
+    static std::pmr::memory_resource *get(MemoryComponent component);
+
+    // Replace a component's resource; nullptr restores the default
+    static void set(MemoryComponent component, std::pmr::memory_resource *resource);
+    static void setAll(std::pmr::memory_resource *resource);
+
+    static const char *name(MemoryComponent component);
+
+    // Count allocations per component. set() while accounting is enabled
+    // counts the new resource from zero.
+    static void enableAccounting();
+    static void disableAccounting();
+    static bool isAccounting();
+
+    static CountingResource::Stats getStats(MemoryComponent component);
+    static void resetStats();
+
+    // Write the per-component totals to the log
+    static void logStats();
+};
+
+// Deleter for objects placed in a memory_resource by makeResourcePtr()
+template<typename T>
+struct ResourceDeleter
+{
+    std::pmr::memory_resource *resource = nullptr;
+
+    void operator()(T *object) const
+    {
+        object->~T();
+        resource->deallocate(object, sizeof(T), alignof(T));
+    }
+};
+
+template<typename T>
+using ResourcePtr = std::unique_ptr<T, ResourceDeleter<T>>;
+
+// std::make_unique counterpart that allocates from a component's resource
+template<typename T, typename... Args>
+ResourcePtr<T> makeResourcePtr(MemoryComponent component, Args &&...args)
+{
+    std::pmr::memory_resource *resource = MemoryResources::get(component);
+    void *memory = resource->allocate(sizeof(T), alignof(T));
+    try
+    {
+        T *object = new (memory) T(std::forward<Args>(args)...);
+        return ResourcePtr<T>(object, ResourceDeleter<T>{resource});
+    }
+    catch (...)
+    {
+        resource->deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+} // namespace XPlaneUtilities
+
+#endif // MEMORYRESOURCES_H
@@ -1,30 +1,106 @@
 #ifndef MENUHANDLER_H
 #define MENUHANDLER_H
 
+#include "MemoryResources.h"
 #include <string>
 #include <map>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
-// Forward declaration of XPLMMenuID
+// Forward declarations of XPLMMenuID and XPLMCommandRef
 typedef void *XPLMMenuID;
+typedef void *XPLMCommandRef;
 
 class MenuItem
 {
 public:
-    // Constructor and Destructor
+    // Handle to one entry of this menu. It stays valid when other entries are
+    // added or removed; it must not outlive the MenuItem that created it.
+    class Item
+    {
+    public:
+        Item() = default;
+
+        bool isValid() const;
+
+        // Show a check mark (true) or an empty check box (false)
+        void setChecked(bool checked);
+        bool isChecked() const;
+
+        void setEnabled(bool enabled);
+        void setTitle(const std::string &title);
+        void setTitle(const char *title); // No temporary string for formatted titles
+
+        // Remove the entry from the menu; the handle becomes invalid
+        void remove();
+
+    private:
+        friend class MenuItem;
+        Item(MenuItem *menu, int id, unsigned generation)
+            : m_menu(menu), m_id(id), m_generation(generation)
+        {
+        }
+
+        MenuItem *m_menu = nullptr;
+        int m_id = -1;
+        unsigned m_generation = 0; // Entry ids are reused after remove()
+    };
+
+    // Constructor and Destructor. Destroying a menu also removes its
+    // submenus from X-Plane; a submenu destroyed later is then an empty
+    // object whose handles are invalid.
     MenuItem(const std::string &title);
     ~MenuItem();
 
-    // Member functions
-    void addSubItem(const std::string &title, std::function<void()> action);
+    // Prevent copying (X-Plane holds a pointer to this object)
+    MenuItem(const MenuItem&) = delete;
+    MenuItem& operator=(const MenuItem&) = delete;
+
+    // Member functions. The action may add or remove items, including its own,
+    // and may destroy this menu; its captures are gone after that.
+    Item addSubItem(const std::string &title, std::function<void()> action);
+
+    // Item that runs an X-Plane command when chosen (see CommandHandler)
+    Item addCommandItem(const std::string &title, XPLMCommandRef command);
     std::unique_ptr<MenuItem> addSubMenu(const std::string &title);
     void addSeparator();
 
 private:
+    // An appended XPLM item: action entry, separator or submenu. Allocator
+    // aware, so titles share the menu's memory resource.
+    struct Entry
+    {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        Entry() = default;
+        explicit Entry(const allocator_type &alloc) : title(alloc) {}
+
+        std::function<void()> action; // Targets stay on the global heap
+        std::pmr::string title;
+        int position = -1; // Current XPLM item index, -1 once removed
+        bool checked = false;
+        bool checkable = false;
+        bool enabled = true;
+        unsigned generation = 0;
+        MenuItem *submenu = nullptr; // Submenu attached to this item, if any
+    };
+
     // Private constructor for submenu creation
-    MenuItem(const std::string &title, XPLMMenuID parent_menu, int item_idx);
+    MenuItem(const std::string &title, MenuItem &parent);
+
+    // Append an XPLM item and return its entry id
+    int appendEntry(const std::string &title, std::function<void()> action,
+                    XPLMCommandRef command = nullptr);
+    void removeEntry(int id);
+
+    // Destroy the XPLM menus of this menu and its submenus and forget the
+    // parent; called on submenus when their parent goes first
+    void detach();
+    Entry *findEntry(int id);
+    Entry *findEntry(const Item &item);
 
     // Static menu handler callback (AviTab pattern)
     static void menuHandler(void *menuRef, void *itemRef);
@@ -33,7 +109,17 @@ private:
     XPLMMenuID m_parent_menu = nullptr;
     XPLMMenuID m_menu_id = nullptr;
     int m_item_id = -1;
-    std::vector<std::function<void()>> m_callbacks;
+    MenuItem *m_parent = nullptr; // Owner of m_item_id when this is a submenu
+    int m_entry_id = -1;          // Entry id of this submenu in m_parent
+
+    // Entry ids are indices; a deque keeps a running action in place while
+    // its callback appends further items. Both come from MemoryComponent::Menus.
+    std::pmr::deque<Entry> m_entries;
+    std::pmr::vector<int> m_free_ids; // Removed entries, reused by appendEntry
+    int m_item_count = 0;     // Live XPLM items in m_menu_id
+    int m_dispatching = -1;   // Entry whose action is running
+    bool m_release_pending = false;
+    bool *m_dispatch_alive = nullptr; // Cleared if the running action destroys us
 };
 
-#endif // MENUHANDLER_H
\ No newline at end of file
+#endif // MENUHANDLER_H
@@ -0,0 +1,115 @@
+#ifndef MENUTREE_H
+#define MENUTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations of XPLMMenuID and XPLMCommandRef
+typedef void *XPLMMenuID;
+typedef void *XPLMCommandRef;
+
+/**
+ * MenuSpec - Declarative description of a menu tree for MenuTree
+ *
+ * Plain data, no SDK calls: build the whole tree with the helpers below and
+ * hand it to MenuTree::build().
+ */
+struct MenuSpec
+{
+    enum class Kind
+    {
+        Item,
+        Command,
+        Submenu,
+        Separator
+    };
+
+    Kind kind = Kind::Item;
+    std::string title;
+    std::string id; // Optional name for MenuTree::find()
+    std::function<void()> action;
+    XPLMCommandRef command = nullptr; // Command items only
+    std::vector<MenuSpec> children;
+    bool checked = false; // Items only: start with a check mark
+    bool enabled = true;
+
+    static MenuSpec item(std::string title, std::function<void()> action, std::string id = {});
+    static MenuSpec commandItem(std::string title, XPLMCommandRef command, std::string id = {});
+    static MenuSpec submenu(std::string title, std::vector<MenuSpec> children, std::string id = {});
+    static MenuSpec separator();
+};
+
+/**
+ * MenuTree - Create a whole menu tree in one pass and tear it down in one call
+ *
+ * build() counts the nodes, reserves one arena for all of them and then
+ * appends every item and creates every submenu in a single walk over the
+ * spec. Actions are moved into the arena; clicks dispatch by node index with
+ * no lookup or copy. clear() (or the destructor) destroys every submenu and
+ * removes the root item, so no per-submenu objects need to be kept alive.
+ *
+ * Example usage:
+ *   MenuTree menu;
+ *   menu.build(MenuSpec::submenu("My Plugin", {
+ *       MenuSpec::item("Show window", [this]() { window.show(); }),
+ *       MenuSpec::separator(),
+ *       MenuSpec::submenu("Units", {
+ *           MenuSpec::item("Metric", [this]() { setMetric(true); }, "metric"),
+ *           MenuSpec::item("Imperial", [this]() { setMetric(false); }, "imperial"),
+ *       }),
+ *   }));
+ *   menu.setChecked(menu.find("metric"), true);
+ *   ...
+ *   menu.clear();  // XPluginStop
+ */
+class MenuTree
+{
+public:
+    MenuTree() = default;
+    ~MenuTree();
+
+    // Prevent copying (X-Plane holds a pointer to this object)
+    MenuTree(const MenuTree&) = delete;
+    MenuTree& operator=(const MenuTree&) = delete;
+
+    // Create the tree under parent (the plugins menu when null). The root
+    // spec must be a submenu. Replaces a previously built tree; throws
+    // std::runtime_error if X-Plane refuses an item or menu.
+    void build(MenuSpec root, XPLMMenuID parent = nullptr);
+
+    // Destroy every menu created by build(). Not from inside a menu action:
+    // the running action lives in the arena.
+    void clear();
+
+    // Node index of the spec with this id, or -1
+    int find(const std::string &id) const;
+
+    void setChecked(int node, bool checked);
+    void setEnabled(int node, bool enabled);
+    void setTitle(int node, const std::string &title);
+
+    std::size_t nodeCount() const { return nodes.size(); }
+    bool isBuilt() const { return !nodes.empty(); }
+
+private:
+    struct Node
+    {
+        std::function<void()> action;
+        XPLMMenuID container = nullptr; // Menu holding this node's item
+        XPLMMenuID menu = nullptr;      // Submenus only
+        int position = -1;              // Item index inside container
+    };
+
+    static std::size_t countNodes(const MenuSpec &spec);
+    void createNode(MenuSpec &spec, XPLMMenuID container);
+
+    static void menuHandler(void *menuRef, void *itemRef);
+
+    std::vector<Node> nodes; // Arena, preorder; nodes[0] is the root
+    std::unordered_map<std::string, int> ids;
+};
+
+#endif // MENUTREE_H
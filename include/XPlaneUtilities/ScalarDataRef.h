@@ -0,0 +1,47 @@
+#ifndef SCALARDATAREF_H
+#define SCALARDATAREF_H
+
+#include <XPLMDataAccess.h>
+#include <string>
+
+namespace XPlaneUtilities {
+
+/**
+ * ScalarDataRef - An int, float or double dataref read as double
+ *
+ * find() looks the dataref up and picks its widest native scalar type
+ * (double, then float, then int), so read() loses no precision. Used by
+ * the classes that sample arbitrary datarefs into channels.
+ *
+ * Example usage:
+ *   ScalarDataRef heading;
+ *   if (heading.find("sim/flightmodel/position/psi", "channel skipped")) {
+ *       double value = heading.read();
+ *   }
+ */
+struct ScalarDataRef
+{
+    XPLMDataRef handle = nullptr;
+    XPLMDataTypeID type = xplmType_Unknown;
+
+    // Look up name; on failure logs "DataRef '<name>' not available, <skipped>"
+    // (or "is not a scalar") and returns false
+    bool find(const std::string &name, const std::string &skipped);
+
+    double read() const
+    {
+        switch (type)
+        {
+        case xplmType_Double:
+            return XPLMGetDatad(handle);
+        case xplmType_Float:
+            return XPLMGetDataf(handle);
+        default:
+            return XPLMGetDatai(handle);
+        }
+    }
+};
+
+} // namespace XPlaneUtilities
+
+#endif // SCALARDATAREF_H
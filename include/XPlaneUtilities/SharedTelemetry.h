@@ -0,0 +1,121 @@
+#ifndef SHAREDTELEMETRY_H
+#define SHAREDTELEMETRY_H
+
+/*
+ *   XPlaneUtilities - Shared-memory telemetry layout and reader
+ *
+ *   This header is independent of the X-Plane SDK so that external processes
+ *   can map the segment written by SharedTelemetryPublisher.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+/**
+ * Layout of the shared-memory segment
+ *
+ *   SharedTelemetryHeader
+ *   char   names[channelCount][kSharedTelemetryNameLength]
+ *   double values[channelCount]
+ *
+ * The header and names are written once when the publisher opens the segment.
+ * Values are guarded by a seqlock: the writer makes sequence odd, updates the
+ * values and makes it even again; readers retry until they see the same even
+ * sequence before and after copying.
+ */
+constexpr std::uint32_t kSharedTelemetryMagic = 0x54555058; // "XPUT"
+constexpr std::uint32_t kSharedTelemetryVersion = 1;
+constexpr std::size_t kSharedTelemetryNameLength = 64;
+
+struct SharedTelemetryHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t channelCount;
+    std::uint32_t nameLength;
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t frame;     // Publisher frame counter, protected by sequence
+    double publishTime;      // Sim elapsed time of the snapshot, protected by sequence
+};
+
+inline std::size_t sharedTelemetryNamesOffset()
+{
+    return sizeof(SharedTelemetryHeader);
+}
+
+inline std::size_t sharedTelemetryValuesOffset(std::uint32_t channelCount)
+{
+    std::size_t offset = sharedTelemetryNamesOffset() + channelCount * kSharedTelemetryNameLength;
+    return (offset + alignof(double) - 1) & ~(alignof(double) - 1);
+}
+
+inline std::size_t sharedTelemetrySize(std::uint32_t channelCount)
+{
+    return sharedTelemetryValuesOffset(channelCount) + channelCount * sizeof(double);
+}
+
+/**
+ * @brief A consistent copy of all channels
+ */
+struct SharedTelemetrySnapshot
+{
+    std::uint64_t frame = 0;
+    double publishTime = 0.0;
+    std::vector<double> values;
+};
+
+/**
+ * SharedTelemetryReader - Read-only consumer of a SharedTelemetryPublisher segment
+ *
+ * Example usage:
+ *   SharedTelemetryReader reader;
+ *   if (reader.open("/myplugin_telemetry")) {
+ *       SharedTelemetrySnapshot snap;
+ *       if (reader.read(snap)) {
+ *           double lat = snap.values[reader.find("sim/flightmodel/position/latitude")];
+ *       }
+ *   }
+ */
+class SharedTelemetryReader
+{
+public:
+    SharedTelemetryReader() = default;
+    ~SharedTelemetryReader();
+
+    SharedTelemetryReader(const SharedTelemetryReader&) = delete;
+    SharedTelemetryReader& operator=(const SharedTelemetryReader&) = delete;
+
+    // Map the named segment read-only; fails on missing segment or layout mismatch
+    bool open(const std::string &name);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    std::uint32_t channelCount() const;
+    std::string channelName(std::uint32_t index) const;
+
+    // Channel index by name, or -1 if not present
+    int find(const std::string &name) const;
+
+    // Copy a consistent snapshot; returns false if the writer kept the lock
+    // for more than maxRetries attempts
+    bool read(SharedTelemetrySnapshot &out, int maxRetries = 1000) const;
+
+    // Last published sequence number (even when stable)
+    std::uint64_t sequence() const;
+
+private:
+    const SharedTelemetryHeader *header = nullptr;
+    const char *names = nullptr;
+    const double *values = nullptr;
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // SHAREDTELEMETRY_H
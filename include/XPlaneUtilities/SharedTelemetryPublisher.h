@@ -0,0 +1,106 @@
+#ifndef SHAREDTELEMETRYPUBLISHER_H
+#define SHAREDTELEMETRYPUBLISHER_H
+
+#include "FlightLoop.h"
+#include "ScalarDataRef.h"
+#include "SharedTelemetry.h"
+#include <XPLMDataAccess.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+class FlightDataProvider;
+
+/**
+ * SharedTelemetryPublisher - Publish dataref snapshots into POSIX shared memory
+ *
+ * Channels (datarefs or custom sources) are configured first, then open()
+ * creates the segment described in SharedTelemetry.h. publish() samples all
+ * channels and writes them under a seqlock, so external processes using
+ * SharedTelemetryReader get consistent, zero-copy snapshots without sockets.
+ *
+ * publish() can be called from the plugin's own flight loop, or the publisher
+ * can run its own per-frame flight loop via enableFlightLoop().
+ *
+ * open() always creates a new segment: one left under the same name by an
+ * earlier run is unlinked first, never resized, so readers still mapping it
+ * are not disturbed. close() unlinks the name only while it still refers to
+ * the segment this publisher created.
+ *
+ * Example usage:
+ *   SharedTelemetryPublisher telemetry("/myplugin_telemetry");
+ *   telemetry.addFlightData(flightData);
+ *   telemetry.addDataRef("sim/cockpit2/gauges/indicators/heading_AHARS_deg_mag_pilot");
+ *   if (telemetry.open()) {
+ *       telemetry.enableFlightLoop();
+ *   }
+ */
+class SharedTelemetryPublisher
+{
+public:
+    explicit SharedTelemetryPublisher(const std::string &shmName);
+    ~SharedTelemetryPublisher();
+
+    // Prevent copying (owns the mapping and flight loop)
+    SharedTelemetryPublisher(const SharedTelemetryPublisher&) = delete;
+    SharedTelemetryPublisher& operator=(const SharedTelemetryPublisher&) = delete;
+
+    // Add a channel read from an int, float or double dataref; false if not found.
+    // Channels can only be added before open().
+    bool addDataRef(const std::string &name);
+
+    // Add a channel computed by the plugin
+    bool addChannel(const std::string &name, std::function<double()> source);
+
+    // Add the standard FlightDataProvider channels (fuel, time, speed, position)
+    void addFlightData(FlightDataProvider &provider);
+
+    // Create and map a new segment; the channel set is fixed afterwards
+    bool open();
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Sample all channels and publish them under the seqlock
+    void publish();
+
+    // Run publish() from an internal flight loop every frame
+    void enableFlightLoop();
+    void disableFlightLoop();
+
+    std::size_t channelCount() const { return channels.size(); }
+    std::uint64_t frameCount() const { return frame; }
+
+private:
+    struct Channel
+    {
+        std::string name;
+        ScalarDataRef dataRef;
+        std::function<double()> custom; // Read instead of dataRef if set
+    };
+
+    bool canAddChannel(const std::string &name) const;
+
+    // True while shmName still names the segment created by open()
+    bool ownsName() const;
+
+    std::string shmName;
+    std::vector<Channel> channels;
+    std::vector<double> scratch;
+
+    SharedTelemetryHeader *header = nullptr;
+    double *values = nullptr;
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+    std::uint64_t segmentDevice = 0;
+    std::uint64_t segmentInode = 0;
+    std::uint64_t frame = 0;
+    FlightLoop flightLoop;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // SHAREDTELEMETRYPUBLISHER_H
@@ -0,0 +1,173 @@
+#ifndef TELEMETRYSTREAM_H
+#define TELEMETRYSTREAM_H
+
+/*
+ *   XPlaneUtilities - Compact binary telemetry frame encoding
+ *
+ *   This header is independent of the X-Plane SDK so that dashboards and
+ *   other receivers can decode frames sent by TelemetryStreamer.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+/**
+ * Frame layout (all integers are LEB128 varints unless noted)
+ *
+ *   u8 'X', u8 'T', u8 version, u8 type
+ *   sequence, timestampMs, entryCount
+ *   entries...
+ *
+ * Value frames (Delta, Keyframe): entries are sorted by channel id and encode
+ *   idDelta (id minus previous id in the frame), zigzag(value)
+ * where value is the channel quantised by its resolution, absolute in
+ * keyframes and relative to the previously sent value in delta frames.
+ *
+ * Description frames: entries encode
+ *   id, f64 resolution (little endian), nameLength, name bytes
+ *
+ * After a sequence gap a receiver ignores deltas for a channel until that
+ * channel appears in a keyframe again. Frames up to kReorderWindow older
+ * than the last one received (reordered or duplicated datagrams) are
+ * dropped; a sequence further back means the sender restarted.
+ *
+ * Channel ids are below kMaxChannels; a receiver drops frames that name a
+ * larger id or an unknown frame type.
+ */
+namespace TelemetryStream {
+
+constexpr std::uint8_t kMagic0 = 'X';
+constexpr std::uint8_t kMagic1 = 'T';
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kDefaultMtu = 1400;
+constexpr std::uint32_t kMaxChannels = 65536;
+constexpr std::uint32_t kReorderWindow = 1024;
+
+enum class FrameType : std::uint8_t
+{
+    Delta = 0,
+    Keyframe = 1,
+    Description = 2
+};
+
+inline std::uint64_t zigzagEncode(std::int64_t v)
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+inline std::int64_t zigzagDecode(std::uint64_t v)
+{
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+// Append v as a varint; returns the number of bytes written
+std::size_t writeVarint(std::vector<std::uint8_t> &out, std::uint64_t v);
+
+// Read a varint and advance p; false on truncated or overlong input
+bool readVarint(const std::uint8_t *&p, const std::uint8_t *end, std::uint64_t &v);
+
+} // namespace TelemetryStream
+
+/**
+ * @brief A quantised channel value to encode
+ */
+struct TelemetrySample
+{
+    std::uint32_t channel;
+    std::int64_t value;
+};
+
+/**
+ * @brief A decoded channel update
+ */
+struct TelemetryUpdate
+{
+    std::uint32_t channel;
+    double value;
+};
+
+/**
+ * TelemetryFrameEncoder - Packs channel changes into MTU-sized frames
+ *
+ * Keeps the last value sent per channel so delta frames only carry the
+ * difference. Not thread-safe; owned by the sending thread.
+ */
+class TelemetryFrameEncoder
+{
+public:
+    TelemetryFrameEncoder(std::size_t channelCount, std::size_t mtu = TelemetryStream::kDefaultMtu);
+
+    // Encode changed channels (sorted by channel id) as delta frames
+    void encodeDelta(const std::vector<TelemetrySample> &changes, std::uint64_t timestampMs,
+                     std::vector<std::vector<std::uint8_t>> &frames);
+
+    // Encode every channel's last value as absolute keyframes
+    void encodeKeyframe(std::uint64_t timestampMs, std::vector<std::vector<std::uint8_t>> &frames);
+
+    // Encode channel names and resolutions
+    void encodeDescription(const std::vector<std::string> &names,
+                           const std::vector<double> &resolutions, std::uint64_t timestampMs,
+                           std::vector<std::vector<std::uint8_t>> &frames);
+
+    std::uint32_t nextSequence() const { return sequence; }
+
+private:
+    void beginFrame(TelemetryStream::FrameType type);
+    void flushFrame(std::uint64_t timestampMs, std::vector<std::vector<std::uint8_t>> &frames);
+
+    std::size_t mtu;
+    std::uint32_t sequence = 0;
+    std::vector<std::int64_t> lastSent;
+
+    TelemetryStream::FrameType frameType = TelemetryStream::FrameType::Delta;
+    std::vector<std::uint8_t> body;
+    std::uint32_t bodyEntries = 0;
+    std::uint32_t lastChannel = 0;
+};
+
+/**
+ * TelemetryFrameDecoder - Decodes frames produced by TelemetryFrameEncoder
+ *
+ * Example usage:
+ *   TelemetryFrameDecoder decoder;
+ *   std::vector<TelemetryUpdate> updates;
+ *   if (decoder.decode(packet, length, updates)) {
+ *       for (const auto &u : updates) display(decoder.channelName(u.channel), u.value);
+ *   }
+ */
+class TelemetryFrameDecoder
+{
+public:
+    // Decode one frame; false if malformed or of an unknown type, or if it
+    // names a channel id of kMaxChannels or more. Updates are appended; a
+    // stale frame (see kReorderWindow) is checked but appends none.
+    bool decode(const std::uint8_t *data, std::size_t length, std::vector<TelemetryUpdate> &updates);
+
+    std::string channelName(std::uint32_t channel) const;
+    std::size_t channelCount() const { return names.size(); }
+    std::uint64_t lostFrames() const { return lost; }
+    std::uint64_t staleFrames() const { return stale; }
+    std::uint64_t lastTimestampMs() const { return timestampMs; }
+
+private:
+    void ensureChannel(std::uint32_t channel);
+
+    bool haveSequence = false;
+    std::uint32_t expectedSequence = 0;
+    std::uint64_t lost = 0;
+    std::uint64_t stale = 0;
+    std::uint64_t timestampMs = 0;
+
+    std::vector<std::int64_t> values;
+    std::vector<bool> synced;
+    std::vector<double> resolutions;
+    std::vector<std::string> names;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // TELEMETRYSTREAM_H
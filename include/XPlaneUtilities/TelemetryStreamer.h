@@ -0,0 +1,136 @@
+#ifndef TELEMETRYSTREAMER_H
+#define TELEMETRYSTREAMER_H
+
+#include "FlightLoop.h"
+#include "ScalarDataRef.h"
+#include "TelemetryStream.h"
+#include <XPLMDataAccess.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace XPlaneUtilities {
+
+class FlightDataProvider;
+
+/**
+ * TelemetryStreamer - Stream changed dataref values over UDP in compact binary frames
+ *
+ * sample() runs on the sim thread: it reads the channels that are due
+ * according to their configured rate and queues those whose quantised value
+ * changed. A background thread encodes the queue into MTU-sized frames (see
+ * TelemetryStream.h), adds periodic keyframes and channel descriptions, and
+ * sends all frames of a batch with one sendmmsg() call where available.
+ *
+ * Example usage:
+ *   TelemetryStreamer stream("127.0.0.1", 49100);
+ *   stream.addFlightData(flightData, 10.0);                      // 10 Hz
+ *   stream.addDataRef("sim/flightmodel/position/psi", 0.0, 0.01); // every frame
+ *   if (stream.start()) {
+ *       stream.enableFlightLoop();
+ *   }
+ */
+class TelemetryStreamer
+{
+public:
+    struct Stats
+    {
+        std::uint64_t samplesQueued = 0;
+        std::uint64_t framesSent = 0;
+        std::uint64_t bytesSent = 0;
+        std::uint64_t sendCalls = 0;
+        std::uint64_t sendErrors = 0;
+    };
+
+    TelemetryStreamer(const std::string &host, std::uint16_t port,
+                      std::size_t mtu = TelemetryStream::kDefaultMtu);
+    ~TelemetryStreamer();
+
+    // Prevent copying (owns a socket and a thread)
+    TelemetryStreamer(const TelemetryStreamer&) = delete;
+    TelemetryStreamer& operator=(const TelemetryStreamer&) = delete;
+
+    // Add a channel from an int, float or double dataref. rateHz of 0 samples
+    // every call; resolution is the quantisation step. A NaN sample is
+    // skipped and infinite or huge ones are clamped to +-2^53 steps. Returns
+    // the channel id or -1. Channels can only be added before start().
+    int addDataRef(const std::string &name, double rateHz = 0.0, double resolution = 0.001);
+
+    // Add a channel computed by the plugin
+    int addChannel(const std::string &name, std::function<double()> source, double rateHz = 0.0,
+                   double resolution = 0.001);
+
+    // Add the standard FlightDataProvider channels with suitable resolutions
+    void addFlightData(FlightDataProvider &provider, double rateHz = 0.0);
+
+    // Seconds between keyframes (absolute values for every channel)
+    void setKeyframeInterval(double seconds) { keyframeInterval = seconds; }
+
+    // Resolve the destination, open the socket and start the sender thread
+    bool start();
+    void stop();
+    bool isRunning() const { return running.load(); }
+
+    // Sample due channels and queue changes (sim thread)
+    void sample();
+
+    // Run sample() from an internal flight loop every frame
+    void enableFlightLoop();
+    void disableFlightLoop();
+
+    std::size_t channelCount() const { return channels.size(); }
+    Stats getStats() const;
+
+private:
+    struct Channel
+    {
+        std::string name;
+        ScalarDataRef dataRef;
+        std::function<double()> custom; // Read instead of dataRef if set
+        double interval;
+        double resolution;
+        double nextDue;
+        std::int64_t lastQueued;
+        bool queued;
+    };
+
+    int addChannelInternal(Channel channel);
+    double readChannel(const Channel &channel) const;
+    void senderLoop();
+    void sendFrames(const std::vector<std::vector<std::uint8_t>> &frames);
+
+    std::string host;
+    std::uint16_t port;
+    std::size_t mtu;
+    double keyframeInterval = 1.0;
+
+    std::vector<Channel> channels;
+    std::vector<TelemetrySample> staged; // Sim thread scratch buffer
+
+    // Hand-off between sim thread and sender thread
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::vector<TelemetrySample> pending;
+    std::uint64_t pendingTimestampMs = 0;
+
+    std::thread sender;
+    std::atomic<bool> running{false};
+    int socketFd = -1;
+    FlightLoop flightLoop;
+
+    std::atomic<std::uint64_t> samplesQueued{0};
+    std::atomic<std::uint64_t> framesSent{0};
+    std::atomic<std::uint64_t> bytesSent{0};
+    std::atomic<std::uint64_t> sendCalls{0};
+    std::atomic<std::uint64_t> sendErrors{0};
+};
+
+} // namespace XPlaneUtilities
+
+#endif // TELEMETRYSTREAMER_H
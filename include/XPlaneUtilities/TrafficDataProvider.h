@@ -0,0 +1,148 @@
+#ifndef TRAFFICDATAPROVIDER_H
+#define TRAFFICDATAPROVIDER_H
+
+#include "FlightLoop.h"
+#include <XPLMDataAccess.h>
+#include <cstddef>
+
+namespace XPlaneUtilities {
+
+/**
+ * TrafficDataProvider - AI and multiplayer aircraft relative to the ownship
+ *
+ * update() reads up to 63 other aircraft from the TCAS target datarefs
+ * (sim/cockpit2/tcas/targets/..., X-Plane 11.50 and later) with one bulk
+ * array read per field, about a dozen SDK calls per frame in total, instead
+ * of a DataRefImport per field per plane. Slot 0 of those arrays is the
+ * user's aircraft and becomes the ownship state; the others are stored as
+ * targets 0..count-1.
+ *
+ * The snapshot is structure-of-arrays: one contiguous float array per
+ * field, so range, bearing, relative altitude and closure rate for all
+ * targets are computed by straight-line loops without calls or branches
+ * that the compiler vectorizes. Bearings use a polynomial atan2 with a
+ * maximum error of 0.00012 degrees (2e-6 rad).
+ *
+ * Units are SI: metres, metres per second and degrees true. Positions are
+ * X-Plane local OpenGL coordinates (x east, y up, z south). Call update()
+ * and read the snapshot on the sim thread; no memory is allocated after
+ * construction.
+ *
+ * Example usage:
+ *   TrafficDataProvider traffic;
+ *   traffic.enableFlightLoop();
+ *
+ *   const TrafficDataProvider::Snapshot &s = traffic.getSnapshot();
+ *   int nearby[TrafficDataProvider::kMaxTargets];
+ *   std::size_t n = traffic.select(10.0f * 1852.0f, 2700.0f * 0.3048f, nearby);
+ *   for (std::size_t k = 0; k < n; ++k) {
+ *       int i = nearby[k];
+ *       drawTarget(s.relativeBearing[i], s.range[i], s.relativeAltitude[i],
+ *                  s.closure[i] > 0.0f);
+ *   }
+ */
+class TrafficDataProvider
+{
+public:
+    static constexpr int kMaxTargets = 63;
+
+    // Slots per array: the TCAS arrays hold the ownship plus kMaxTargets
+    static constexpr int kSlots = kMaxTargets + 1;
+
+    struct Ownship
+    {
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        float vx = 0.0f, vy = 0.0f, vz = 0.0f;
+        float latitude = 0.0f;
+        float longitude = 0.0f;
+        float altitude = 0.0f; // MSL
+        float heading = 0.0f;  // True
+    };
+
+    // Entry i of every array is the same target; only the first count are valid
+    struct Snapshot
+    {
+        int count = 0;
+        float time = 0.0f; // XPLMGetElapsedTime() of the update
+        Ownship ownship;
+
+        // Read from the simulator
+        alignas(64) int modeS[kSlots] = {};
+        alignas(64) float x[kSlots] = {};
+        alignas(64) float y[kSlots] = {};
+        alignas(64) float z[kSlots] = {};
+        alignas(64) float vx[kSlots] = {};
+        alignas(64) float vy[kSlots] = {};
+        alignas(64) float vz[kSlots] = {};
+        alignas(64) float latitude[kSlots] = {};
+        alignas(64) float longitude[kSlots] = {};
+        alignas(64) float altitude[kSlots] = {}; // MSL
+        alignas(64) float heading[kSlots] = {};  // True
+
+        // Computed against the ownship
+        alignas(64) float groundSpeed[kSlots] = {};
+        alignas(64) float range[kSlots] = {};            // Horizontal
+        alignas(64) float slantRange[kSlots] = {};
+        alignas(64) float bearing[kSlots] = {};          // True, 0..360
+        alignas(64) float relativeBearing[kSlots] = {};  // From the nose, -180..180
+        alignas(64) float relativeAltitude[kSlots] = {}; // Positive above the ownship
+        alignas(64) float closure[kSlots] = {};          // Positive when closing
+    };
+
+    TrafficDataProvider();
+    ~TrafficDataProvider();
+
+    // Prevent copying (the flight loop holds a pointer to this object)
+    TrafficDataProvider(const TrafficDataProvider&) = delete;
+    TrafficDataProvider& operator=(const TrafficDataProvider&) = delete;
+
+    // False if the simulator has no TCAS target datarefs
+    bool isValid() const { return valid; }
+
+    // Read all aircraft and recompute the relative values (sim thread)
+    void update();
+
+    // Run update() from an internal flight loop every frame
+    void enableFlightLoop();
+    void disableFlightLoop();
+
+    const Snapshot& getSnapshot() const { return snapshot; }
+    int count() const { return snapshot.count; }
+
+    // Targets within range metres and altitudeBand metres above or below the
+    // ownship, nearest first; writes up to kMaxTargets indices to out
+    std::size_t select(float maxRange, float altitudeBand, int *out) const;
+
+    // Index of the nearest target by slant range, or -1
+    int nearest() const;
+
+private:
+    enum Field
+    {
+        X,
+        Y,
+        Z,
+        VX,
+        VY,
+        VZ,
+        Latitude,
+        Longitude,
+        Altitude,
+        Heading,
+        FieldCount
+    };
+
+    void computeRelative();
+
+    bool valid = false;
+    XPLMDataRef countRef = nullptr;
+    XPLMDataRef modeSRef = nullptr;
+    XPLMDataRef fieldRefs[FieldCount] = {};
+
+    Snapshot snapshot;
+    FlightLoop flightLoop;
+};
+
+} // namespace XPlaneUtilities
+
+#endif // TRAFFICDATAPROVIDER_H
@@ -0,0 +1,221 @@
+#ifndef XPLANEBINARYLOG_H
+#define XPLANEBINARYLOG_H
+
+// Standard Library Headers
+#include <atomic>      // For std::atomic
+#include <cstdint>     // For fixed-width integers
+#include <cstring>     // For std::memcpy
+#include <string>      // For std::string
+#include <type_traits> // For std::decay_t and friends
+#include <vector>      // For std::vector
+
+// Third-Party Library Headers
+#include <spdlog/common.h> // For spdlog::level::level_enum
+
+/**
+ * XPlaneBinaryLog - Compact binary log records decoded after the flight
+ *
+ * High-volume diagnostics are written as binary records instead of text:
+ * a format-string id registered once per call site, a timestamp and the raw
+ * argument bytes. Records go into a per-thread buffer that is appended to
+ * the .binlog file when full or on flush(); no formatting happens on the
+ * calling thread. The xpu-binlog-decode tool renders the file as text.
+ *
+ * Supported argument types: integers, bool, char, float/double,
+ * const char* and std::string.
+ *
+ * The binary log shares the text log's lifetime when XPlaneLog is
+ * initialised with InitOptions::binaryLog; XPlaneLog::shutdown() flushes and
+ * closes it in any case, so records are not lost if only the text log is
+ * shut down. init()/open() and shutdown() can still be called directly.
+ *
+ * Example usage:
+ *   XPlaneLog::InitOptions options;
+ *   options.binaryLog = true;           // writes MyPlugin.binlog next to MyPlugin.log
+ *   XPlaneLog::init("MyPlugin", options);
+ *   XPLANE_BINLOG(spdlog::level::debug, "fuel flow {:.2f} kg/s at {}", flow, phase);
+ *   XPlaneLog::shutdown();              // also flushes and closes the binary log
+ *
+ *   $ xpu-binlog-decode MyPlugin.binlog
+ */
+class XPlaneBinaryLog
+{
+public:
+    // File layout, shared with the decoder
+    static constexpr std::uint32_t kMagic = 0x4c425058; // "XPBL"
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr char kFormatRecord = 'F';
+    static constexpr char kDataRecord = 'D';
+
+    // Argument type codes stored with each format definition
+    static constexpr char kSigned = 'i';
+    static constexpr char kUnsigned = 'u';
+    static constexpr char kDouble = 'd';
+    static constexpr char kBool = 'b';
+    static constexpr char kChar = 'c';
+    static constexpr char kString = 's';
+
+    // Open <plugin_name>.binlog in the same directory as the text log
+    static void init(const std::string &plugin_name);
+
+    // Open an explicit path (truncates)
+    static bool open(const std::string &path);
+
+    // Flush all thread buffers and close the file
+    static void shutdown();
+
+    // Append every thread's buffered records to the file
+    static void flush();
+
+    static void setLevel(spdlog::level::level_enum level) { minLevel.store(level); }
+    static bool shouldLog(spdlog::level::level_enum level)
+    {
+        return level >= minLevel.load(std::memory_order_relaxed) && fileOpen.load();
+    }
+
+    // Register a format string for a call site; returns its id
+    static std::uint32_t registerFormat(spdlog::level::level_enum level, const char *format,
+                                        const char *file, int line, const char *argTypes);
+
+    template<typename... Args>
+    static const char *argTypes(const Args &...)
+    {
+        static constexpr char codes[] = {typeCode<std::decay_t<Args>>()..., '\0'};
+        return codes;
+    }
+
+    // Append one record to the calling thread's buffer
+    template<typename... Args>
+    static void write(std::uint32_t formatId, const Args &...args)
+    {
+        const std::size_t size = kRecordHeaderSize + (std::size_t(0) + ... + encodedSize(args));
+        char *p = reserve(size);
+        const std::uint64_t timestamp = nowNs();
+        std::memcpy(p, &formatId, sizeof(formatId));
+        std::memcpy(p + sizeof(formatId), &timestamp, sizeof(timestamp));
+        p += kRecordHeaderSize;
+        (encode(p, args), ...);
+        commit();
+    }
+
+private:
+    static constexpr std::size_t kRecordHeaderSize = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+    template<typename T>
+    static constexpr char typeCode()
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return kBool;
+        else if constexpr (std::is_same_v<T, char>)
+            return kChar;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            return kSigned;
+        else if constexpr (std::is_integral_v<T>)
+            return kUnsigned;
+        else if constexpr (std::is_enum_v<T>)
+            return kSigned;
+        else if constexpr (std::is_floating_point_v<T>)
+            return kDouble;
+        else if constexpr (std::is_same_v<T, const char *> || std::is_same_v<T, char *> ||
+                           std::is_same_v<T, std::string>)
+            return kString;
+        else
+            static_assert(sizeof(T) == 0, "Unsupported XPlaneBinaryLog argument type");
+    }
+
+    template<typename T>
+    static std::size_t encodedSize(const T &value)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>)
+            return 1;
+        else if constexpr (std::is_integral_v<U> || std::is_enum_v<U> ||
+                           std::is_floating_point_v<U>)
+            return 8;
+        else if constexpr (std::is_same_v<U, std::string>)
+            return sizeof(std::uint32_t) + value.size();
+        else
+        {
+            const char *str = value; // string literals arrive as char arrays
+            return sizeof(std::uint32_t) + (str ? std::strlen(str) : 0);
+        }
+    }
+
+    template<typename T>
+    static void encode(char *&p, const T &value)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool> || std::is_same_v<U, char>)
+        {
+            *p++ = static_cast<char>(value);
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            const double v = value;
+            std::memcpy(p, &v, 8);
+            p += 8;
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        {
+            const std::int64_t v = value;
+            std::memcpy(p, &v, 8);
+            p += 8;
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            const std::uint64_t v = value;
+            std::memcpy(p, &v, 8);
+            p += 8;
+        }
+        else if constexpr (std::is_enum_v<U>)
+        {
+            const auto v = static_cast<std::int64_t>(value);
+            std::memcpy(p, &v, 8);
+            p += 8;
+        }
+        else
+        {
+            const char *data;
+            std::uint32_t length;
+            if constexpr (std::is_same_v<U, std::string>)
+            {
+                data = value.data();
+                length = static_cast<std::uint32_t>(value.size());
+            }
+            else
+            {
+                const char *str = value;
+                data = str ? str : "";
+                length = static_cast<std::uint32_t>(std::strlen(data));
+            }
+            std::memcpy(p, &length, sizeof(length));
+            std::memcpy(p + sizeof(length), data, length);
+            p += sizeof(length) + length;
+        }
+    }
+
+    static std::uint64_t nowNs();
+
+    // Lock the calling thread's buffer and return space for size bytes
+    static char *reserve(std::size_t size);
+
+    // Unlock the calling thread's buffer
+    static void commit();
+
+    static std::atomic<int> minLevel;
+    static std::atomic<bool> fileOpen;
+};
+
+// Log a binary record; the format string is registered once per call site
+#define XPLANE_BINLOG(level, fmt, ...)                                                           \
+    do                                                                                           \
+    {                                                                                            \
+        if (XPlaneBinaryLog::shouldLog(level))                                                   \
+        {                                                                                        \
+            static const std::uint32_t xplane_binlog_id = XPlaneBinaryLog::registerFormat(      \
+                level, fmt, __FILE__, __LINE__, XPlaneBinaryLog::argTypes(__VA_ARGS__));         \
+            XPlaneBinaryLog::write(xplane_binlog_id, ##__VA_ARGS__);                             \
+        }                                                                                        \
+    } while (0)
+
+#endif // XPLANEBINARYLOG_H
@@ -2,24 +2,96 @@
 #define XPLANELOG_H
 
 // Standard Library Headers
-#include <string> // For std::string
-#include <memory> // For std::shared_ptr
-#include <mutex>  // For std::mutex
+#include <array>              // For std::array
+#include <atomic>             // For std::atomic
+#include <chrono>             // For std::chrono::milliseconds
+#include <condition_variable> // For std::condition_variable
+#include <cstdint>            // For std::uint64_t
+#include <string>             // For std::string
+#include <memory>             // For std::shared_ptr
+#include <memory_resource>    // For std::pmr::memory_resource
+#include <mutex>              // For std::mutex
+#include <thread>             // For std::thread
+#include <unordered_map>      // For std::unordered_map
+#include <vector>             // For std::vector
 
 // Third-Party Library Headers
-#include <spdlog/spdlog.h>          // For spdlog logging functions
-#include <spdlog/sinks/base_sink.h> // For spdlog::sinks::base_sink
-#include <spdlog/details/log_msg.h> // For spdlog::details::log_msg
+#include <spdlog/spdlog.h>                // For spdlog logging functions
+#include <spdlog/pattern_formatter.h>     // For spdlog::pattern_formatter
+#include <spdlog/sinks/base_sink.h>       // For spdlog::sinks::base_sink
+#include <spdlog/sinks/dist_sink.h>       // For spdlog::sinks::dist_sink
+#include <spdlog/sinks/ringbuffer_sink.h> // For spdlog::sinks::ringbuffer_sink_mt
+#include <spdlog/details/log_msg.h>       // For spdlog::details::log_msg
 
 class XPlaneLog
 {
 public:
+    struct InitOptions
+    {
+        // Start with only the X-Plane Log.txt sink and open the console and
+        // file sinks on the first flight-loop tick, which keeps the plugin
+        // path lookup and the file open out of XPluginStart. Up to
+        // deferredRecords messages logged before then are kept in memory and
+        // written to those sinks when they open.
+        bool deferSinks = false;
+        std::size_t deferredRecords = 1024;
+
+        // Also open <plugin>.binlog for XPLANE_BINLOG records (see
+        // XPlaneBinaryLog). shutdown() flushes and closes the binary log
+        // whether or not it was opened here.
+        bool binaryLog = false;
+    };
+
     // Initialize the logger
     static void init(const std::string &plugin_name);
+    static void init(const std::string &plugin_name, const InitOptions &options);
+
+    // Open the sinks held back by InitOptions::deferSinks now rather than on
+    // the first flight-loop tick. Does nothing if none are pending.
+    static void openDeferredSinks();
 
     // Shutdown the logger and clean up resources
     static void shutdown();
 
+    // Path of a log file named after the plugin, next to the plugin folder
+    // (e.g. extension ".log" for the text log)
+    static std::string logFilePath(const std::string &plugin_name, const std::string &extension);
+
+    // Named child logger for a subsystem, e.g. getLogger("datarefs") logs as
+    // "<plugin>.datarefs". It shares the plugin's sinks but has its own
+    // level, checked with one atomic load before anything is formatted.
+    // Loggers created before init() are attached to the sinks by init().
+    static std::shared_ptr<spdlog::logger> getLogger(const std::string &subsystem);
+
+    // Subsystems created so far, in creation order
+    static std::vector<std::string> getSubsystems();
+
+    // Level written to the sinks for a logger from init() or getLogger().
+    // Use these rather than spdlog::logger::set_level so the black box keeps
+    // capturing below the output level.
+    static void setLevel(spdlog::logger &target, spdlog::level::level_enum level);
+    static spdlog::level::level_enum getLevel(const spdlog::logger &target);
+
+    // Black box: keep the last records below the output level (e.g. debug and
+    // trace in a release build) in a preallocated in-memory ring without
+    // writing them anywhere. The ring is appended to the log file on a
+    // critical message, on shutdown(), from the crash handlers or on request.
+    // Capturing costs one formatting pass and a copy into the ring per record.
+    // XPLANE_LOG_TRACE/DEBUG feed it in release builds too, unless the plugin
+    // defines XPLANE_LOG_STRIP_DEBUG.
+    static void enableBlackBox(std::size_t records = 512,
+                               spdlog::level::level_enum captureLevel = spdlog::level::trace);
+    static void disableBlackBox();
+
+    // Append black box records not dumped yet to the log file. Safe to call
+    // from a signal handler.
+    static void dumpBlackBox(const char *reason = "requested");
+
+    // Dump the black box from std::terminate and fatal signals, then hand
+    // over to the previously installed handlers. Removed by shutdown().
+    static void installCrashHandlers();
+    static void removeCrashHandlers();
+
     // Log a trace message
     static void trace(const std::string &message);
 
@@ -38,6 +110,57 @@ public:
     // Log a critical message
     static void critical(const std::string &message);
 
+    // Protection against log storms, applied once before all sinks
+    struct ThrottleOptions
+    {
+        // Identical messages from the same call site within this window are
+        // collapsed into one "repeated N times" summary (zero disables)
+        std::chrono::milliseconds dedupWindow{std::chrono::seconds(5)};
+
+        // Token bucket per spdlog level; a rate of zero means unlimited
+        std::array<double, spdlog::level::n_levels> ratePerSecond{};
+        std::array<double, spdlog::level::n_levels> burst{};
+    };
+
+    struct ThrottleStats
+    {
+        std::uint64_t duplicatesSuppressed = 0;
+        std::uint64_t rateLimited = 0;
+    };
+
+    // Replace the throttling options (takes effect for the next message)
+    static void setThrottleOptions(const ThrottleOptions &options);
+
+    // Counters since init()
+    static ThrottleStats getThrottleStats();
+
+    // Per-thread buffered mode: every thread writes into its own lock-free
+    // single-producer ring and a collector thread merges the rings by
+    // timestamp into the sinks, so a logging thread never waits on a sink
+    // mutex. Records that do not fit into a full ring are dropped and counted.
+    struct ThreadBufferOptions
+    {
+        std::size_t ringBytes = 256 * 1024;              // Per thread, rounded up to a power of two
+        std::chrono::milliseconds collectInterval{10}; // Collector wake-up period
+    };
+
+    struct ThreadBufferStats
+    {
+        std::uint64_t records = 0;
+        std::uint64_t dropped = 0;
+        std::size_t threads = 0;
+    };
+
+    // Switch the logger to per-thread buffers. Call on the sim thread while
+    // no other thread is logging, e.g. right after init().
+    static void enableThreadBuffers();
+    static void enableThreadBuffers(const ThreadBufferOptions &options);
+
+    // Write out everything still buffered and log directly again
+    static void disableThreadBuffers();
+
+    static ThreadBufferStats getThreadBufferStats();
+
 private:
     // Custom sink for X-Plane
     class Sink : public spdlog::sinks::base_sink<std::mutex>
@@ -47,40 +170,255 @@ private:
         void flush_() override;
     };
 
+    // Deduplicating, rate-limiting fan-out to the real sinks
+    class ThrottleSink : public spdlog::sinks::dist_sink<std::mutex>
+    {
+    public:
+        ThrottleSink();
+
+        void setOptions(const ThrottleOptions &options);
+        ThrottleStats getStats();
+
+        // Emit every pending "repeated"/"rate limited" summary
+        void drain();
+
+        // Replace buffer with sinks after writing its records to them; no
+        // record logged meanwhile is lost or duplicated
+        void replaceSink(const std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> &buffer,
+                         const std::vector<spdlog::sink_ptr> &sinks);
+
+    protected:
+        void sink_it_(const spdlog::details::log_msg &msg) override;
+
+    private:
+        struct Repeat
+        {
+            spdlog::log_clock::time_point windowStart;
+            spdlog::level::level_enum level;
+            std::uint64_t suppressed;
+            std::pmr::string text;
+        };
+
+        struct Bucket
+        {
+            double tokens = 0.0;
+            spdlog::log_clock::time_point lastRefill{};
+            std::uint64_t dropped = 0;
+        };
+
+        static std::uint64_t messageKey(const spdlog::details::log_msg &msg);
+        void emitSummary(const spdlog::details::log_msg &context, spdlog::level::level_enum level,
+                         const std::string &text);
+        void sweep(const spdlog::details::log_msg &context, bool all);
+
+        ThrottleOptions options;
+        ThrottleStats stats;
+
+        // Nodes and texts of swept entries are reused, so tracking new
+        // messages stops allocating once the table has reached its size
+        std::pmr::unsynchronized_pool_resource repeatPool; // MemoryComponent::Logging
+        std::pmr::unordered_map<std::uint64_t, Repeat> repeats;
+        std::array<Bucket, spdlog::level::n_levels> buckets{};
+        spdlog::log_clock::time_point lastSweep{};
+    };
+
+    // Front sink of the per-thread buffered mode; log() only touches the
+    // calling thread's ring
+    class ThreadRingSink : public spdlog::sinks::sink
+    {
+    public:
+        struct Ring;
+        struct RingHolder;
+
+        ThreadRingSink(std::shared_ptr<spdlog::sinks::sink> downstream,
+                       const ThreadBufferOptions &options);
+        ~ThreadRingSink() override;
+
+        void log(const spdlog::details::log_msg &msg) override;
+        void flush() override {} // The collector flushes after each batch
+        void set_pattern(const std::string &pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+        // Create the calling thread's ring now rather than on its first message
+        void registerThread();
+
+        // Stop the collector after writing out all buffered records
+        void stop();
+
+        ThreadBufferStats getStats();
+
+    private:
+        // Allocator aware, so the strings share the pending list's resource
+        struct Pending
+        {
+            using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+            explicit Pending(const allocator_type &alloc) : loggerName(alloc), payload(alloc) {}
+            Pending(Pending &&other) = default;
+            Pending(Pending &&other, const allocator_type &alloc)
+                : time(other.time), level(other.level), source(other.source),
+                  threadId(other.threadId), loggerName(std::move(other.loggerName), alloc),
+                  payload(std::move(other.payload), alloc)
+            {
+            }
+            Pending &operator=(Pending &&other) = default;
+
+            spdlog::log_clock::time_point time;
+            spdlog::level::level_enum level;
+            spdlog::source_loc source;
+            std::size_t threadId;
+            std::pmr::string loggerName;
+            std::pmr::string payload;
+        };
+
+        Ring &threadRing();
+        void collectorLoop();
+        void collect(bool all);
+
+        std::shared_ptr<spdlog::sinks::sink> downstream;
+        ThreadBufferOptions options;
+        const std::uint64_t generation;
+
+        std::mutex ringsMutex; // Taken when a thread registers and by the collector
+        std::vector<std::shared_ptr<Ring>> rings;
+
+        std::pmr::vector<Pending> pending; // Collector thread only
+        std::uint64_t records = 0;
+        std::uint64_t retiredDropped = 0;
+
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::atomic<bool> running{true};
+        std::thread collector;
+    };
+
+    // First sink of every logger: passes records at or above the output level
+    // on and hands the rest to the black box
+    class LevelGate : public spdlog::sinks::sink
+    {
+    public:
+        LevelGate(spdlog::sink_ptr downstream, spdlog::level::level_enum outputLevel);
+
+        void log(const spdlog::details::log_msg &msg) override;
+        void flush() override;
+        void set_pattern(const std::string &pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+        // Safe while other threads log; one already in log() finishes with
+        // the previous sink, which stays alive until it returns
+        void setDownstream(spdlog::sink_ptr sink);
+
+        std::atomic<int> outputLevel;
+
+    private:
+        spdlog::sink_ptr downstream; // Only through std::atomic_load and std::atomic_store
+    };
+
+    // Fixed-size ring of recent records; record() and dump() are lock-free
+    class BlackBox
+    {
+    public:
+        BlackBox(std::size_t records, const std::string &path);
+        ~BlackBox();
+
+        void record(const spdlog::details::log_msg &msg);
+
+        // Write records not dumped yet to the file (async-signal-safe)
+        void dump(const char *reason);
+
+    private:
+        struct Slot;
+
+        std::pmr::memory_resource *resource; // MemoryComponent::Logging
+        Slot *slots = nullptr;
+        std::size_t capacity;
+        std::atomic<std::uint64_t> next{0};
+        std::atomic<std::uint64_t> dumped{0};
+        std::atomic_flag dumping = ATOMIC_FLAG_INIT;
+        long utcOffset = 0; // Seconds, so dump() needs no localtime()
+        int fd = -1;
+    };
+
     // Custom formatter for X-Plane
     class Formatter : public spdlog::formatter
     {
     public:
+        Formatter();
         void format(const spdlog::details::log_msg &msg, spdlog::memory_buf_t &dest) override;
         std::unique_ptr<spdlog::formatter> clone() const override
         {
-            return std::make_unique<Formatter>(*this);
+            return std::make_unique<Formatter>();
         }
 
         virtual ~Formatter() {} // Required for abstract class
+
+    private:
+        // Compiled once per level with the level name in upper case; building
+        // a pattern_formatter allocates for every flag of the pattern
+        std::array<std::unique_ptr<spdlog::pattern_formatter>, spdlog::level::n_levels> patterns;
     };
 
+    // Sink behind the level gates in the current mode
+    static spdlog::sink_ptr activeSink();
+
+    // Console and file sinks; sets logFile
+    static std::vector<spdlog::sink_ptr> createSinks(const std::string &plugin_name);
+    static float deferredSinksCallback(float elapsedSinceLastCall, float elapsedSinceLastLoop,
+                                       int counter, void *refcon);
+
+    static LevelGate *gateOf(const spdlog::logger &target);
+    static std::shared_ptr<spdlog::logger> createLogger(const std::string &name);
+
+    // Every logger created by init() and getLogger(); caller holds subsystemsMutex
+    static std::vector<std::shared_ptr<spdlog::logger>> allLoggersLocked();
+
     static std::shared_ptr<spdlog::logger> logger;
+    static std::shared_ptr<ThrottleSink> throttle;
+    static std::shared_ptr<ThreadRingSink> threadRings;
+
+    struct Subsystem
+    {
+        std::string name;
+        std::shared_ptr<spdlog::logger> logger;
+    };
+
+    static std::mutex subsystemsMutex;
+    static std::vector<Subsystem> subsystems;
+
+    static std::string logFile;
+    static std::string pluginName;
+    static std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> deferredSink; // Until opened
+    static void *deferredLoop;
+    static std::unique_ptr<BlackBox> blackBox;
+    static std::atomic<BlackBox *> activeBlackBox;
+    static std::atomic<int> blackBoxLevel;
 };
 
-// Compile-time logging macros that eliminate strings from production binaries
-// These macros completely remove debug/trace logging code in NDEBUG builds
-// preventing sensitive information from appearing in the binary
+// Compile-time logging macros. The call site is recorded so the throttle can
+// tell log statements apart. TRACE and DEBUG stay compiled in release builds
+// so the black box can capture them; below the logger level they cost one
+// level check and no formatting. Define XPLANE_LOG_STRIP_DEBUG before
+// including this header to remove them and their strings from the binary.
+
+#define XPLANE_LOG_CALL(level, fmt, ...) \
+    SPDLOG_LOGGER_CALL(spdlog::default_logger_raw(), level, fmt, ##__VA_ARGS__)
+
+// Subsystem logging through a logger from XPlaneLog::getLogger(). These are
+// kept in release builds so trace can be switched on for one subsystem at
+// runtime; a disabled level costs one atomic load and no formatting.
+#define XPLANE_LOG_TO(logger, level, fmt, ...) \
+    SPDLOG_LOGGER_CALL((logger), level, fmt, ##__VA_ARGS__)
 
-#ifdef NDEBUG
-    // Production build: strip out TRACE and DEBUG completely
+#ifdef XPLANE_LOG_STRIP_DEBUG
+    // Opted out: strip out TRACE and DEBUG completely
     #define XPLANE_LOG_TRACE(fmt, ...) ((void)0)
     #define XPLANE_LOG_DEBUG(fmt, ...) ((void)0)
-    #define XPLANE_LOG_INFO(fmt, ...)  spdlog::info(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_WARN(fmt, ...)  spdlog::warn(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_ERROR(fmt, ...) spdlog::error(fmt, ##__VA_ARGS__)
 #else
-    // Debug build: include all logging levels
-    #define XPLANE_LOG_TRACE(fmt, ...) spdlog::trace(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_DEBUG(fmt, ...) spdlog::debug(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_INFO(fmt, ...)  spdlog::info(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_WARN(fmt, ...)  spdlog::warn(fmt, ##__VA_ARGS__)
-    #define XPLANE_LOG_ERROR(fmt, ...) spdlog::error(fmt, ##__VA_ARGS__)
+    #define XPLANE_LOG_TRACE(fmt, ...) XPLANE_LOG_CALL(spdlog::level::trace, fmt, ##__VA_ARGS__)
+    #define XPLANE_LOG_DEBUG(fmt, ...) XPLANE_LOG_CALL(spdlog::level::debug, fmt, ##__VA_ARGS__)
 #endif
+#define XPLANE_LOG_INFO(fmt, ...)  XPLANE_LOG_CALL(spdlog::level::info, fmt, ##__VA_ARGS__)
+#define XPLANE_LOG_WARN(fmt, ...)  XPLANE_LOG_CALL(spdlog::level::warn, fmt, ##__VA_ARGS__)
+#define XPLANE_LOG_ERROR(fmt, ...) XPLANE_LOG_CALL(spdlog::level::err, fmt, ##__VA_ARGS__)
 
 #endif // XPLANELOG_H
\ No newline at end of file
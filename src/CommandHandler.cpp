@@ -0,0 +1,179 @@
+#include <XPlaneUtilities/CommandHandler.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <chrono>
+#include <fmt/format.h>
+
+CommandHandler::~CommandHandler()
+{
+    clear();
+}
+
+int CommandHandler::add(const char* name, const char* description, Callback callback,
+                        void* context, bool before)
+{
+    const int existing = indexOf(name);
+    if (existing >= 0 && entries[existing].callback)
+    {
+        XPlaneLog::warn(std::string("Command already handled: ") + name);
+        return -1;
+    }
+
+    // XPLMCreateCommand returns the existing command if another plugin made it
+    XPLMCommandRef command = XPLMCreateCommand(name, description ? description : name);
+    if (!command)
+    {
+        XPlaneLog::error(std::string("Couldn't create command: ") + name);
+        return -1;
+    }
+
+    const int index = existing >= 0 ? existing : static_cast<int>(entries.size());
+    if (existing < 0)
+    {
+        entries.emplace_back();
+        byName.emplace(name, index);
+    }
+
+    Entry& entry = entries[index];
+    entry.command = command;
+    entry.callback = callback;
+    entry.context = context;
+    entry.before = before;
+    entry.name = name;
+
+    if (callback)
+    {
+        XPLMRegisterCommandHandler(command, dispatch, before ? 1 : 0, &entry);
+    }
+    return index;
+}
+
+int CommandHandler::add(const Definition& definition)
+{
+    return add(definition.name, definition.description, definition.callback, definition.context,
+               definition.before);
+}
+
+std::size_t CommandHandler::add(const std::vector<Definition>& definitions)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::size_t added = 0;
+    byName.reserve(byName.size() + definitions.size());
+    for (const Definition& definition : definitions)
+    {
+        if (add(definition) >= 0)
+        {
+            ++added;
+        }
+    }
+
+    const double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    XPlaneLog::info(fmt::format("Registered {} of {} commands in {:.2f} ms", added,
+                                definitions.size(), ms));
+    return added;
+}
+
+int CommandHandler::find(const char* name)
+{
+    const int existing = indexOf(name);
+    if (existing >= 0)
+    {
+        return existing;
+    }
+
+    XPLMCommandRef command = XPLMFindCommand(name);
+    if (!command)
+    {
+        return -1;
+    }
+
+    const int index = static_cast<int>(entries.size());
+    entries.emplace_back();
+    entries.back().command = command;
+    entries.back().name = name;
+    byName.emplace(name, index);
+    return index;
+}
+
+int CommandHandler::indexOf(const std::string& name) const
+{
+    auto it = byName.find(name);
+    return it != byName.end() ? it->second : -1;
+}
+
+XPLMCommandRef CommandHandler::getCommand(int index) const
+{
+    return index >= 0 && index < static_cast<int>(entries.size()) ? entries[index].command
+                                                                   : nullptr;
+}
+
+const CommandHandler::Stats& CommandHandler::getStats(int index) const
+{
+    static const Stats none;
+    return index >= 0 && index < static_cast<int>(entries.size()) ? entries[index].stats : none;
+}
+
+void CommandHandler::once(int index) const
+{
+    if (XPLMCommandRef command = getCommand(index))
+    {
+        XPLMCommandOnce(command);
+    }
+}
+
+void CommandHandler::begin(int index) const
+{
+    if (XPLMCommandRef command = getCommand(index))
+    {
+        XPLMCommandBegin(command);
+    }
+}
+
+void CommandHandler::end(int index) const
+{
+    if (XPLMCommandRef command = getCommand(index))
+    {
+        XPLMCommandEnd(command);
+    }
+}
+
+void CommandHandler::clear()
+{
+    for (Entry& entry : entries)
+    {
+        if (entry.callback)
+        {
+            XPLMUnregisterCommandHandler(entry.command, dispatch, entry.before ? 1 : 0, &entry);
+        }
+    }
+    entries.clear();
+    byName.clear();
+}
+
+int CommandHandler::dispatch(XPLMCommandRef, XPLMCommandPhase phase, void* refcon)
+{
+    Entry& entry = *static_cast<Entry*>(refcon);
+
+    switch (phase)
+    {
+    case xplm_CommandBegin:
+        ++entry.stats.begins;
+        break;
+    case xplm_CommandContinue:
+        ++entry.stats.continues;
+        break;
+    default:
+        ++entry.stats.ends;
+        break;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const int result = entry.callback(phase, entry.context);
+    entry.stats.handlerNs += static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             start)
+            .count());
+    return result;
+}
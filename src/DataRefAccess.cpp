@@ -1,4 +1,7 @@
 #include <XPlaneUtilities/DataRefAccess.h>
+#include <XPlaneUtilities/DataRefWriteBatch.h>
+#include <XPlaneUtilities/MemoryResources.h>
+#include <XPlaneUtilities/StartupProfiler.h>
 #include <XPlaneUtilities/XPlaneLog.h>
 
 namespace XPlaneUtilities
@@ -36,41 +39,49 @@ bool supportsType<double>(XPLMDataTypeID supportedTypes)
     return (supportedTypes & xplmType_Double) != 0;
 }
 
+// Value recorded by the active DataRefWriteBatch but not yet flushed
+bool readPending(XPLMDataRef handle, double& value)
+{
+    const DataRefWriteBatch* batch = DataRefWriteBatch::current();
+    return batch && batch->pending(handle, value);
+}
+
 template <typename T>
-void logTypeMismatch(const std::string& dataRefName)
+void logTypeMismatch(const char* dataRefName)
 {
     (void)dataRefName;
 }
 
 template <>
-void logTypeMismatch<int>(const std::string& dataRefName)
+void logTypeMismatch<int>(const char* dataRefName)
 {
-    XPlaneLog::warn("DataRef '" + dataRefName + "' does not expose int access");
+    XPlaneLog::warn(std::string("DataRef '") + dataRefName + "' does not expose int access");
 }
 
 template <>
-void logTypeMismatch<bool>(const std::string& dataRefName)
+void logTypeMismatch<bool>(const char* dataRefName)
 {
-    XPlaneLog::warn("DataRef '" + dataRefName + "' does not expose bool/int access");
+    XPlaneLog::warn(std::string("DataRef '") + dataRefName + "' does not expose bool/int access");
 }
 
 template <>
-void logTypeMismatch<float>(const std::string& dataRefName)
+void logTypeMismatch<float>(const char* dataRefName)
 {
-    XPlaneLog::warn("DataRef '" + dataRefName + "' does not expose float access");
+    XPlaneLog::warn(std::string("DataRef '") + dataRefName + "' does not expose float access");
 }
 
 template <>
-void logTypeMismatch<double>(const std::string& dataRefName)
+void logTypeMismatch<double>(const char* dataRefName)
 {
-    XPlaneLog::warn("DataRef '" + dataRefName + "' does not expose double access");
+    XPlaneLog::warn(std::string("DataRef '") + dataRefName + "' does not expose double access");
 }
 } // namespace
 
 template <typename T>
 DataRefAccess<T>::DataRefAccess(const std::string& name)
-    : dataRefName(name)
+    : dataRefName(name, MemoryResources::get(MemoryComponent::DataRefs))
 {
+    StartupProfiler::Scope profile("DataRefs", name);
     handle = XPLMFindDataRef(name.c_str());
     if (!handle)
     {
@@ -83,14 +94,16 @@ DataRefAccess<T>::DataRefAccess(const std::string& name)
 
     if (!compatibleType)
     {
-        logTypeMismatch<T>(dataRefName);
+        logTypeMismatch<T>(dataRefName.c_str());
     }
 }
 
 template <typename T>
 DataRefAccess<T>::DataRefAccess(const std::string& name, T defaultValue)
-    : dataRefName(name), overrideValue(defaultValue)
+    : dataRefName(name, MemoryResources::get(MemoryComponent::DataRefs)),
+      overrideValue(defaultValue)
 {
+    StartupProfiler::Scope profile("DataRefs", name);
     handle = XPLMFindDataRef(name.c_str());
     if (!handle)
     {
@@ -104,7 +117,7 @@ DataRefAccess<T>::DataRefAccess(const std::string& name, T defaultValue)
 
     if (!compatibleType)
     {
-        logTypeMismatch<T>(dataRefName);
+        logTypeMismatch<T>(dataRefName.c_str());
     }
 }
 
@@ -129,6 +142,12 @@ DataRefAccess<int>::operator int() const
         return overrideValue;
     }
 
+    double pending;
+    if (readPending(handle, pending))
+    {
+        return static_cast<int>(pending);
+    }
+
     return XPLMGetDatai(handle);
 }
 
@@ -140,6 +159,12 @@ DataRefAccess<bool>::operator bool() const
         return overrideValue;
     }
 
+    double pending;
+    if (readPending(handle, pending))
+    {
+        return pending != 0.0;
+    }
+
     return XPLMGetDatai(handle) != 0;
 }
 
@@ -151,6 +176,12 @@ DataRefAccess<float>::operator float() const
         return overrideValue;
     }
 
+    double pending;
+    if (readPending(handle, pending))
+    {
+        return static_cast<float>(pending);
+    }
+
     return XPLMGetDataf(handle);
 }
 
@@ -162,6 +193,12 @@ DataRefAccess<double>::operator double() const
         return overrideValue;
     }
 
+    double pending;
+    if (readPending(handle, pending))
+    {
+        return pending;
+    }
+
     return XPLMGetDatad(handle);
 }
 
@@ -173,6 +210,12 @@ bool DataRefAccess<int>::set(int value)
         return false;
     }
 
+    if (DataRefWriteBatch* batch = DataRefWriteBatch::current())
+    {
+        batch->setInt(handle, value);
+        return true;
+    }
+
     XPLMSetDatai(handle, value);
     return true;
 }
@@ -185,6 +228,12 @@ bool DataRefAccess<bool>::set(bool value)
         return false;
     }
 
+    if (DataRefWriteBatch* batch = DataRefWriteBatch::current())
+    {
+        batch->setInt(handle, value ? 1 : 0);
+        return true;
+    }
+
     XPLMSetDatai(handle, value ? 1 : 0);
     return true;
 }
@@ -197,6 +246,12 @@ bool DataRefAccess<float>::set(float value)
         return false;
     }
 
+    if (DataRefWriteBatch* batch = DataRefWriteBatch::current())
+    {
+        batch->setFloat(handle, value);
+        return true;
+    }
+
     XPLMSetDataf(handle, value);
     return true;
 }
@@ -209,6 +264,12 @@ bool DataRefAccess<double>::set(double value)
         return false;
     }
 
+    if (DataRefWriteBatch* batch = DataRefWriteBatch::current())
+    {
+        batch->setDouble(handle, value);
+        return true;
+    }
+
     XPLMSetDatad(handle, value);
     return true;
 }
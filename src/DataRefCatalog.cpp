@@ -0,0 +1,700 @@
+#include <XPlaneUtilities/DataRefCatalog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#endif
+
+namespace XPlaneUtilities
+{
+
+struct DataRefCatalog::Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t poolSize;
+    std::uint32_t sourceVersionOffset;
+    std::uint32_t sourceVersionLength;
+    std::uint64_t sourceSize; // DataRefs.txt size and modification time,
+    std::int64_t sourceTime;  // to detect a stale index
+};
+
+// One per hash slot
+struct DataRefCatalog::Record
+{
+    std::uint32_t nameOffset;
+    std::uint32_t unitsOffset;
+    std::uint32_t types;
+    std::uint32_t arraySize;
+    std::uint16_t nameLength;
+    std::uint16_t unitsLength;
+    std::uint8_t writable;
+    std::uint8_t reserved[3];
+};
+
+namespace
+{
+constexpr std::uint32_t kCatalogMagic = 0x43445058; // "XPDC"
+constexpr std::uint32_t kCatalogVersion = 1;
+
+std::uint64_t hashName(std::uint64_t seed, std::string_view name)
+{
+    // FNV-1a seeded per displacement, then a 64-bit finalizer to spread the bits
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    for (char c : name)
+    {
+        h ^= static_cast<std::uint8_t>(c);
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+struct ParsedEntry
+{
+    std::string_view name;
+    std::uint32_t types;
+    std::uint32_t arraySize;
+    bool writable;
+    std::string_view units;
+};
+
+// Read-only view of a whole file: mapped on POSIX, read into memory elsewhere
+struct FileView
+{
+    const char* data = nullptr;
+    std::size_t size = 0;
+    void* mapping = nullptr;
+    std::vector<char> buffer;
+
+    bool open(const std::string& path, std::string& error)
+    {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            error = "Cannot open " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            error = "Cannot read " + path;
+            ::close(fd);
+            return false;
+        }
+
+        void* addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE,
+                          fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED)
+        {
+            error = "Cannot map " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        mapping = addr;
+        data = static_cast<const char*>(addr);
+        size = static_cast<std::size_t>(st.st_size);
+        return true;
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            error = "Cannot open " + path;
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (buffer.empty())
+        {
+            error = "Cannot read " + path;
+            return false;
+        }
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+#endif
+    }
+
+    void close()
+    {
+#ifndef _WIN32
+        if (mapping)
+        {
+            munmap(mapping, size);
+        }
+#endif
+        mapping = nullptr;
+        data = nullptr;
+        size = 0;
+        buffer.clear();
+    }
+};
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// Split a line into its tab-separated columns
+std::size_t splitColumns(std::string_view line, std::string_view* columns, std::size_t max)
+{
+    std::size_t count = 0;
+    while (count < max)
+    {
+        const std::size_t tab = line.find('\t');
+        columns[count++] = trim(line.substr(0, tab));
+        if (tab == std::string_view::npos)
+        {
+            break;
+        }
+        line.remove_prefix(tab + 1);
+    }
+    return count;
+}
+
+void sourceStamp(const std::string& path, std::uint64_t& size, std::int64_t& time)
+{
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(path, ec);
+    size = ec ? 0 : static_cast<std::uint64_t>(fileSize);
+    const auto writeTime = std::filesystem::last_write_time(path, ec);
+    time = ec ? 0 : static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+}
+} // namespace
+
+DataRefCatalog::~DataRefCatalog()
+{
+    clear();
+}
+
+void DataRefCatalog::clear()
+{
+#ifndef _WIN32
+    if (mapping)
+    {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    storage.clear();
+    storage.shrink_to_fit();
+    header = nullptr;
+    displacements = nullptr;
+    records = nullptr;
+    pool = nullptr;
+}
+
+//==========================================================================
+// Building
+//==========================================================================
+
+bool DataRefCatalog::parseType(std::string_view text, std::uint32_t& types,
+                               std::uint32_t& arraySize)
+{
+    text = trim(text);
+    const std::size_t bracket = text.find('[');
+    const std::string_view base = text.substr(0, bracket);
+
+    // Dimensions multiply: "float[8][4]" has 32 elements
+    arraySize = 0;
+    if (bracket != std::string_view::npos)
+    {
+        arraySize = 1;
+        std::string_view dims = text.substr(bracket);
+        while (!dims.empty() && dims.front() == '[')
+        {
+            const std::size_t close = dims.find(']');
+            if (close == std::string_view::npos || close == 1)
+            {
+                return false;
+            }
+            std::uint32_t dim = 0;
+            for (char c : dims.substr(1, close - 1))
+            {
+                if (c < '0' || c > '9')
+                {
+                    return false;
+                }
+                dim = dim * 10 + static_cast<std::uint32_t>(c - '0');
+            }
+            arraySize *= dim;
+            dims.remove_prefix(close + 1);
+        }
+    }
+
+    if (base == "int")
+    {
+        types = arraySize ? IntArray : Int;
+    }
+    else if (base == "float")
+    {
+        types = arraySize ? FloatArray : Float;
+    }
+    else if (base == "double")
+    {
+        types = arraySize ? FloatArray : (Float | Double);
+    }
+    else if (base == "byte" || base == "data" || base == "string")
+    {
+        types = Data;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::string DataRefCatalog::typeName(std::uint32_t types)
+{
+    static const char* const kNames[] = {"int", "float", "double", "float[]", "int[]", "data"};
+    std::string name;
+    for (int bit = 0; bit < 6; ++bit)
+    {
+        if (types & (1u << bit))
+        {
+            if (!name.empty())
+            {
+                name += '|';
+            }
+            name += kNames[bit];
+        }
+    }
+    return name.empty() ? "unknown" : name;
+}
+
+bool DataRefCatalog::loadText(const std::string& path)
+{
+    FileView file;
+    if (!file.open(path, lastError))
+    {
+        return false;
+    }
+
+    // Parse: first line is the format/version line, then
+    // name <tab> type <tab> writable <tab> units <tab> description
+    std::vector<ParsedEntry> entries;
+    std::unordered_set<std::string_view> seen;
+    std::string_view text(file.data, file.size);
+    std::string_view sourceVersion;
+    bool firstLine = true;
+
+    while (!text.empty())
+    {
+        const std::size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        if (firstLine)
+        {
+            firstLine = false;
+            sourceVersion = trim(line);
+            continue;
+        }
+
+        std::string_view columns[4];
+        if (splitColumns(line, columns, 4) < 3 || columns[0].empty())
+        {
+            continue;
+        }
+
+        ParsedEntry entry;
+        entry.name = columns[0];
+        if (!parseType(columns[1], entry.types, entry.arraySize) || !seen.insert(entry.name).second ||
+            entry.name.size() > 0xffff)
+        {
+            continue;
+        }
+        entry.writable = !columns[2].empty() && (columns[2][0] == 'y' || columns[2][0] == 'Y');
+        entry.units = columns[3].size() > 0xffff ? std::string_view() : columns[3];
+        entries.push_back(entry);
+    }
+
+    if (entries.empty())
+    {
+        lastError = "No datarefs found in " + path;
+        file.close();
+        return false;
+    }
+
+    // Hash and displace: group names into buckets by their seed-0 hash, then
+    // place the largest buckets first by searching for a seed that sends all
+    // their names to free slots. Single-name buckets take any free slot.
+    const auto n = static_cast<std::uint32_t>(entries.size());
+    std::vector<std::vector<std::uint32_t>> buckets(n);
+    for (std::uint32_t i = 0; i < n; ++i)
+    {
+        buckets[hashName(0, entries[i].name) % n].push_back(i);
+    }
+
+    std::vector<std::uint32_t> order(n);
+    for (std::uint32_t i = 0; i < n; ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t a, std::uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    constexpr std::uint32_t kEmpty = 0xffffffffu;
+    std::vector<std::int32_t> table(n, 0);
+    std::vector<std::uint32_t> slotEntry(n, kEmpty);
+    std::vector<std::uint32_t> trial;
+
+    std::size_t next = 0;
+    for (; next < n && buckets[order[next]].size() > 1; ++next)
+    {
+        const std::vector<std::uint32_t>& bucket = buckets[order[next]];
+        bool placed = false;
+        for (std::uint32_t seed = 1; seed < 0x7fffffffu && !placed; ++seed)
+        {
+            trial.clear();
+            placed = true;
+            for (std::uint32_t key : bucket)
+            {
+                const auto slot = static_cast<std::uint32_t>(hashName(seed, entries[key].name) % n);
+                if (slotEntry[slot] != kEmpty ||
+                    std::find(trial.begin(), trial.end(), slot) != trial.end())
+                {
+                    placed = false;
+                    break;
+                }
+                trial.push_back(slot);
+            }
+
+            if (placed)
+            {
+                for (std::size_t k = 0; k < bucket.size(); ++k)
+                {
+                    slotEntry[trial[k]] = bucket[k];
+                }
+                table[order[next]] = static_cast<std::int32_t>(seed);
+            }
+        }
+
+        if (!placed)
+        {
+            lastError = "Could not build the dataref index for " + path;
+            file.close();
+            return false;
+        }
+    }
+
+    std::uint32_t freeSlot = 0;
+    for (; next < n && buckets[order[next]].size() == 1; ++next)
+    {
+        while (slotEntry[freeSlot] != kEmpty)
+        {
+            ++freeSlot;
+        }
+        slotEntry[freeSlot] = buckets[order[next]][0];
+        table[order[next]] = -static_cast<std::int32_t>(freeSlot) - 1;
+    }
+
+    // Flatten into header | displacements | records | string pool
+    std::string poolData;
+    std::unordered_map<std::string_view, std::uint32_t> unitsOffsets;
+    auto addString = [&poolData](std::string_view s) {
+        const auto offset = static_cast<std::uint32_t>(poolData.size());
+        poolData.append(s.data(), s.size());
+        return offset;
+    };
+
+    Header newHeader{};
+    newHeader.magic = kCatalogMagic;
+    newHeader.version = kCatalogVersion;
+    newHeader.count = n;
+    newHeader.sourceVersionOffset = addString(sourceVersion);
+    newHeader.sourceVersionLength = static_cast<std::uint32_t>(sourceVersion.size());
+    sourceStamp(path, newHeader.sourceSize, newHeader.sourceTime);
+
+    std::vector<Record> newRecords(n);
+    for (std::uint32_t slot = 0; slot < n; ++slot)
+    {
+        const ParsedEntry& entry = entries[slotEntry[slot]];
+        Record& record = newRecords[slot];
+        std::memset(&record, 0, sizeof(record));
+        record.nameOffset = addString(entry.name);
+        record.nameLength = static_cast<std::uint16_t>(entry.name.size());
+        auto units = unitsOffsets.find(entry.units);
+        if (units == unitsOffsets.end())
+        {
+            units = unitsOffsets.emplace(entry.units, addString(entry.units)).first;
+        }
+        record.unitsOffset = units->second;
+        record.unitsLength = static_cast<std::uint16_t>(entry.units.size());
+        record.types = entry.types;
+        record.arraySize = entry.arraySize;
+        record.writable = entry.writable ? 1 : 0;
+    }
+    newHeader.poolSize = static_cast<std::uint32_t>(poolData.size());
+    file.close();
+
+    std::vector<char> image(sizeof(Header) + n * sizeof(std::int32_t) + n * sizeof(Record) +
+                            poolData.size());
+    char* p = image.data();
+    std::memcpy(p, &newHeader, sizeof(Header));
+    p += sizeof(Header);
+    std::memcpy(p, table.data(), n * sizeof(std::int32_t));
+    p += n * sizeof(std::int32_t);
+    std::memcpy(p, newRecords.data(), n * sizeof(Record));
+    p += n * sizeof(Record);
+    std::memcpy(p, poolData.data(), poolData.size());
+
+    clear();
+    storage.swap(image);
+    return adopt(storage.data(), storage.size());
+}
+
+//==========================================================================
+// Serialized index
+//==========================================================================
+
+bool DataRefCatalog::adopt(const char* data, std::size_t size)
+{
+    Header h;
+    if (size < sizeof(Header))
+    {
+        lastError = "Dataref index is truncated";
+        return false;
+    }
+    std::memcpy(&h, data, sizeof(Header));
+
+    if (h.magic != kCatalogMagic || h.version != kCatalogVersion)
+    {
+        lastError = "Dataref index has an unknown format";
+        return false;
+    }
+
+    const std::size_t expected = sizeof(Header) + std::size_t(h.count) * sizeof(std::int32_t) +
+                                 std::size_t(h.count) * sizeof(Record) + h.poolSize;
+    if (h.count == 0 || size < expected ||
+        std::size_t(h.sourceVersionOffset) + h.sourceVersionLength > h.poolSize)
+    {
+        lastError = "Dataref index is truncated";
+        return false;
+    }
+
+    const auto* newDisplacements = reinterpret_cast<const std::int32_t*>(data + sizeof(Header));
+    const auto* newRecords =
+        reinterpret_cast<const Record*>(data + sizeof(Header) + h.count * sizeof(std::int32_t));
+
+    // slotFor() trusts these, so a corrupt cache must not get past here. A
+    // negative displacement d names slot -d-1 directly.
+    for (std::uint32_t i = 0; i < h.count; ++i)
+    {
+        const std::int64_t d = newDisplacements[i];
+        if (d < 0 && -d - 1 >= static_cast<std::int64_t>(h.count))
+        {
+            lastError = "Dataref index is corrupt";
+            return false;
+        }
+
+        const Record& record = newRecords[i];
+        if (std::size_t(record.nameOffset) + record.nameLength > h.poolSize ||
+            std::size_t(record.unitsOffset) + record.unitsLength > h.poolSize)
+        {
+            lastError = "Dataref index is corrupt";
+            return false;
+        }
+    }
+
+    header = reinterpret_cast<const Header*>(data);
+    displacements = newDisplacements;
+    records = newRecords;
+    pool = data + sizeof(Header) + h.count * (sizeof(std::int32_t) + sizeof(Record));
+    lastError.clear();
+    return true;
+}
+
+bool DataRefCatalog::save(const std::string& path) const
+{
+    if (!header)
+    {
+        return false;
+    }
+
+    const std::size_t size = sizeof(Header) + header->count * (sizeof(std::int32_t) + sizeof(Record)) +
+                             header->poolSize;
+
+    // Write beside the index and rename over it, so a crash leaves the old
+    // index intact and catalogs that have the old one mapped keep their copy
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(size));
+        out.close();
+        if (!out)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool DataRefCatalog::loadIndex(const std::string& path)
+{
+    clear();
+
+    FileView file;
+    if (!file.open(path, lastError))
+    {
+        return false;
+    }
+
+    const bool ok = adopt(file.data, file.size);
+    if (!ok)
+    {
+        file.close();
+        return false;
+    }
+
+    // Keep the file alive for as long as the catalog points into it
+    if (file.mapping)
+    {
+        mapping = file.mapping;
+        mappingSize = file.size;
+    }
+    else
+    {
+        storage.swap(file.buffer);
+    }
+    return true;
+}
+
+bool DataRefCatalog::load(const std::string& sourcePath, const std::string& cachePath)
+{
+    std::uint64_t size;
+    std::int64_t time;
+    sourceStamp(sourcePath, size, time);
+
+    if (loadIndex(cachePath) && header->sourceSize == size && header->sourceTime == time)
+    {
+        return true;
+    }
+
+    if (!loadText(sourcePath))
+    {
+        clear(); // Drop the stale index loadIndex() may have left
+        return false;
+    }
+    save(cachePath);
+    return true;
+}
+
+//==========================================================================
+// Lookup
+//==========================================================================
+
+const DataRefCatalog::Record* DataRefCatalog::slotFor(std::string_view name) const
+{
+    if (!header)
+    {
+        return nullptr;
+    }
+
+    const std::uint32_t n = header->count;
+    // adopt() checked that every negative displacement names a slot below n
+    const std::int64_t d = displacements[hashName(0, name) % n];
+    const std::uint32_t slot = d < 0 ? static_cast<std::uint32_t>(-d - 1)
+                                     : static_cast<std::uint32_t>(hashName(d, name) % n);
+
+    // Every name maps to some slot; only the one stored there matches
+    const Record* record = &records[slot];
+    if (record->nameLength != name.size() ||
+        std::memcmp(pool + record->nameOffset, name.data(), name.size()) != 0)
+    {
+        return nullptr;
+    }
+    return record;
+}
+
+bool DataRefCatalog::find(std::string_view name, Entry& entry) const
+{
+    const Record* record = slotFor(name);
+    if (!record)
+    {
+        return false;
+    }
+
+    entry.name = std::string_view(pool + record->nameOffset, record->nameLength);
+    entry.types = record->types;
+    entry.arraySize = record->arraySize;
+    entry.writable = record->writable != 0;
+    entry.units = std::string_view(pool + record->unitsOffset, record->unitsLength);
+    return true;
+}
+
+bool DataRefCatalog::contains(std::string_view name) const
+{
+    return slotFor(name) != nullptr;
+}
+
+DataRefCatalog::Check DataRefCatalog::check(std::string_view name, std::uint32_t expectedTypes,
+                                            bool needWrite) const
+{
+    const Record* record = slotFor(name);
+    if (!record)
+    {
+        return Check::Unknown;
+    }
+    if (expectedTypes && !(record->types & expectedTypes))
+    {
+        return Check::TypeMismatch;
+    }
+    if (needWrite && !record->writable)
+    {
+        return Check::ReadOnly;
+    }
+    return Check::Ok;
+}
+
+std::size_t DataRefCatalog::size() const
+{
+    return header ? header->count : 0;
+}
+
+std::string_view DataRefCatalog::sourceVersion() const
+{
+    return header ? std::string_view(pool + header->sourceVersionOffset,
+                                     header->sourceVersionLength)
+                  : std::string_view();
+}
+
+} // namespace XPlaneUtilities
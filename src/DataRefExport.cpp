@@ -1,97 +1,110 @@
 #include <XPlaneUtilities/DataRefExport.h>
+#include <XPlaneUtilities/StartupProfiler.h>
 
 namespace XPlaneUtilities
 {
+namespace
+{
+// Scalar types a DataRefExport can advertise to X-Plane
+constexpr XPLMDataTypeID kScalarTypes = xplmType_Int | xplmType_Float | xplmType_Double;
 
-// Template specialization for int type - read-write
-template <>
-DataRefExport<int>::DataRefExport(const std::string& name, void* ref,
-                                  std::function<int(void*)> onRd,
-                                  std::function<void(void*, int)> onWr)
-    : ownerRef(ref), onRead(onRd), onWrite(onWr)
+template <typename T> constexpr XPLMDataTypeID nativeType();
+template <> constexpr XPLMDataTypeID nativeType<int>()
 {
-    xpDataRef = XPLMRegisterDataAccessor(
-        name.c_str(), xplmType_Int,
-        1, // writable
-        // Int read callback
-        [](void* r)
-        {
-            auto self = reinterpret_cast<DataRefExport<int>*>(r);
-            return self->onRead(self->ownerRef);
-        },
-        // Int write callback
-        [](void* r, int v)
-        {
-            auto self = reinterpret_cast<DataRefExport<int>*>(r);
-            self->onWrite(self->ownerRef, v);
-        },
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        this, this);
+    return xplmType_Int;
+}
+template <> constexpr XPLMDataTypeID nativeType<float>()
+{
+    return xplmType_Float;
+}
+template <> constexpr XPLMDataTypeID nativeType<double>()
+{
+    return xplmType_Double;
 }
 
-// Template specialization for int type - read-only
-template <>
-DataRefExport<int>::DataRefExport(const std::string& name, void* ref,
-                                  std::function<int(void*)> onRd)
-    : ownerRef(ref), onRead(onRd), onWrite(nullptr)
+// C callbacks handed to XPLMRegisterDataAccessor. The refcon is the
+// DataRefExport itself; each advertised type converts the native value once.
+template <typename T, typename U> U readAs(void* r)
 {
-    xpDataRef = XPLMRegisterDataAccessor(
-        name.c_str(), xplmType_Int,
-        0, // not writable
-        // Int read callback
-        [](void* r)
-        {
-            auto self = reinterpret_cast<DataRefExport<int>*>(r);
-            return self->onRead(self->ownerRef);
-        },
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-        nullptr, this, nullptr);
+    auto self = reinterpret_cast<DataRefExport<T>*>(r);
+    return convertScalar<U>(self->get());
 }
 
-// Template specialization for float type - read-write
-template <>
-DataRefExport<float>::DataRefExport(const std::string& name, void* ref,
-                                    std::function<float(void*)> onRd,
-                                    std::function<void(void*, float)> onWr)
-    : ownerRef(ref), onRead(onRd), onWrite(onWr)
+template <typename T, typename U> void writeAs(void* r, U v)
 {
-    xpDataRef = XPLMRegisterDataAccessor(
-        name.c_str(), xplmType_Float,
-        1, // writable
-        nullptr, nullptr,
-        // Float read callback
-        [](void* r)
-        {
-            auto self = reinterpret_cast<DataRefExport<float>*>(r);
-            return self->onRead(self->ownerRef);
-        },
-        // Float write callback
-        [](void* r, float v)
-        {
-            auto self = reinterpret_cast<DataRefExport<float>*>(r);
-            self->onWrite(self->ownerRef, v);
-        },
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, this, this);
+    auto self = reinterpret_cast<DataRefExport<T>*>(r);
+    self->set(convertScalar<T>(v));
+}
+} // namespace
+
+// Read-only dataref
+template <typename T>
+DataRefExport<T>::DataRefExport(const std::string& name, void* ref,
+                                std::function<T(void*)> onRd)
+    : DataRefExport(name, ref, std::move(onRd), nativeType<T>())
+{
+}
+
+// Read-only dataref advertising additional scalar types
+template <typename T>
+DataRefExport<T>::DataRefExport(const std::string& name, void* ref,
+                                std::function<T(void*)> onRd, XPLMDataTypeID types)
+    : ownerRef(ref), onRead(std::move(onRd)), onWrite(nullptr),
+      dataTypes((types & kScalarTypes) | nativeType<T>())
+{
+    registerAccessor(name);
 }
 
-// Template specialization for float type - read-only
-template <>
-DataRefExport<float>::DataRefExport(const std::string& name, void* ref,
-                                    std::function<float(void*)> onRd)
-    : ownerRef(ref), onRead(onRd), onWrite(nullptr)
+// Read-write dataref
+template <typename T>
+DataRefExport<T>::DataRefExport(const std::string& name, void* ref,
+                                std::function<T(void*)> onRd,
+                                std::function<void(void*, T)> onWr)
+    : DataRefExport(name, ref, std::move(onRd), std::move(onWr), nativeType<T>())
 {
+}
+
+// Read-write dataref advertising additional scalar types
+template <typename T>
+DataRefExport<T>::DataRefExport(const std::string& name, void* ref,
+                                std::function<T(void*)> onRd,
+                                std::function<void(void*, T)> onWr, XPLMDataTypeID types)
+    : ownerRef(ref), onRead(std::move(onRd)), onWrite(std::move(onWr)),
+      dataTypes((types & kScalarTypes) | nativeType<T>())
+{
+    registerAccessor(name);
+}
+
+// Register one accessor that serves every advertised type
+template <typename T> void DataRefExport<T>::registerAccessor(const std::string& name)
+{
+    StartupProfiler::Scope profile("DataRefs", name);
+    const bool writable = static_cast<bool>(onWrite);
+    const bool hasInt = (dataTypes & xplmType_Int) != 0;
+    const bool hasFloat = (dataTypes & xplmType_Float) != 0;
+    const bool hasDouble = (dataTypes & xplmType_Double) != 0;
+
     xpDataRef = XPLMRegisterDataAccessor(
-        name.c_str(), xplmType_Float,
-        0, // not writable
-        nullptr, nullptr,
-        // Float read callback
-        [](void* r)
-        {
-            auto self = reinterpret_cast<DataRefExport<float>*>(r);
-            return self->onRead(self->ownerRef);
-        },
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, this,
-        nullptr);
+        name.c_str(), dataTypes, writable ? 1 : 0,
+        hasInt ? &readAs<T, int> : nullptr,
+        hasInt && writable ? &writeAs<T, int> : nullptr,
+        hasFloat ? &readAs<T, float> : nullptr,
+        hasFloat && writable ? &writeAs<T, float> : nullptr,
+        hasDouble ? &readAs<T, double> : nullptr,
+        hasDouble && writable ? &writeAs<T, double> : nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+        this, writable ? this : nullptr);
+}
+
+template <typename T> bool DataRefExport<T>::set(T value)
+{
+    if (!onWrite)
+    {
+        return false;
+    }
+
+    onWrite(ownerRef, value);
+    return true;
 }
 
 // Destructor - unregister the dataref
@@ -107,5 +120,6 @@ template <typename T> DataRefExport<T>::~DataRefExport()
 // Explicit template instantiations
 template class DataRefExport<int>;
 template class DataRefExport<float>;
+template class DataRefExport<double>;
 
 } // namespace XPlaneUtilities
@@ -0,0 +1,164 @@
+#include <XPlaneUtilities/DataRefExportRegistry.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMPlugin.h>
+#include <chrono>
+#include <fmt/format.h>
+
+namespace XPlaneUtilities
+{
+namespace
+{
+// Message understood by DataRefEditor and DataRefTool; the payload is the dataref name
+constexpr int MSG_ADD_DATAREF = 0x01000000;
+
+constexpr const char* kBrowserSignatures[] = {
+    "xplanesdk.examples.DataRefEditor",
+    "com.leecbaker.datareftool",
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+} // namespace
+
+DataRefExportRegistry::~DataRefExportRegistry()
+{
+    // Silent teardown: the logger may already be shut down at this point
+    exports<int>().clear();
+    exports<float>().clear();
+    exports<double>().clear();
+}
+
+void DataRefExportRegistry::reserve(std::size_t count)
+{
+    declarations<int>().reserve(count);
+    declarations<float>().reserve(count);
+    declarations<double>().reserve(count);
+}
+
+std::size_t DataRefExportRegistry::declaredCount() const
+{
+    return std::get<0>(decls).size() + std::get<1>(decls).size() + std::get<2>(decls).size();
+}
+
+std::size_t DataRefExportRegistry::registeredCount() const
+{
+    return std::get<0>(exported).size() + std::get<1>(exported).size() +
+           std::get<2>(exported).size();
+}
+
+template <typename T>
+void DataRefExportRegistry::createExports(std::vector<const std::string*>& names)
+{
+    auto& out = exports<T>();
+    out.reserve(declarations<T>().size());
+    for (const auto& decl : declarations<T>())
+    {
+        std::unique_ptr<DataRefExport<T>> created;
+        if (decl.onWrite)
+        {
+            created = std::make_unique<DataRefExport<T>>(decl.name, decl.owner, decl.onRead,
+                                                         decl.onWrite, decl.types);
+        }
+        else
+        {
+            created =
+                std::make_unique<DataRefExport<T>>(decl.name, decl.owner, decl.onRead, decl.types);
+        }
+
+        // Typically the name is already taken by another plugin
+        if (!created->isValid())
+        {
+            XPlaneLog::warn(fmt::format("Failed to register exported dataref {}", decl.name));
+            ++failures;
+            continue;
+        }
+
+        out.push_back(std::move(created));
+        names.push_back(&decl.name);
+    }
+}
+
+void DataRefExportRegistry::registerAll()
+{
+    if (registered)
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<const std::string*> names;
+    names.reserve(declaredCount());
+    failures = 0;
+    createExports<int>(names);
+    createExports<float>(names);
+    createExports<double>(names);
+    registered = true;
+
+    notifyBrowsers(names);
+
+    registerMs = elapsedMs(start);
+    if (failures > 0)
+    {
+        XPlaneLog::warn(fmt::format("Registered {} exported datarefs in {:.2f} ms, {} failed",
+                                    registeredCount(), registerMs, failures));
+    }
+    else
+    {
+        XPlaneLog::info(fmt::format("Registered {} exported datarefs in {:.2f} ms",
+                                    registeredCount(), registerMs));
+    }
+}
+
+void DataRefExportRegistry::unregisterAll()
+{
+    if (!registered)
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t count = registeredCount();
+
+    exports<int>().clear();
+    exports<float>().clear();
+    exports<double>().clear();
+    registered = false;
+
+    unregisterMs = elapsedMs(start);
+    XPlaneLog::info(fmt::format("Unregistered {} exported datarefs in {:.2f} ms", count,
+                                unregisterMs));
+}
+
+void DataRefExportRegistry::notifyBrowsers(const std::vector<const std::string*>& names) const
+{
+    // Resolve the browser plugins once for the whole batch rather than per dataref
+    std::vector<XPLMPluginID> browsers;
+    for (const char* signature : kBrowserSignatures)
+    {
+        XPLMPluginID id = XPLMFindPluginBySignature(signature);
+        if (id != XPLM_NO_PLUGIN_ID)
+        {
+            browsers.push_back(id);
+        }
+    }
+
+    if (browsers.empty())
+    {
+        return;
+    }
+
+    for (const std::string* name : names)
+    {
+        for (XPLMPluginID id : browsers)
+        {
+            XPLMSendMessageToPlugin(id, MSG_ADD_DATAREF, const_cast<char*>(name->c_str()));
+        }
+    }
+}
+
+} // namespace XPlaneUtilities
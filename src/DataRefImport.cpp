@@ -1,4 +1,5 @@
 #include <XPlaneUtilities/DataRefImport.h>
+#include <XPlaneUtilities/StartupProfiler.h>
 #include <XPlaneUtilities/XPlaneLog.h>
 
 namespace XPlaneUtilities
@@ -7,6 +8,7 @@ namespace XPlaneUtilities
 // Constructor - throws if dataref not found
 template <typename T> DataRefImport<T>::DataRefImport(const std::string& name)
 {
+    StartupProfiler::Scope profile("DataRefs", name);
     handle = XPLMFindDataRef(name.c_str());
     if (!handle)
     {
@@ -17,6 +19,7 @@ template <typename T> DataRefImport<T>::DataRefImport(const std::string& name)
 // Constructor with default value - uses default if dataref not found
 template <typename T> DataRefImport<T>::DataRefImport(const std::string& name, T defaultValue)
 {
+    StartupProfiler::Scope profile("DataRefs", name);
     handle = XPLMFindDataRef(name.c_str());
     if (!handle)
     {
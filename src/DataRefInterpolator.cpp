@@ -0,0 +1,303 @@
+#include <XPlaneUtilities/DataRefInterpolator.h>
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMProcessing.h>
+#include <chrono>
+#include <cmath>
+
+namespace XPlaneUtilities
+{
+
+DataRefInterpolator::DataRefInterpolator(std::size_t capacity)
+    : capacity(capacity < 3 ? 3 : capacity)
+{
+}
+
+DataRefInterpolator::~DataRefInterpolator()
+{
+    disableFlightLoop();
+}
+
+double DataRefInterpolator::now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int DataRefInterpolator::addChannelInternal(Channel channel)
+{
+    if (!times.empty())
+    {
+        XPlaneLog::warn("Interpolated channel '" + channel.name +
+                        "' added after the first sample, ignoring");
+        return -1;
+    }
+
+    if (channel.wrapMax > channel.wrapMin)
+    {
+        wrapped.push_back(channels.size());
+    }
+    channels.push_back(std::move(channel));
+    return static_cast<int>(channels.size() - 1);
+}
+
+int DataRefInterpolator::addDataRef(const std::string& name, double wrapMin, double wrapMax)
+{
+    ScalarDataRef dataRef;
+    if (!dataRef.find(name, "interpolated channel skipped"))
+    {
+        return -1;
+    }
+
+    return addChannelInternal({name, dataRef, nullptr, wrapMin, wrapMax});
+}
+
+int DataRefInterpolator::addChannel(const std::string& name, std::function<double()> source,
+                                    double wrapMin, double wrapMax)
+{
+    if (!source)
+    {
+        return -1;
+    }
+    return addChannelInternal({name, ScalarDataRef(), std::move(source), wrapMin, wrapMax});
+}
+
+void DataRefInterpolator::addFlightData(FlightDataProvider& provider)
+{
+    FlightDataProvider* p = &provider;
+    addChannel("sim/flightmodel/weight/m_fuel_total", [p]() { return p->getFuelOnBoard(); });
+    addChannel("sim/time/zulu_time_sec", [p]() { return p->getZuluTimeSec(); }, 0.0, 86400.0);
+    addChannel("sim/flightmodel/position/groundspeed", [p]() { return p->getGroundSpeed(); });
+    addChannel("sim/flightmodel/position/latitude", [p]() { return p->getLatitude(); });
+    addChannel("sim/flightmodel/position/longitude", [p]() { return p->getLongitude(); }, -180.0,
+               180.0);
+    addChannel("sim/flightmodel/position/indicated_airspeed",
+               [p]() { return p->getIndicatedAirspeed(); });
+    addChannel("sim/flightmodel/position/elevation", [p]() { return p->getElevation(); });
+}
+
+int DataRefInterpolator::find(const std::string& name) const
+{
+    for (std::size_t i = 0; i < channels.size(); ++i)
+    {
+        if (channels[i].name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+//==========================================================================
+// Writer (sim thread)
+//==========================================================================
+
+void DataRefInterpolator::sample()
+{
+    sample(now());
+}
+
+void DataRefInterpolator::sample(double timestamp)
+{
+    const std::size_t count = channels.size();
+    if (times.empty())
+    {
+        // The channel set is fixed from here on; readers only touch the
+        // storage once the first sample has been published
+        times.assign(capacity, 0.0);
+        values.assign(capacity * count, 0.0);
+    }
+
+    const std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+    const std::size_t slot = static_cast<std::size_t>((seq / 2) % capacity);
+
+    // Readers never use the slot being overwritten, so sampling straight into
+    // it only makes the odd window longer, not riskier
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    double* row = values.data() + slot * count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Channel& channel = channels[i];
+        row[i] = channel.custom ? channel.custom() : channel.dataRef.read();
+    }
+    times[slot] = timestamp;
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+void DataRefInterpolator::enableFlightLoop()
+{
+    flightLoop.start(
+        [](void* self, float) { static_cast<DataRefInterpolator*>(self)->sample(); }, this);
+}
+
+void DataRefInterpolator::disableFlightLoop()
+{
+    flightLoop.stop();
+}
+
+//==========================================================================
+// Readers (any thread)
+//==========================================================================
+
+bool DataRefInterpolator::findSpan(double time, std::uint64_t completed, Span& span) const
+{
+    if (completed == 0)
+    {
+        return false;
+    }
+
+    // Sample n lives in slot n % capacity. The next write replaces sample
+    // completed - capacity, so only the newest capacity - 1 samples are used.
+    const std::size_t count = channels.size();
+    const std::uint64_t newest = completed - 1;
+    const std::uint64_t oldest = completed >= capacity ? completed - (capacity - 1) : 0;
+    auto slotOf = [this](std::uint64_t n) { return static_cast<std::size_t>(n % capacity); };
+
+    const double newestTime = times[slotOf(newest)];
+    std::uint64_t first = newest;
+    if (time >= newestTime)
+    {
+        // Extrapolate from the last two samples
+        if (newest > oldest)
+        {
+            first = newest - 1;
+            if (time > newestTime + maxExtrapolation)
+            {
+                time = newestTime + maxExtrapolation;
+            }
+        }
+    }
+    else
+    {
+        // Samples are few and newest-first is the common case
+        while (first > oldest && times[slotOf(first)] > time)
+        {
+            --first;
+        }
+        if (times[slotOf(first)] > time)
+        {
+            time = times[slotOf(first)]; // Before the oldest sample: hold it
+        }
+    }
+
+    const std::uint64_t second = first < newest ? first + 1 : first;
+    const double t0 = times[slotOf(first)];
+    const double t1 = times[slotOf(second)];
+
+    span.first = first;
+    span.a = values.data() + slotOf(first) * count;
+    span.b = values.data() + slotOf(second) * count;
+    span.f = t1 > t0 ? (time - t0) / (t1 - t0) : 0.0;
+    return true;
+}
+
+bool DataRefInterpolator::stillValid(const Span& span) const
+{
+    // Writes begun so far have replaced every sample older than begun - capacity
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t begun = (sequence.load(std::memory_order_relaxed) + 1) / 2;
+    return span.first + capacity >= begun;
+}
+
+double DataRefInterpolator::interpolate(std::size_t channel, const Span& span) const
+{
+    const double a = span.a[channel];
+    const double b = span.b[channel];
+    const Channel& c = channels[channel];
+    if (!(c.wrapMax > c.wrapMin))
+    {
+        return a + (b - a) * span.f;
+    }
+
+    // Take the short way round and fold the result back into range
+    const double range = c.wrapMax - c.wrapMin;
+    double delta = b - a;
+    delta -= range * std::round(delta / range);
+    const double v = a + delta * span.f - c.wrapMin;
+    return c.wrapMin + v - range * std::floor(v / range);
+}
+
+bool DataRefInterpolator::read(double time, double* out) const
+{
+    const std::size_t count = channels.size();
+    for (;;)
+    {
+        Span span;
+        if (!findSpan(time, sequence.load(std::memory_order_acquire) / 2, span))
+        {
+            return false;
+        }
+
+        // Straight-line loop over two rows; vectorized by the compiler
+        const double* a = span.a;
+        const double* b = span.b;
+        const double f = span.f;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            out[i] = a[i] + (b[i] - a[i]) * f;
+        }
+        for (std::size_t i : wrapped)
+        {
+            out[i] = interpolate(i, span);
+        }
+
+        if (stillValid(span))
+        {
+            return true;
+        }
+    }
+}
+
+bool DataRefInterpolator::read(double time, std::vector<double>& out) const
+{
+    out.resize(channels.size());
+    return read(time, out.data());
+}
+
+double DataRefInterpolator::read(int channel, double time) const
+{
+    if (channel < 0 || static_cast<std::size_t>(channel) >= channels.size())
+    {
+        return 0.0;
+    }
+
+    for (;;)
+    {
+        Span span;
+        if (!findSpan(time, sequence.load(std::memory_order_acquire) / 2, span))
+        {
+            return 0.0;
+        }
+
+        const double value = interpolate(static_cast<std::size_t>(channel), span);
+        if (stillValid(span))
+        {
+            return value;
+        }
+    }
+}
+
+double DataRefInterpolator::latestTime() const
+{
+    for (;;)
+    {
+        const std::uint64_t completed = sequence.load(std::memory_order_acquire) / 2;
+        if (completed == 0)
+        {
+            return 0.0;
+        }
+
+        const double time = times[static_cast<std::size_t>((completed - 1) % capacity)];
+        Span span{completed - 1, nullptr, nullptr, 0.0};
+        if (stillValid(span))
+        {
+            return time;
+        }
+    }
+}
+
+} // namespace XPlaneUtilities
@@ -0,0 +1,271 @@
+#include <XPlaneUtilities/DataRefWriteBatch.h>
+
+#include <algorithm>
+
+namespace XPlaneUtilities
+{
+
+DataRefWriteBatch* DataRefWriteBatch::active = nullptr;
+
+DataRefWriteBatch::~DataRefWriteBatch()
+{
+    disableFlightLoop();
+    deactivate();
+}
+
+void DataRefWriteBatch::activate()
+{
+    active = this;
+}
+
+void DataRefWriteBatch::deactivate()
+{
+    if (active == this)
+    {
+        active = nullptr;
+    }
+    flush();
+}
+
+//==========================================================================
+// Recording
+//==========================================================================
+
+DataRefWriteBatch::Write& DataRefWriteBatch::entry(XPLMDataRef handle, Type type)
+{
+    auto it = index.find(handle);
+    if (it == index.end())
+    {
+        it = index.emplace(handle, writes.size()).first;
+        writes.push_back({handle, type, 0.0, {}, false});
+
+        // The two pending lists trade places on every flush; with room for
+        // every entry in both, neither grows again
+        pendingWrites.reserve(writes.size());
+        flushing.reserve(writes.size());
+    }
+
+    Write& write = writes[it->second];
+    write.type = type;
+    if (!write.dirty)
+    {
+        write.dirty = true;
+        pendingWrites.push_back(it->second);
+    }
+    return write;
+}
+
+void DataRefWriteBatch::setScalar(XPLMDataRef handle, Type type, double value)
+{
+    if (!handle)
+    {
+        return;
+    }
+
+    const std::size_t before = pendingWrites.size();
+    entry(handle, type).value = value;
+    ++stats.writes;
+    if (pendingWrites.size() == before)
+    {
+        ++stats.coalesced; // Last writer wins
+    }
+}
+
+void DataRefWriteBatch::setElement(XPLMDataRef handle, Type type, int index, double value)
+{
+    if (!handle || index < 0)
+    {
+        return;
+    }
+
+    // Duplicates are resolved (and counted) when the ranges are built in flush()
+    auto& elements = entry(handle, type).elements;
+    elements.push_back({index, static_cast<std::uint32_t>(elements.size()), value});
+    ++stats.writes;
+}
+
+void DataRefWriteBatch::setInt(XPLMDataRef handle, int value)
+{
+    setScalar(handle, Type::Int, value);
+}
+
+void DataRefWriteBatch::setFloat(XPLMDataRef handle, float value)
+{
+    setScalar(handle, Type::Float, value);
+}
+
+void DataRefWriteBatch::setDouble(XPLMDataRef handle, double value)
+{
+    setScalar(handle, Type::Double, value);
+}
+
+void DataRefWriteBatch::setIntElement(XPLMDataRef handle, int index, int value)
+{
+    setElement(handle, Type::IntArray, index, value);
+}
+
+void DataRefWriteBatch::setFloatElement(XPLMDataRef handle, int index, float value)
+{
+    setElement(handle, Type::FloatArray, index, value);
+}
+
+void DataRefWriteBatch::setIntArray(XPLMDataRef handle, const int* values, int offset, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        setElement(handle, Type::IntArray, offset + i, values[i]);
+    }
+}
+
+void DataRefWriteBatch::setFloatArray(XPLMDataRef handle, const float* values, int offset,
+                                      int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        setElement(handle, Type::FloatArray, offset + i, values[i]);
+    }
+}
+
+bool DataRefWriteBatch::pending(XPLMDataRef handle, double& value) const
+{
+    auto it = index.find(handle);
+    if (it == index.end())
+    {
+        return false;
+    }
+
+    const Write& write = writes[it->second];
+    if (!write.dirty || write.type == Type::IntArray || write.type == Type::FloatArray)
+    {
+        return false;
+    }
+
+    value = write.value;
+    return true;
+}
+
+//==========================================================================
+// Flushing
+//==========================================================================
+
+void DataRefWriteBatch::flushArray(XPLMDataRef handle, Type type, std::vector<Element>& elements)
+{
+    // Write order among equal indices is kept, so the last one wins. Sorting
+    // on the sequence as well (rather than a stable sort) needs no buffer.
+    std::sort(elements.begin(), elements.end(), [](const Element& a, const Element& b) {
+        return a.index != b.index ? a.index < b.index : a.sequence < b.sequence;
+    });
+
+    std::size_t i = 0;
+    while (i < elements.size())
+    {
+        // One contiguous run of indices starting at elements[i]
+        const int offset = elements[i].index;
+        int next = offset;
+        intScratch.clear();
+        floatScratch.clear();
+
+        while (i < elements.size() && elements[i].index == next)
+        {
+            std::size_t last = i;
+            while (last + 1 < elements.size() && elements[last + 1].index == elements[i].index)
+            {
+                ++last;
+            }
+            stats.coalesced += last - i;
+
+            if (type == Type::IntArray)
+            {
+                intScratch.push_back(static_cast<int>(elements[last].value));
+            }
+            else
+            {
+                floatScratch.push_back(static_cast<float>(elements[last].value));
+            }
+            next = elements[i].index + 1;
+            i = last + 1;
+        }
+
+        const int count = next - offset;
+        if (type == Type::IntArray)
+        {
+            XPLMSetDatavi(handle, intScratch.data(), offset, count);
+        }
+        else
+        {
+            XPLMSetDatavf(handle, floatScratch.data(), offset, count);
+        }
+        ++stats.sdkCalls;
+        stats.elements += static_cast<std::uint64_t>(count);
+    }
+}
+
+void DataRefWriteBatch::flush()
+{
+    if (pendingWrites.empty())
+    {
+        return;
+    }
+
+    // Writes made by callbacks during the flush to datarefs already applied
+    // go to the next batch
+    flushing.swap(pendingWrites);
+
+    // By index: a callback writing a new dataref reserves more room in flushing
+    for (std::size_t k = 0; k < flushing.size(); ++k)
+    {
+        Write& write = writes[flushing[k]];
+        write.dirty = false;
+        switch (write.type)
+        {
+        case Type::Int:
+            XPLMSetDatai(write.handle, static_cast<int>(write.value));
+            ++stats.sdkCalls;
+            break;
+        case Type::Float:
+            XPLMSetDataf(write.handle, static_cast<float>(write.value));
+            ++stats.sdkCalls;
+            break;
+        case Type::Double:
+            XPLMSetDatad(write.handle, write.value);
+            ++stats.sdkCalls;
+            break;
+        case Type::IntArray:
+        case Type::FloatArray:
+            // Apply a moved-out copy in case a callback records more elements
+            elementScratch.swap(write.elements);
+            flushArray(write.handle, write.type, elementScratch);
+            elementScratch.clear();
+            if (write.elements.empty())
+            {
+                elementScratch.swap(write.elements); // Keep the capacity with the entry
+            }
+            break;
+        }
+    }
+    flushing.clear();
+    ++stats.flushes;
+}
+
+void DataRefWriteBatch::clear()
+{
+    for (const std::size_t id : pendingWrites)
+    {
+        writes[id].dirty = false;
+        writes[id].elements.clear();
+    }
+    pendingWrites.clear();
+}
+
+void DataRefWriteBatch::enableFlightLoop(XPLMFlightLoopPhaseType phase)
+{
+    flightLoop.start(
+        [](void* self, float) { static_cast<DataRefWriteBatch*>(self)->flush(); }, this, phase);
+}
+
+void DataRefWriteBatch::disableFlightLoop()
+{
+    flightLoop.stop();
+}
+
+} // namespace XPlaneUtilities
@@ -0,0 +1,419 @@
+#include <XPlaneUtilities/DerivedMetrics.h>
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMProcessing.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace XPlaneUtilities
+{
+
+DerivedMetrics::~DerivedMetrics()
+{
+    disableFlightLoop();
+}
+
+//==========================================================================
+// Building the graph
+//==========================================================================
+
+int DerivedMetrics::addNode(Node node, const std::vector<int>& inputs)
+{
+    if (find(node.name) >= 0)
+    {
+        XPlaneLog::warn("Derived metric '" + node.name + "' already exists, ignoring");
+        return -1;
+    }
+
+    // Inputs must already exist, which keeps the table in topological order
+    for (int input : inputs)
+    {
+        if (input < 0 || static_cast<std::size_t>(input) >= nodes.size())
+        {
+            XPlaneLog::warn("Derived metric '" + node.name + "' uses an unknown input, ignoring");
+            return -1;
+        }
+    }
+
+    node.firstInput = inputIds.size();
+    node.inputCount = inputs.size();
+    inputIds.insert(inputIds.end(), inputs.begin(), inputs.end());
+    if (inputs.size() > scratch.size())
+    {
+        scratch.resize(inputs.size());
+    }
+
+    nodes.push_back(std::move(node));
+    values.push_back(0.0);
+    changedFlags.push_back(0);
+    return static_cast<int>(nodes.size() - 1);
+}
+
+int DerivedMetrics::addDataRef(const std::string& name, const std::string& datarefName)
+{
+    Node node;
+    node.name = name;
+    node.kind = Kind::DataRef;
+    if (!node.dataRef.find(datarefName, "metric '" + name + "' skipped"))
+    {
+        return -1;
+    }
+
+    return addNode(std::move(node), {});
+}
+
+int DerivedMetrics::addInput(const std::string& name, std::function<double()> source)
+{
+    if (!source)
+    {
+        return -1;
+    }
+
+    Node node;
+    node.name = name;
+    node.kind = Kind::Input;
+    node.source = std::move(source);
+    return addNode(std::move(node), {});
+}
+
+int DerivedMetrics::addFormula(const std::string& name, const std::vector<int>& inputs,
+                               Formula formula)
+{
+    if (!formula)
+    {
+        return -1;
+    }
+
+    Node node;
+    node.name = name;
+    node.kind = Kind::Formula;
+    node.formula = std::move(formula);
+    return addNode(std::move(node), inputs);
+}
+
+int DerivedMetrics::addStatistic(const std::string& name, Kind kind, int input, double parameter)
+{
+    Node node;
+    node.name = name;
+    node.kind = kind;
+    node.parameter = parameter;
+    return addNode(std::move(node), {input});
+}
+
+int DerivedMetrics::addRate(const std::string& name, int input)
+{
+    return addStatistic(name, Kind::Rate, input, 0.0);
+}
+
+int DerivedMetrics::addIntegral(const std::string& name, int input)
+{
+    return addStatistic(name, Kind::Integral, input, 0.0);
+}
+
+int DerivedMetrics::addEma(const std::string& name, int input, double timeConstant)
+{
+    return addStatistic(name, Kind::Ema, input, timeConstant);
+}
+
+int DerivedMetrics::addRollingMean(const std::string& name, int input, double windowSeconds)
+{
+    return addStatistic(name, Kind::RollingMean, input, windowSeconds);
+}
+
+int DerivedMetrics::addRollingMin(const std::string& name, int input, double windowSeconds)
+{
+    return addStatistic(name, Kind::RollingMin, input, windowSeconds);
+}
+
+int DerivedMetrics::addRollingMax(const std::string& name, int input, double windowSeconds)
+{
+    return addStatistic(name, Kind::RollingMax, input, windowSeconds);
+}
+
+void DerivedMetrics::addFlightData(FlightDataProvider& provider)
+{
+    FlightDataProvider* p = &provider;
+    const int fuel = addInput("fuel", [p]() { return p->getFuelOnBoard(); });
+    addInput("zulu_time", [p]() { return p->getZuluTimeSec(); });
+    const int groundSpeed = addInput("groundspeed", [p]() { return p->getGroundSpeed(); });
+    addInput("latitude", [p]() { return p->getLatitude(); });
+    addInput("longitude", [p]() { return p->getLongitude(); });
+    addInput("airspeed", [p]() { return p->getIndicatedAirspeed(); });
+    addInput("elevation", [p]() { return p->getElevation(); });
+
+    // Burn is the negative fuel rate; refuelling reads as zero flow
+    const int fuelRate = addRate("fuel_rate", fuel);
+    const int burn = addFormula("fuel_burn", {fuelRate},
+                                [](const double* in) { return in[0] < 0.0 ? -in[0] : 0.0; });
+    const int fuelFlow = addEma("fuel_flow", burn, 30.0);
+    const int averageSpeed = addRollingMean("groundspeed_avg", groundSpeed, 60.0);
+    addIntegral("distance_flown", groundSpeed);
+
+    const int timeToEmpty = addFormula("time_to_empty", {fuel, fuelFlow}, [](const double* in) {
+        return in[1] > 1e-6 ? in[0] / in[1] : std::numeric_limits<double>::infinity();
+    });
+    addFormula("range_remaining", {timeToEmpty, averageSpeed},
+               [](const double* in) { return in[1] > 0.0 ? in[0] * in[1] : 0.0; });
+}
+
+bool DerivedMetrics::exportNode(int node, const std::string& datarefName)
+{
+    if (node < 0 || static_cast<std::size_t>(node) >= nodes.size())
+    {
+        return false;
+    }
+
+    auto exported = std::make_unique<DataRefExport<double>>(
+        datarefName, this,
+        [node](void* ref) { return static_cast<DerivedMetrics*>(ref)->get(node); },
+        xplmType_Float | xplmType_Double);
+    if (!exported->isValid())
+    {
+        XPlaneLog::warn("Could not export metric '" + nodes[node].name + "' as " + datarefName);
+        return false;
+    }
+
+    exports.push_back(std::move(exported));
+    return true;
+}
+
+//==========================================================================
+// Evaluation
+//==========================================================================
+
+void DerivedMetrics::Samples::push_back(double time, double value)
+{
+    if (count == slots.size())
+    {
+        // Unroll into a larger vector, oldest first
+        std::vector<std::pair<double, double>> larger;
+        larger.reserve(std::max<std::size_t>(16, slots.size() * 2));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            larger.push_back(slots[(head + i) % slots.size()]);
+        }
+        larger.resize(larger.capacity());
+        slots.swap(larger);
+        head = 0;
+    }
+    slots[(head + count) % slots.size()] = {time, value};
+    ++count;
+}
+
+double DerivedMetrics::rolling(Node& node, double value)
+{
+    const double horizon = clock - node.parameter;
+
+    if (node.kind == Kind::RollingMean)
+    {
+        node.window.push_back(clock, value);
+        node.sum += value;
+        while (node.window.size() > 1 && node.window.front().first <= horizon)
+        {
+            node.sum -= node.window.front().second;
+            node.window.pop_front();
+        }
+        return node.sum / static_cast<double>(node.window.size());
+    }
+
+    // Monotonic queue: the front is the extreme, later entries are the
+    // candidates once it expires
+    const bool isMin = node.kind == Kind::RollingMin;
+    while (!node.monotonic.empty() &&
+           (isMin ? node.monotonic.back().second >= value : node.monotonic.back().second <= value))
+    {
+        node.monotonic.pop_back();
+    }
+    node.monotonic.push_back(clock, value);
+    while (node.monotonic.front().first <= horizon && node.monotonic.size() > 1)
+    {
+        node.monotonic.pop_front();
+    }
+    return node.monotonic.front().second;
+}
+
+double DerivedMetrics::evaluate(Node& node, std::size_t index, double dt)
+{
+    const double current = values[index];
+    const double input = node.inputCount ? values[inputIds[node.firstInput]] : 0.0;
+
+    switch (node.kind)
+    {
+    case Kind::DataRef:
+        return node.dataRef.read();
+    case Kind::Input:
+        return node.source();
+    case Kind::Formula:
+        for (std::size_t i = 0; i < node.inputCount; ++i)
+        {
+            scratch[i] = values[inputIds[node.firstInput + i]];
+        }
+        return node.formula(scratch.data());
+    case Kind::Rate:
+    {
+        if (!node.primed)
+        {
+            node.primed = true;
+            node.previous = input;
+            return 0.0;
+        }
+        const double rate = dt > 0.0 ? (input - node.previous) / dt : current;
+        node.previous = input;
+        return rate;
+    }
+    case Kind::Integral:
+    {
+        // Trapezoidal rule
+        const double previous = node.primed ? node.previous : input;
+        node.primed = true;
+        node.previous = input;
+        return current + 0.5 * (previous + input) * dt;
+    }
+    case Kind::Ema:
+    {
+        if (!node.primed)
+        {
+            node.primed = true;
+            return input;
+        }
+        const double alpha = node.parameter > 0.0 ? 1.0 - std::exp(-dt / node.parameter) : 1.0;
+        return current + alpha * (input - current);
+    }
+    case Kind::RollingMean:
+    case Kind::RollingMin:
+    case Kind::RollingMax:
+        return rolling(node, input);
+    }
+    return current;
+}
+
+void DerivedMetrics::update(double dt)
+{
+    if (dt < 0.0)
+    {
+        dt = 0.0;
+    }
+    clock += dt;
+    ++stats.updates;
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        Node& node = nodes[i];
+
+        // Formulas are pure: skip them unless an input changed
+        if (node.kind == Kind::Formula && !evaluateAll)
+        {
+            bool dirty = false;
+            for (std::size_t k = 0; k < node.inputCount && !dirty; ++k)
+            {
+                dirty = changedFlags[inputIds[node.firstInput + k]] != 0;
+            }
+            if (!dirty)
+            {
+                changedFlags[i] = 0;
+                ++stats.skipped;
+                continue;
+            }
+        }
+
+        const double value = evaluate(node, i, dt);
+        ++stats.evaluations;
+        changedFlags[i] = evaluateAll || value != values[i];
+        values[i] = value;
+    }
+    evaluateAll = false;
+}
+
+void DerivedMetrics::reset()
+{
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        Node& node = nodes[i];
+        node.primed = false;
+        node.previous = 0.0;
+        node.sum = 0.0;
+        node.window.clear();
+        node.monotonic.clear();
+        values[i] = 0.0;
+    }
+    clock = 0.0;
+    evaluateAll = true;
+}
+
+void DerivedMetrics::enableFlightLoop()
+{
+    if (!simTime.handle)
+    {
+        simTime.find("sim/time/total_running_time_sec", "using wall time");
+    }
+    lastSimTime = -1.0;
+    flightLoop.start([](void* self, float elapsed)
+                     { static_cast<DerivedMetrics*>(self)->flightLoopUpdate(elapsed); },
+                     this);
+}
+
+void DerivedMetrics::disableFlightLoop()
+{
+    flightLoop.stop();
+}
+
+void DerivedMetrics::flightLoopUpdate(float elapsed)
+{
+    if (!simTime.handle)
+    {
+        update(elapsed);
+        return;
+    }
+
+    // Sim time stands still while paused; it also jumps back when a new
+    // flight is loaded, which only restarts the measurement
+    const double now = simTime.read();
+    const bool first = lastSimTime < 0.0;
+    const double dt = now - lastSimTime;
+    lastSimTime = now;
+    if (first)
+    {
+        update(0.0);
+    }
+    else if (dt > 0.0)
+    {
+        update(dt);
+    }
+}
+
+//==========================================================================
+// Queries
+//==========================================================================
+
+double DerivedMetrics::get(int node) const
+{
+    return node >= 0 && static_cast<std::size_t>(node) < values.size() ? values[node] : 0.0;
+}
+
+bool DerivedMetrics::changed(int node) const
+{
+    return node >= 0 && static_cast<std::size_t>(node) < changedFlags.size() &&
+           changedFlags[node] != 0;
+}
+
+int DerivedMetrics::find(const std::string& name) const
+{
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (nodes[i].name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::string DerivedMetrics::name(int node) const
+{
+    return node >= 0 && static_cast<std::size_t>(node) < nodes.size() ? nodes[node].name
+                                                                       : std::string();
+}
+
+} // namespace XPlaneUtilities
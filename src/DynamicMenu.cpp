@@ -0,0 +1,284 @@
+#include <XPlaneUtilities/DynamicMenu.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <limits>
+#include <map>
+
+namespace
+{
+// Longest part of a title shown in a page label
+constexpr std::size_t kLabelTitleLength = 20;
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+std::string shorten(const std::string& title)
+{
+    return title.size() > kLabelTitleLength ? title.substr(0, kLabelTitleLength) + "..." : title;
+}
+
+std::string placeholderTitle(std::size_t count)
+{
+    return "Show " + std::to_string(count) + (count == 1 ? " item" : " items");
+}
+} // namespace
+
+DynamicMenu::DynamicMenu(MenuItem& parent, const std::string& title, Source source,
+                         OnSelect onSelect, Bucketing bucketing, std::size_t pageSize)
+    : source(std::move(source)), onSelect(std::move(onSelect)), bucketing(bucketing),
+      pageSize(pageSize > 0 ? pageSize : 1)
+{
+    root = parent.addSubMenu(title);
+}
+
+DynamicMenu::~DynamicMenu()
+{
+    // Bucket submenus before the root that contains them, last first
+    while (!buckets.empty())
+    {
+        buckets.pop_back();
+    }
+    root.reset();
+}
+
+void DynamicMenu::assignBuckets(std::vector<Entry>& entries, std::vector<Bucket>& wanted) const
+{
+    if (entries.size() <= pageSize)
+    {
+        // Small enough to live directly in the root menu
+        wanted.emplace_back();
+        wanted.back().entries = std::move(entries);
+        return;
+    }
+
+    if (bucketing == Bucketing::Alphabetical)
+    {
+        std::map<char, std::vector<Entry>> letters;
+        for (Entry& entry : entries)
+        {
+            const unsigned char first = entry.title.empty() ? '#' : entry.title[0];
+            const char letter = std::isalpha(first) ? static_cast<char>(std::toupper(first)) : '#';
+            letters[letter].push_back(std::move(entry));
+        }
+
+        for (auto& [letter, group] : letters)
+        {
+            wanted.emplace_back();
+            wanted.back().label = std::string(1, letter);
+            wanted.back().entries = std::move(group);
+        }
+        return;
+    }
+
+    for (std::size_t begin = 0; begin < entries.size(); begin += pageSize)
+    {
+        const std::size_t end = std::min(begin + pageSize, entries.size());
+        wanted.emplace_back();
+        Bucket& bucket = wanted.back();
+        bucket.label = shorten(entries[begin].title) + " - " + shorten(entries[end - 1].title);
+        bucket.entries.assign(std::make_move_iterator(entries.begin() + begin),
+                              std::make_move_iterator(entries.begin() + end));
+    }
+}
+
+void DynamicMenu::refresh()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    scratch.clear();
+    source(scratch);
+    stats.sourceItems = scratch.size();
+
+    std::vector<Bucket> wanted;
+    assignBuckets(scratch, wanted);
+
+    // Switching between a flat menu and buckets changes every item
+    const bool flat = wanted.size() == 1 && wanted.front().label.empty();
+    const bool wasFlat = buckets.size() == 1 && !buckets.front().menu;
+    std::size_t keep = 0;
+    if (flat == wasFlat)
+    {
+        while (keep < buckets.size() && keep < wanted.size() &&
+               buckets[keep].label == wanted[keep].label)
+        {
+            ++keep;
+        }
+    }
+
+    while (buckets.size() > keep)
+    {
+        Bucket& bucket = buckets.back();
+        if (!bucket.menu)
+        {
+            clearItems(bucket); // Flat items live in the root menu
+        }
+        stats.itemsRemoved += bucket.builtEntries.size();
+        buckets.pop_back();
+    }
+
+    for (std::size_t i = 0; i < wanted.size(); ++i)
+    {
+        if (i >= keep)
+        {
+            buckets.emplace_back();
+            Bucket& bucket = buckets.back();
+            bucket.label = wanted[i].label;
+            if (!flat)
+            {
+                bucket.menu = root->addSubMenu(bucket.label);
+            }
+        }
+
+        Bucket& bucket = buckets[i];
+        bucket.entries = std::move(wanted[i].entries);
+
+        if (flat || !bucket.builtEntries.empty())
+        {
+            // Already visible: diff right away
+            materialize(bucket, std::numeric_limits<std::size_t>::max());
+        }
+        else
+        {
+            bucket.materialized = false;
+            showPlaceholder(bucket);
+        }
+    }
+
+    stats.buckets = flat ? 0 : buckets.size();
+    stats.pendingBuckets = 0;
+    stats.builtItems = 0;
+    for (const Bucket& bucket : buckets)
+    {
+        stats.pendingBuckets += bucket.materialized ? 0 : 1;
+        stats.builtItems += bucket.builtEntries.size();
+    }
+    stats.lastRefreshMs = elapsedMs(start);
+}
+
+bool DynamicMenu::update(std::size_t maxItems)
+{
+    std::size_t budget = maxItems;
+    for (Bucket& bucket : buckets)
+    {
+        if (budget == 0)
+        {
+            break;
+        }
+        if (!bucket.materialized)
+        {
+            budget -= std::min(budget, materialize(bucket, budget));
+        }
+    }
+    return stats.pendingBuckets > 0;
+}
+
+void DynamicMenu::buildAll()
+{
+    update(std::numeric_limits<std::size_t>::max());
+}
+
+void DynamicMenu::showPlaceholder(Bucket& bucket)
+{
+    const std::string title = placeholderTitle(bucket.entries.size());
+    if (bucket.placeholder.isValid())
+    {
+        bucket.placeholder.setTitle(title);
+        return;
+    }
+
+    // Buckets are only ever appended or popped, so the index stays valid
+    const std::size_t index = static_cast<std::size_t>(&bucket - buckets.data());
+    bucket.placeholder = target(bucket).addSubItem(
+        title, [this, index]()
+        { materialize(buckets[index], std::numeric_limits<std::size_t>::max()); });
+}
+
+std::size_t DynamicMenu::materialize(Bucket& bucket, std::size_t maxItems)
+{
+    const auto start = std::chrono::steady_clock::now();
+    MenuItem& menu = target(bucket);
+
+    if (bucket.placeholder.isValid())
+    {
+        bucket.placeholder.remove();
+    }
+
+    // Keep the longest run of items whose keys still match
+    std::size_t same = 0;
+    while (same < bucket.builtEntries.size() && same < bucket.entries.size() &&
+           bucket.builtEntries[same].key == bucket.entries[same].key)
+    {
+        const Entry& wanted = bucket.entries[same];
+        Entry& built = bucket.builtEntries[same];
+        if (built.title != wanted.title)
+        {
+            bucket.items[same].setTitle(wanted.title);
+            built.title = wanted.title;
+            ++stats.itemsUpdated;
+        }
+        if (built.checked != wanted.checked)
+        {
+            bucket.items[same].setChecked(wanted.checked);
+            built.checked = wanted.checked;
+            ++stats.itemsUpdated;
+        }
+        ++same;
+    }
+
+    // XPLM cannot insert, so everything after the first difference is rebuilt
+    while (bucket.items.size() > same)
+    {
+        bucket.items.back().remove();
+        bucket.items.pop_back();
+        bucket.builtEntries.pop_back();
+        --stats.builtItems;
+        ++stats.itemsRemoved;
+    }
+
+    std::size_t appended = 0;
+    while (bucket.builtEntries.size() < bucket.entries.size() && appended < maxItems)
+    {
+        const Entry& entry = bucket.entries[bucket.builtEntries.size()];
+        // onSelect gets a copy: calling refresh() from it may destroy this lambda
+        MenuItem::Item item = menu.addSubItem(entry.title, [this, key = entry.key]()
+                                              { onSelect(std::string(key)); });
+        if (entry.checked)
+        {
+            item.setChecked(true);
+        }
+        bucket.items.push_back(item);
+        bucket.builtEntries.push_back(entry);
+        ++appended;
+    }
+    stats.itemsAppended += appended;
+    stats.builtItems += appended;
+
+    const bool wasMaterialized = bucket.materialized;
+    bucket.materialized = bucket.builtEntries.size() == bucket.entries.size();
+    if (bucket.materialized && !wasMaterialized && stats.pendingBuckets > 0)
+    {
+        --stats.pendingBuckets;
+    }
+
+    stats.lastBuildMs = elapsedMs(start);
+    return appended;
+}
+
+void DynamicMenu::clearItems(Bucket& bucket)
+{
+    while (!bucket.items.empty())
+    {
+        bucket.items.back().remove();
+        bucket.items.pop_back();
+    }
+    bucket.builtEntries.clear();
+    if (bucket.placeholder.isValid())
+    {
+        bucket.placeholder.remove();
+    }
+}
@@ -0,0 +1,265 @@
+#include <XPlaneUtilities/FlightDataFormat.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace XPlaneUtilities
+{
+namespace FlightDataFormat
+{
+
+namespace
+{
+constexpr char kDigitPairs[] = "00010203040506070809"
+                               "10111213141516171819"
+                               "20212223242526272829"
+                               "30313233343536373839"
+                               "40414243444546474849"
+                               "50515253545556575859"
+                               "60616263646566676869"
+                               "70717273747576777879"
+                               "80818283848586878889"
+                               "90919293949596979899";
+
+constexpr std::uint64_t kPowersOf10[] = {1,         10,         100,        1000,
+                                         10000,     100000,     1000000,    10000000,
+                                         100000000, 1000000000};
+
+// Two digits of value (0-99)
+inline char* writePair(char* p, unsigned value)
+{
+    std::memcpy(p, kDigitPairs + 2 * value, 2);
+    return p + 2;
+}
+
+// Exactly width digits of value, zero-padded
+char* writePadded(char* p, std::uint64_t value, int width)
+{
+    char* end = p + width;
+    char* q = end;
+    while (q - p >= 2)
+    {
+        q -= 2;
+        std::memcpy(q, kDigitPairs + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if (q > p)
+    {
+        *--q = static_cast<char>('0' + value % 10);
+    }
+    return end;
+}
+
+// All digits of value, no padding
+char* writeUnsigned(char* p, std::uint64_t value)
+{
+    int width = 1;
+    for (std::uint64_t v = value; v >= 10; v /= 10)
+    {
+        ++width;
+    }
+    return writePadded(p, value, width);
+}
+
+std::size_t finish(char* out, char* p)
+{
+    *p = '\0';
+    return static_cast<std::size_t>(p - out);
+}
+
+// Whole seconds since midnight, wrapped into one day
+unsigned secondsOfDay(float seconds)
+{
+    if (!(seconds > 0.0f))
+    {
+        return 0;
+    }
+    return static_cast<unsigned>(static_cast<std::uint64_t>(seconds) % 86400);
+}
+
+std::size_t formatDMS(char* out, double degrees, char positive, char negative, int degreeDigits)
+{
+    if (!std::isfinite(degrees))
+    {
+        degrees = 0.0;
+    }
+
+    char* p = out;
+    *p++ = degrees < 0.0 ? negative : positive;
+
+    // Round once in tenths of a second so 59.96" carries into the minutes
+    const auto tenths = static_cast<std::uint64_t>(std::llround(std::fabs(degrees) * 36000.0));
+    p = writePadded(p, tenths / 36000, degreeDigits);
+    *p++ = ' ';
+    p = writePair(p, static_cast<unsigned>(tenths / 600 % 60));
+    *p++ = ' ';
+    p = writePair(p, static_cast<unsigned>(tenths / 10 % 60));
+    *p++ = '.';
+    *p++ = static_cast<char>('0' + tenths % 10);
+    return finish(out, p);
+}
+
+template<std::size_t Size, typename... Args>
+void append(fmt::memory_buffer& out, std::size_t (*format)(char*, Args...), Args... args)
+{
+    char buffer[Size];
+    out.append(buffer, buffer + format(buffer, args...));
+}
+} // namespace
+
+std::size_t formatTimeHHMM(char* out, float seconds)
+{
+    const unsigned s = secondsOfDay(seconds);
+    char* p = writePair(out, s / 3600);
+    p = writePair(p, s % 3600 / 60);
+    return finish(out, p);
+}
+
+std::size_t formatTimeHHMMSS(char* out, float seconds)
+{
+    const unsigned s = secondsOfDay(seconds);
+    char* p = writePair(out, s / 3600);
+    *p++ = ':';
+    p = writePair(p, s % 3600 / 60);
+    *p++ = ':';
+    p = writePair(p, s % 60);
+    return finish(out, p);
+}
+
+std::size_t formatTimeDDHHMMZ(char* out, int day, float seconds)
+{
+    const unsigned s = secondsOfDay(seconds);
+    char* p = writePair(out, day < 0 ? 0u : static_cast<unsigned>(day) % 100);
+    p = writePair(p, s / 3600);
+    p = writePair(p, s % 3600 / 60);
+    *p++ = 'Z';
+    return finish(out, p);
+}
+
+std::size_t formatLatitudeDMS(char* out, double degrees)
+{
+    return formatDMS(out, degrees, 'N', 'S', 2);
+}
+
+std::size_t formatLongitudeDMS(char* out, double degrees)
+{
+    return formatDMS(out, degrees, 'E', 'W', 3);
+}
+
+std::size_t formatDecimal(char* out, double value, int decimals)
+{
+    decimals = decimals < 0 ? 0 : (decimals > 9 ? 9 : decimals);
+
+    // Keep the scaled value well inside 64 bits
+    const double limit = 1e18 / static_cast<double>(kPowersOf10[decimals]);
+    if (!std::isfinite(value))
+    {
+        value = 0.0;
+    }
+    value = value > limit ? limit : (value < -limit ? -limit : value);
+
+    const std::uint64_t scale = kPowersOf10[decimals];
+    const auto scaled =
+        static_cast<std::uint64_t>(std::llround(std::fabs(value) * static_cast<double>(scale)));
+
+    char* p = out;
+    if (value < 0.0 && scaled != 0)
+    {
+        *p++ = '-';
+    }
+    p = writeUnsigned(p, scaled / scale);
+    if (decimals > 0)
+    {
+        *p++ = '.';
+        p = writePadded(p, scaled % scale, decimals);
+    }
+    return finish(out, p);
+}
+
+std::size_t formatAltitudeFeet(char* out, double feet)
+{
+    if (!std::isfinite(feet))
+    {
+        feet = 0.0;
+    }
+    feet = feet > 1e15 ? 1e15 : (feet < -1e15 ? -1e15 : feet);
+
+    const long long rounded = std::llround(feet);
+    char* p = out;
+    if (rounded < 0)
+    {
+        *p++ = '-';
+    }
+    p = writeUnsigned(p, static_cast<std::uint64_t>(rounded < 0 ? -rounded : rounded));
+    return finish(out, p);
+}
+
+std::size_t formatFlightLevel(char* out, double feet)
+{
+    if (!(feet > 0.0))
+    {
+        feet = 0.0;
+    }
+    feet = feet > 1e15 ? 1e15 : feet;
+
+    const auto level = static_cast<std::uint64_t>(std::llround(feet / 100.0));
+    char* p = out;
+    *p++ = 'F';
+    *p++ = 'L';
+    p = level < 1000 ? writePadded(p, level, 3) : writeUnsigned(p, level);
+    return finish(out, p);
+}
+
+std::size_t formatAltitude(char* out, double feet, double transitionAltitude)
+{
+    return feet >= transitionAltitude ? formatFlightLevel(out, feet) : formatAltitudeFeet(out, feet);
+}
+
+void formatTimeHHMM(fmt::memory_buffer& out, float seconds)
+{
+    append<kTimeHHMMSize>(out, &formatTimeHHMM, seconds);
+}
+
+void formatTimeHHMMSS(fmt::memory_buffer& out, float seconds)
+{
+    append<kTimeHHMMSSSize>(out, &formatTimeHHMMSS, seconds);
+}
+
+void formatTimeDDHHMMZ(fmt::memory_buffer& out, int day, float seconds)
+{
+    append<kTimeDDHHMMZSize>(out, &formatTimeDDHHMMZ, day, seconds);
+}
+
+void formatLatitudeDMS(fmt::memory_buffer& out, double degrees)
+{
+    append<kLatitudeDMSSize>(out, &formatLatitudeDMS, degrees);
+}
+
+void formatLongitudeDMS(fmt::memory_buffer& out, double degrees)
+{
+    append<kLongitudeDMSSize>(out, &formatLongitudeDMS, degrees);
+}
+
+void formatDecimal(fmt::memory_buffer& out, double value, int decimals)
+{
+    append<kDecimalSize>(out, &formatDecimal, value, decimals);
+}
+
+void formatAltitudeFeet(fmt::memory_buffer& out, double feet)
+{
+    append<kAltitudeSize>(out, &formatAltitudeFeet, feet);
+}
+
+void formatFlightLevel(fmt::memory_buffer& out, double feet)
+{
+    append<kAltitudeSize>(out, &formatFlightLevel, feet);
+}
+
+void formatAltitude(fmt::memory_buffer& out, double feet, double transitionAltitude)
+{
+    append<kAltitudeSize>(out, &formatAltitude, feet, transitionAltitude);
+}
+
+} // namespace FlightDataFormat
+} // namespace XPlaneUtilities
@@ -1,32 +1,37 @@
 #include <XPlaneUtilities/FlightDataProvider.h>
-#include <cstdio>
+#include <XPlaneUtilities/StartupProfiler.h>
 
 namespace XPlaneUtilities
 {
 
 FlightDataProvider::FlightDataProvider()
 {
+    StartupProfiler::Scope profile("FlightData", "FlightDataProvider");
+
     // Initialize all dataref imports (AviTab pattern - cache handles on construction)
     // Using defaults of 0 ensures graceful degradation if datarefs are missing
 
-    m_fuelTotal =
-        std::make_unique<DataRefImport<float>>("sim/flightmodel/weight/m_fuel_total", 0.0f);
+    constexpr MemoryComponent memory = MemoryComponent::FlightData;
+
+    m_fuelTotal = makeResourcePtr<DataRefImport<float>>(
+        memory, "sim/flightmodel/weight/m_fuel_total", 0.0f);
 
-    m_zuluTime = std::make_unique<DataRefImport<float>>("sim/time/zulu_time_sec", 0.0f);
+    m_zuluTime = makeResourcePtr<DataRefImport<float>>(memory, "sim/time/zulu_time_sec", 0.0f);
 
-    m_groundSpeed =
-        std::make_unique<DataRefImport<float>>("sim/flightmodel/position/groundspeed", 0.0f);
+    m_groundSpeed = makeResourcePtr<DataRefImport<float>>(
+        memory, "sim/flightmodel/position/groundspeed", 0.0f);
 
-    m_latitude = std::make_unique<DataRefImport<double>>("sim/flightmodel/position/latitude", 0.0);
+    m_latitude = makeResourcePtr<DataRefImport<double>>(
+        memory, "sim/flightmodel/position/latitude", 0.0);
 
-    m_longitude =
-        std::make_unique<DataRefImport<double>>("sim/flightmodel/position/longitude", 0.0);
+    m_longitude = makeResourcePtr<DataRefImport<double>>(
+        memory, "sim/flightmodel/position/longitude", 0.0);
 
-    m_airspeed =
-        std::make_unique<DataRefImport<float>>("sim/flightmodel/position/indicated_airspeed", 0.0f);
+    m_airspeed = makeResourcePtr<DataRefImport<float>>(
+        memory, "sim/flightmodel/position/indicated_airspeed", 0.0f);
 
-    m_elevation =
-        std::make_unique<DataRefImport<double>>("sim/flightmodel/position/elevation", 0.0);
+    m_elevation = makeResourcePtr<DataRefImport<double>>(
+        memory, "sim/flightmodel/position/elevation", 0.0);
 }
 
 //==========================================================================
@@ -74,13 +79,8 @@ double FlightDataProvider::getElevation()
 
 std::string FlightDataProvider::formatTimeHHMM(float seconds)
 {
-    int totalSeconds = static_cast<int>(seconds);
-    int hours = (totalSeconds / 3600) % 24;
-    int minutes = (totalSeconds % 3600) / 60;
-
-    char buffer[5];
-    snprintf(buffer, sizeof(buffer), "%02d%02d", hours, minutes);
-    return std::string(buffer);
+    char buffer[FlightDataFormat::kTimeHHMMSize];
+    return std::string(buffer, FlightDataFormat::formatTimeHHMM(buffer, seconds));
 }
 
 std::string FlightDataProvider::getZuluTimeFormatted()
@@ -89,4 +89,14 @@ std::string FlightDataProvider::getZuluTimeFormatted()
     return formatTimeHHMM(seconds);
 }
 
+std::size_t FlightDataProvider::getZuluTimeFormatted(char* out)
+{
+    return FlightDataFormat::formatTimeHHMM(out, getZuluTimeSec());
+}
+
+void FlightDataProvider::getZuluTimeFormatted(fmt::memory_buffer& out)
+{
+    FlightDataFormat::formatTimeHHMM(out, getZuluTimeSec());
+}
+
 } // namespace XPlaneUtilities
@@ -0,0 +1,42 @@
+#include <XPlaneUtilities/FlightLoop.h>
+
+namespace XPlaneUtilities
+{
+
+void FlightLoop::start(Callback cb, void* ref, XPLMFlightLoopPhaseType phase)
+{
+    if (id)
+    {
+        return;
+    }
+
+    callback = cb;
+    refcon = ref;
+
+    XPLMCreateFlightLoop_t params;
+    params.structSize = sizeof(params);
+    params.phase = phase;
+    params.callbackFunc = &FlightLoop::dispatch;
+    params.refcon = this;
+
+    id = XPLMCreateFlightLoop(&params);
+    XPLMScheduleFlightLoop(id, -1.0f, 1);
+}
+
+void FlightLoop::stop()
+{
+    if (id)
+    {
+        XPLMDestroyFlightLoop(id);
+        id = nullptr;
+    }
+}
+
+float FlightLoop::dispatch(float elapsedSinceLastCall, float, int, void* refcon)
+{
+    auto self = static_cast<FlightLoop*>(refcon);
+    self->callback(self->refcon, elapsedSinceLastCall);
+    return -1.0f; // Every frame
+}
+
+} // namespace XPlaneUtilities
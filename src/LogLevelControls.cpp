@@ -0,0 +1,110 @@
+#include <XPlaneUtilities/LogLevelControls.h>
+#include <XPlaneUtilities/MenuHandler.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+namespace XPlaneUtilities
+{
+
+LogLevelControls::LogLevelControls(const std::string& datarefPrefix) : prefix(datarefPrefix)
+{
+}
+
+LogLevelControls::~LogLevelControls()
+{
+    // Menus first: their callbacks refer to the controls
+    menus.clear();
+    controls.clear();
+}
+
+bool LogLevelControls::add(const std::string& subsystem)
+{
+    for (const auto& control : controls)
+    {
+        if (control->subsystem == subsystem)
+        {
+            return true;
+        }
+    }
+
+    auto control = std::make_unique<Control>();
+    control->subsystem = subsystem;
+    control->logger = XPlaneLog::getLogger(subsystem);
+
+    const std::string name = prefix + "/" + subsystem;
+    control->dataRef = std::make_unique<DataRefExport<int>>(
+        name, control.get(),
+        [](void* ref)
+        { return static_cast<int>(XPlaneLog::getLevel(*static_cast<Control*>(ref)->logger)); },
+        [](void* ref, int level) { applyLevel(*static_cast<Control*>(ref), level); });
+
+    if (!control->dataRef->isValid())
+    {
+        XPlaneLog::error("Failed to export log level dataref: " + name);
+        return false;
+    }
+
+    controls.push_back(std::move(control));
+    return true;
+}
+
+void LogLevelControls::addAll()
+{
+    for (const auto& subsystem : XPlaneLog::getSubsystems())
+    {
+        add(subsystem);
+    }
+}
+
+void LogLevelControls::buildMenu(MenuItem& parent)
+{
+    auto levelsMenu = parent.addSubMenu("Log Levels");
+
+    for (const auto& control : controls)
+    {
+        auto subsystemMenu = levelsMenu->addSubMenu(control->subsystem);
+        for (int level = spdlog::level::trace; level <= spdlog::level::off; ++level)
+        {
+            const auto name =
+                spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(level));
+            Control* target = control.get();
+            subsystemMenu->addSubItem(std::string(name.data(), name.size()),
+                                      [target, level]() { applyLevel(*target, level); });
+        }
+        menus.push_back(std::move(subsystemMenu));
+    }
+
+    menus.push_back(std::move(levelsMenu));
+}
+
+bool LogLevelControls::setLevel(const std::string& subsystem, spdlog::level::level_enum level)
+{
+    for (const auto& control : controls)
+    {
+        if (control->subsystem == subsystem)
+        {
+            applyLevel(*control, level);
+            return true;
+        }
+    }
+    return false;
+}
+
+void LogLevelControls::applyLevel(Control& control, int level)
+{
+    if (level < spdlog::level::trace || level > spdlog::level::off)
+    {
+        XPlaneLog::warn("Ignoring invalid log level " + std::to_string(level) + " for " +
+                        control.subsystem);
+        return;
+    }
+
+    const auto newLevel = static_cast<spdlog::level::level_enum>(level);
+    if (XPlaneLog::getLevel(*control.logger) != newLevel)
+    {
+        XPlaneLog::setLevel(*control.logger, newLevel);
+        XPlaneLog::info("Log level for " + control.subsystem + " set to " +
+                        std::string(spdlog::level::to_string_view(newLevel).data()));
+    }
+}
+
+} // namespace XPlaneUtilities
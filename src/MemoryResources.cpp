@@ -0,0 +1,243 @@
+#include <XPlaneUtilities/MemoryResources.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <fmt/format.h>
+
+namespace XPlaneUtilities
+{
+
+//==========================================================================
+// CountingResource
+//==========================================================================
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream)
+    : upstreamResource(upstream)
+{
+}
+
+CountingResource::Stats CountingResource::getStats() const
+{
+    Stats stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.deallocations = deallocations.load(std::memory_order_relaxed);
+    stats.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+    stats.bytesInUse = bytesInUse.load(std::memory_order_relaxed);
+    stats.peakBytesInUse = peakBytesInUse.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CountingResource::resetStats()
+{
+    allocations.store(0, std::memory_order_relaxed);
+    deallocations.store(0, std::memory_order_relaxed);
+    bytesAllocated.store(0, std::memory_order_relaxed);
+    peakBytesInUse.store(bytesInUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* p = upstreamResource->allocate(bytes, alignment);
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+    const std::uint64_t inUse = bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::uint64_t peak = peakBytesInUse.load(std::memory_order_relaxed);
+    while (inUse > peak &&
+           !peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+    {
+    }
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    upstreamResource->deallocate(p, bytes, alignment);
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    bytesInUse.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+//==========================================================================
+// SetupArena
+//==========================================================================
+
+SetupArena::SetupArena(std::size_t initialSize, std::pmr::memory_resource* upstream)
+    : arena(initialSize, upstream)
+{
+}
+
+std::size_t SetupArena::bytesAllocated() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocated;
+}
+
+void SetupArena::release()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    arena.release();
+    allocated = 0;
+}
+
+void* SetupArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    void* p = arena.allocate(bytes, alignment);
+    allocated += bytes;
+    return p;
+}
+
+void SetupArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // Monotonic: memory comes back with release()
+}
+
+bool SetupArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+//==========================================================================
+// MemoryResources
+//==========================================================================
+
+namespace
+{
+constexpr std::size_t kComponents = static_cast<std::size_t>(MemoryComponent::Count);
+
+// nullptr means std::pmr::get_default_resource()
+std::atomic<std::pmr::memory_resource*> current[kComponents] = {};
+
+// Guarded by configMutex
+std::mutex configMutex;
+std::pmr::memory_resource* configured[kComponents] = {};
+// Never deleted: objects allocated through a counter free their memory
+// through it, possibly after accounting was switched off or at static
+// destruction
+CountingResource* counters[kComponents] = {};
+bool accounting = false;
+
+std::pmr::memory_resource* orDefault(std::pmr::memory_resource* resource)
+{
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+void install(std::size_t index)
+{
+    std::pmr::memory_resource* resource = configured[index];
+    if (accounting)
+    {
+        if (!counters[index] || counters[index]->upstream() != orDefault(resource))
+        {
+            counters[index] = new CountingResource(orDefault(resource));
+        }
+        resource = counters[index];
+    }
+    current[index].store(resource, std::memory_order_release);
+}
+} // namespace
+
+std::pmr::memory_resource* MemoryResources::get(MemoryComponent component)
+{
+    return orDefault(current[static_cast<std::size_t>(component)].load(std::memory_order_acquire));
+}
+
+void MemoryResources::set(MemoryComponent component, std::pmr::memory_resource* resource)
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    const std::size_t index = static_cast<std::size_t>(component);
+    configured[index] = resource;
+    install(index);
+}
+
+void MemoryResources::setAll(std::pmr::memory_resource* resource)
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    for (std::size_t i = 0; i < kComponents; ++i)
+    {
+        configured[i] = resource;
+        install(i);
+    }
+}
+
+const char* MemoryResources::name(MemoryComponent component)
+{
+    switch (component)
+    {
+    case MemoryComponent::DataRefs:
+        return "DataRefs";
+    case MemoryComponent::Menus:
+        return "Menus";
+    case MemoryComponent::Logging:
+        return "Logging";
+    case MemoryComponent::FlightData:
+        return "FlightData";
+    case MemoryComponent::Count:
+        break;
+    }
+    return "Unknown";
+}
+
+void MemoryResources::enableAccounting()
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    accounting = true;
+    for (std::size_t i = 0; i < kComponents; ++i)
+    {
+        install(i);
+    }
+}
+
+void MemoryResources::disableAccounting()
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    accounting = false;
+    for (std::size_t i = 0; i < kComponents; ++i)
+    {
+        install(i);
+    }
+}
+
+bool MemoryResources::isAccounting()
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    return accounting;
+}
+
+CountingResource::Stats MemoryResources::getStats(MemoryComponent component)
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    const CountingResource* counter = counters[static_cast<std::size_t>(component)];
+    return counter ? counter->getStats() : CountingResource::Stats();
+}
+
+void MemoryResources::resetStats()
+{
+    std::lock_guard<std::mutex> lock(configMutex);
+    for (CountingResource* counter : counters)
+    {
+        if (counter)
+        {
+            counter->resetStats();
+        }
+    }
+}
+
+void MemoryResources::logStats()
+{
+    for (std::size_t i = 0; i < kComponents; ++i)
+    {
+        const MemoryComponent component = static_cast<MemoryComponent>(i);
+        const CountingResource::Stats stats = getStats(component);
+        XPlaneLog::info(fmt::format(
+            "Memory {}: {} allocations ({} bytes), {} frees, {} bytes in use, peak {}",
+            name(component), stats.allocations, stats.bytesAllocated, stats.deallocations,
+            stats.bytesInUse, stats.peakBytesInUse));
+    }
+}
+
+} // namespace XPlaneUtilities
@@ -1,10 +1,14 @@
 #include <XPLMDisplay.h>
 #include <XPLMMenus.h>
 #include <XPlaneUtilities/MenuHandler.h>
+#include <XPlaneUtilities/StartupProfiler.h>
 #include <stdexcept>
 
 MenuItem::MenuItem(const std::string& title)
+    : m_entries(XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Menus)),
+      m_free_ids(m_entries.get_allocator())
 {
+    XPlaneUtilities::StartupProfiler::Scope profile("Menus", title);
     m_parent_menu = XPLMFindPluginsMenu();
     m_item_id = XPLMAppendMenuItem(m_parent_menu, title.c_str(), nullptr, 0);
 
@@ -22,69 +26,312 @@ MenuItem::MenuItem(const std::string& title)
     }
 }
 
-MenuItem::MenuItem(const std::string& title, XPLMMenuID parent_menu, int item_idx)
+MenuItem::MenuItem(const std::string& title, MenuItem& parent)
+    : m_entries(XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Menus)),
+      m_free_ids(m_entries.get_allocator())
 {
-    m_parent_menu = parent_menu;
-    m_item_id = XPLMAppendMenuItem(parent_menu, title.c_str(), nullptr, 0);
+    XPlaneUtilities::StartupProfiler::Scope profile("Menus", title);
+    m_parent = &parent;
+    m_parent_menu = parent.m_menu_id;
+    m_entry_id = parent.appendEntry(title, nullptr);
 
-    if (m_item_id < 0)
+    if (m_entry_id < 0)
     {
         throw std::runtime_error("Couldn't create submenu item: " + title);
     }
+    m_item_id = parent.m_entries[m_entry_id].position;
 
-    m_menu_id = XPLMCreateMenu(title.c_str(), parent_menu, m_item_id, menuHandler, this);
+    m_menu_id = XPLMCreateMenu(title.c_str(), m_parent_menu, m_item_id, menuHandler, this);
 
     if (!m_menu_id)
     {
-        XPLMRemoveMenuItem(parent_menu, m_item_id);
+        parent.removeEntry(m_entry_id);
         throw std::runtime_error("Couldn't create submenu: " + title);
     }
+    parent.m_entries[m_entry_id].submenu = this;
 }
 
 MenuItem::~MenuItem()
 {
+    // An action of ours may be destroying us; tell menuHandler not to touch us
+    if (m_dispatch_alive)
+    {
+        *m_dispatch_alive = false;
+    }
+
+    // Submenus may outlive us; they must not reach back into this object
+    for (Entry& entry : m_entries)
+    {
+        if (entry.submenu)
+        {
+            entry.submenu->detach();
+            entry.submenu = nullptr;
+        }
+    }
+
     if (m_menu_id)
     {
         XPLMDestroyMenu(m_menu_id);
         m_menu_id = nullptr;
     }
 
-    if (m_item_id >= 0 && m_parent_menu)
+    if (m_parent)
+    {
+        // Let the parent shift the positions of the entries after ours
+        m_parent->removeEntry(m_entry_id);
+    }
+    else if (m_item_id >= 0 && m_parent_menu)
     {
         XPLMRemoveMenuItem(m_parent_menu, m_item_id);
         m_item_id = -1;
     }
 }
 
-void MenuItem::addSubItem(const std::string& title, std::function<void()> action)
+MenuItem::Item MenuItem::addSubItem(const std::string& title, std::function<void()> action)
+{
+    const int id = appendEntry(title, std::move(action));
+    return id >= 0 ? Item(this, id, m_entries[id].generation) : Item();
+}
+
+MenuItem::Item MenuItem::addCommandItem(const std::string& title, XPLMCommandRef command)
 {
-    m_callbacks.push_back(action);
-    intptr_t idx = m_callbacks.size() - 1;
-    XPLMAppendMenuItem(m_menu_id, title.c_str(), reinterpret_cast<void*>(idx), 0);
+    const int id = command ? appendEntry(title, nullptr, command) : -1;
+    return id >= 0 ? Item(this, id, m_entries[id].generation) : Item();
 }
 
 std::unique_ptr<MenuItem> MenuItem::addSubMenu(const std::string& title)
 {
-    auto submenu = std::unique_ptr<MenuItem>(new MenuItem(title, m_menu_id, m_item_id));
+    auto submenu = std::unique_ptr<MenuItem>(new MenuItem(title, *this));
     return submenu;
 }
 
 void MenuItem::addSeparator()
 {
+    if (!m_menu_id)
+    {
+        return;
+    }
+
     XPLMAppendMenuSeparator(m_menu_id);
+
+    // Separators take an item index, so they get an entry to keep positions right
+    Entry& entry = m_entries.emplace_back();
+    entry.position = m_item_count++;
+    entry.enabled = false;
+}
+
+int MenuItem::appendEntry(const std::string& title, std::function<void()> action,
+                          XPLMCommandRef command)
+{
+    XPlaneUtilities::StartupProfiler::Scope profile("Menus", title);
+    if (!m_menu_id)
+    {
+        return -1; // Detached from a destroyed parent
+    }
+
+    // Reuse a removed entry so menus that are refreshed often do not grow
+    const bool reuse = !m_free_ids.empty();
+    const int id = reuse ? m_free_ids.back() : static_cast<int>(m_entries.size());
+    const int position =
+        command ? XPLMAppendMenuItemWithCommand(m_menu_id, title.c_str(), command)
+                : XPLMAppendMenuItem(m_menu_id, title.c_str(),
+                                     reinterpret_cast<void*>(static_cast<intptr_t>(id)), 0);
+    if (position < 0)
+    {
+        return -1;
+    }
+
+    if (reuse)
+    {
+        m_free_ids.pop_back();
+    }
+    else
+    {
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[id];
+    const unsigned generation = entry.generation + 1;
+    entry = Entry(); // Keeps the title's allocator
+    entry.action = std::move(action);
+    entry.title = title;
+    entry.position = position;
+    entry.generation = generation;
+    m_item_count = position + 1;
+    return id;
+}
+
+void MenuItem::removeEntry(int id)
+{
+    Entry* entry = findEntry(id);
+    if (!entry)
+    {
+        return;
+    }
+
+    const int position = entry->position;
+    if (m_menu_id)
+    {
+        XPLMRemoveMenuItem(m_menu_id, position);
+    }
+
+    // X-Plane shifts every later item down by one
+    for (Entry& other : m_entries)
+    {
+        if (other.position > position)
+        {
+            --other.position;
+        }
+    }
+    --m_item_count;
+
+    entry->position = -1;
+    entry->title.clear();
+    entry->submenu = nullptr;
+    if (m_dispatching == id)
+    {
+        m_release_pending = true; // Still running; released by menuHandler
+    }
+    else
+    {
+        entry->action = nullptr;
+        m_free_ids.push_back(id);
+    }
+}
+
+void MenuItem::detach()
+{
+    for (Entry& entry : m_entries)
+    {
+        if (entry.submenu)
+        {
+            entry.submenu->detach();
+            entry.submenu = nullptr;
+        }
+        entry.position = -1; // Invalidates every Item handle
+    }
+    m_item_count = 0;
+
+    // X-Plane removes the item that opened us together with our parent's menu
+    if (m_menu_id)
+    {
+        XPLMDestroyMenu(m_menu_id);
+        m_menu_id = nullptr;
+    }
+    m_parent = nullptr;
+    m_parent_menu = nullptr;
+    m_item_id = -1;
+    m_entry_id = -1;
+}
+
+MenuItem::Entry* MenuItem::findEntry(int id)
+{
+    if (id < 0 || id >= static_cast<int>(m_entries.size()) || m_entries[id].position < 0)
+    {
+        return nullptr;
+    }
+    return &m_entries[id];
+}
+
+MenuItem::Entry* MenuItem::findEntry(const Item& item)
+{
+    Entry* entry = findEntry(item.m_id);
+    return entry && entry->generation == item.m_generation ? entry : nullptr;
 }
 
 void MenuItem::menuHandler(void* menuRef, void* itemRef)
 {
     MenuItem* menu = static_cast<MenuItem*>(menuRef);
-    auto idx = reinterpret_cast<intptr_t>(itemRef);
+    const auto id = static_cast<int>(reinterpret_cast<intptr_t>(itemRef));
 
-    if (idx >= 0 && idx < static_cast<intptr_t>(menu->m_callbacks.size()))
+    Entry* entry = menu->findEntry(id);
+    if (entry && entry->action)
     {
-        std::function<void()> callback = menu->m_callbacks[idx];
-        if (callback)
+        // Call in place: entries live in a deque, so appends cannot move it
+        bool alive = true;
+        menu->m_dispatch_alive = &alive;
+        menu->m_dispatching = id;
+        entry->action();
+        if (!alive)
+        {
+            return; // The action destroyed this menu, e.g. DynamicMenu::refresh()
+        }
+        menu->m_dispatch_alive = nullptr;
+        menu->m_dispatching = -1;
+
+        if (menu->m_release_pending)
         {
-            callback();
+            menu->m_entries[id].action = nullptr;
+            menu->m_free_ids.push_back(id);
+            menu->m_release_pending = false;
         }
     }
-}
\ No newline at end of file
+}
+
+//==========================================================================
+// MenuItem::Item
+//==========================================================================
+
+bool MenuItem::Item::isValid() const
+{
+    return m_menu && m_menu->findEntry(*this) != nullptr;
+}
+
+void MenuItem::Item::setChecked(bool checked)
+{
+    Entry* entry = m_menu ? m_menu->findEntry(*this) : nullptr;
+    if (!entry || (entry->checkable && entry->checked == checked))
+    {
+        return; // Unchanged state costs no SDK call
+    }
+
+    XPLMCheckMenuItem(m_menu->m_menu_id, entry->position,
+                      checked ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    entry->checked = checked;
+    entry->checkable = true;
+}
+
+bool MenuItem::Item::isChecked() const
+{
+    const Entry* entry = m_menu ? m_menu->findEntry(*this) : nullptr;
+    return entry && entry->checked;
+}
+
+void MenuItem::Item::setEnabled(bool enabled)
+{
+    Entry* entry = m_menu ? m_menu->findEntry(*this) : nullptr;
+    if (!entry || entry->enabled == enabled)
+    {
+        return;
+    }
+
+    XPLMEnableMenuItem(m_menu->m_menu_id, entry->position, enabled ? 1 : 0);
+    entry->enabled = enabled;
+}
+
+void MenuItem::Item::setTitle(const std::string& title)
+{
+    setTitle(title.c_str());
+}
+
+void MenuItem::Item::setTitle(const char* title)
+{
+    Entry* entry = m_menu ? m_menu->findEntry(*this) : nullptr;
+    if (!entry || entry->title.compare(title) == 0)
+    {
+        return;
+    }
+
+    XPLMSetMenuItemName(m_menu->m_menu_id, entry->position, title, 0);
+    entry->title = title;
+}
+
+void MenuItem::Item::remove()
+{
+    if (m_menu && m_menu->findEntry(*this))
+    {
+        m_menu->removeEntry(m_id);
+    }
+    m_menu = nullptr;
+    m_id = -1;
+}
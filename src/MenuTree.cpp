@@ -0,0 +1,205 @@
+#include <XPLMMenus.h>
+#include <XPlaneUtilities/MenuTree.h>
+#include <stdexcept>
+
+MenuSpec MenuSpec::item(std::string title, std::function<void()> action, std::string id)
+{
+    MenuSpec spec;
+    spec.kind = Kind::Item;
+    spec.title = std::move(title);
+    spec.action = std::move(action);
+    spec.id = std::move(id);
+    return spec;
+}
+
+MenuSpec MenuSpec::commandItem(std::string title, XPLMCommandRef command, std::string id)
+{
+    MenuSpec spec;
+    spec.kind = Kind::Command;
+    spec.title = std::move(title);
+    spec.command = command;
+    spec.id = std::move(id);
+    return spec;
+}
+
+MenuSpec MenuSpec::submenu(std::string title, std::vector<MenuSpec> children, std::string id)
+{
+    MenuSpec spec;
+    spec.kind = Kind::Submenu;
+    spec.title = std::move(title);
+    spec.children = std::move(children);
+    spec.id = std::move(id);
+    return spec;
+}
+
+MenuSpec MenuSpec::separator()
+{
+    MenuSpec spec;
+    spec.kind = Kind::Separator;
+    return spec;
+}
+
+MenuTree::~MenuTree()
+{
+    clear();
+}
+
+std::size_t MenuTree::countNodes(const MenuSpec& spec)
+{
+    std::size_t count = 1;
+    for (const MenuSpec& child : spec.children)
+    {
+        count += countNodes(child);
+    }
+    return count;
+}
+
+void MenuTree::build(MenuSpec root, XPLMMenuID parent)
+{
+    clear();
+
+    if (root.kind != MenuSpec::Kind::Submenu)
+    {
+        throw std::runtime_error("MenuTree root must be a submenu: " + root.title);
+    }
+
+    // One allocation for the whole tree; node addresses never change after this
+    nodes.reserve(countNodes(root));
+
+    try
+    {
+        createNode(root, parent ? parent : XPLMFindPluginsMenu());
+    }
+    catch (...)
+    {
+        clear();
+        throw;
+    }
+}
+
+void MenuTree::createNode(MenuSpec& spec, XPLMMenuID container)
+{
+    const int index = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+    Node& node = nodes.back();
+    node.container = container;
+
+    if (spec.kind == MenuSpec::Kind::Separator)
+    {
+        XPLMAppendMenuSeparator(container);
+        return;
+    }
+
+    node.position =
+        spec.kind == MenuSpec::Kind::Command
+            ? XPLMAppendMenuItemWithCommand(container, spec.title.c_str(), spec.command)
+            : XPLMAppendMenuItem(container, spec.title.c_str(),
+                                 reinterpret_cast<void*>(static_cast<intptr_t>(index)), 0);
+    if (node.position < 0)
+    {
+        throw std::runtime_error("Couldn't create menu item: " + spec.title);
+    }
+
+    if (!spec.id.empty())
+    {
+        ids[spec.id] = index;
+    }
+    if (!spec.enabled)
+    {
+        XPLMEnableMenuItem(container, node.position, 0);
+    }
+
+    if (spec.kind != MenuSpec::Kind::Submenu)
+    {
+        node.action = std::move(spec.action);
+        if (spec.checked)
+        {
+            XPLMCheckMenuItem(container, node.position, xplm_Menu_Checked);
+        }
+        return;
+    }
+
+    node.menu = XPLMCreateMenu(spec.title.c_str(), container, node.position, menuHandler, this);
+    if (!node.menu)
+    {
+        throw std::runtime_error("Couldn't create submenu: " + spec.title);
+    }
+
+    const XPLMMenuID menu = node.menu; // node may not be used after recursing
+    for (MenuSpec& child : spec.children)
+    {
+        createNode(child, menu);
+    }
+}
+
+void MenuTree::clear()
+{
+    if (nodes.empty())
+    {
+        return;
+    }
+
+    // Children were created after their parents, so walk backwards
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+    {
+        if (it->menu)
+        {
+            XPLMDestroyMenu(it->menu);
+        }
+    }
+
+    const Node& root = nodes.front();
+    if (root.position >= 0)
+    {
+        XPLMRemoveMenuItem(root.container, root.position);
+    }
+
+    nodes.clear();
+    ids.clear();
+}
+
+int MenuTree::find(const std::string& id) const
+{
+    auto it = ids.find(id);
+    return it != ids.end() ? it->second : -1;
+}
+
+void MenuTree::setChecked(int node, bool checked)
+{
+    if (node >= 0 && node < static_cast<int>(nodes.size()) && nodes[node].position >= 0)
+    {
+        XPLMCheckMenuItem(nodes[node].container, nodes[node].position,
+                          checked ? xplm_Menu_Checked : xplm_Menu_Unchecked);
+    }
+}
+
+void MenuTree::setEnabled(int node, bool enabled)
+{
+    if (node >= 0 && node < static_cast<int>(nodes.size()) && nodes[node].position >= 0)
+    {
+        XPLMEnableMenuItem(nodes[node].container, nodes[node].position, enabled ? 1 : 0);
+    }
+}
+
+void MenuTree::setTitle(int node, const std::string& title)
+{
+    if (node >= 0 && node < static_cast<int>(nodes.size()) && nodes[node].position >= 0)
+    {
+        XPLMSetMenuItemName(nodes[node].container, nodes[node].position, title.c_str(), 0);
+    }
+}
+
+void MenuTree::menuHandler(void* menuRef, void* itemRef)
+{
+    MenuTree* tree = static_cast<MenuTree*>(menuRef);
+    const auto index = reinterpret_cast<intptr_t>(itemRef);
+
+    if (index >= 0 && index < static_cast<intptr_t>(tree->nodes.size()))
+    {
+        const std::function<void()>& action = tree->nodes[index].action;
+        if (action)
+        {
+            action();
+        }
+    }
+}
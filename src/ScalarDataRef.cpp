@@ -0,0 +1,39 @@
+#include <XPlaneUtilities/ScalarDataRef.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+namespace XPlaneUtilities
+{
+
+bool ScalarDataRef::find(const std::string& name, const std::string& skipped)
+{
+    handle = XPLMFindDataRef(name.c_str());
+    if (!handle)
+    {
+        XPlaneLog::warn("DataRef '" + name + "' not available, " + skipped);
+        return false;
+    }
+
+    // Prefer the widest native type so no precision is lost
+    const XPLMDataTypeID types = XPLMGetDataRefTypes(handle);
+    if (types & xplmType_Double)
+    {
+        type = xplmType_Double;
+    }
+    else if (types & xplmType_Float)
+    {
+        type = xplmType_Float;
+    }
+    else if (types & xplmType_Int)
+    {
+        type = xplmType_Int;
+    }
+    else
+    {
+        XPlaneLog::warn("DataRef '" + name + "' is not a scalar, " + skipped);
+        handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+} // namespace XPlaneUtilities
@@ -0,0 +1,242 @@
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/SharedTelemetryPublisher.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMProcessing.h>
+#include <cerrno>
+#include <cstring>
+#include <fmt/format.h>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>    // For O_CREAT, O_EXCL and O_RDWR
+#include <sys/mman.h> // For shm_open, shm_unlink and mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For ftruncate and close
+#endif
+
+namespace XPlaneUtilities
+{
+
+SharedTelemetryPublisher::SharedTelemetryPublisher(const std::string& name)
+    : shmName((!name.empty() && name[0] == '/') ? name : "/" + name)
+{
+}
+
+SharedTelemetryPublisher::~SharedTelemetryPublisher()
+{
+    disableFlightLoop();
+    close();
+}
+
+bool SharedTelemetryPublisher::canAddChannel(const std::string& name) const
+{
+    if (header)
+    {
+        XPlaneLog::warn("Telemetry channel '" + name + "' added after open(), ignoring");
+        return false;
+    }
+
+    if (name.size() >= kSharedTelemetryNameLength)
+    {
+        XPlaneLog::warn("Telemetry channel name '" + name + "' is too long, ignoring");
+        return false;
+    }
+
+    return true;
+}
+
+bool SharedTelemetryPublisher::addDataRef(const std::string& name)
+{
+    if (!canAddChannel(name))
+    {
+        return false;
+    }
+
+    ScalarDataRef dataRef;
+    if (!dataRef.find(name, "telemetry channel skipped"))
+    {
+        return false;
+    }
+
+    channels.push_back({name, dataRef, nullptr});
+    return true;
+}
+
+bool SharedTelemetryPublisher::addChannel(const std::string& name, std::function<double()> source)
+{
+    if (!canAddChannel(name) || !source)
+    {
+        return false;
+    }
+
+    channels.push_back({name, ScalarDataRef(), std::move(source)});
+    return true;
+}
+
+void SharedTelemetryPublisher::addFlightData(FlightDataProvider& provider)
+{
+    FlightDataProvider* p = &provider;
+    addChannel("sim/flightmodel/weight/m_fuel_total", [p]() { return p->getFuelOnBoard(); });
+    addChannel("sim/time/zulu_time_sec", [p]() { return p->getZuluTimeSec(); });
+    addChannel("sim/flightmodel/position/groundspeed", [p]() { return p->getGroundSpeed(); });
+    addChannel("sim/flightmodel/position/latitude", [p]() { return p->getLatitude(); });
+    addChannel("sim/flightmodel/position/longitude", [p]() { return p->getLongitude(); });
+    addChannel("sim/flightmodel/position/indicated_airspeed",
+               [p]() { return p->getIndicatedAirspeed(); });
+    addChannel("sim/flightmodel/position/elevation", [p]() { return p->getElevation(); });
+}
+
+bool SharedTelemetryPublisher::open()
+{
+    if (header)
+    {
+        return true;
+    }
+
+#ifdef _WIN32
+    XPlaneLog::error("Shared-memory telemetry is only supported on POSIX platforms");
+    return false;
+#else
+    const auto count = static_cast<std::uint32_t>(channels.size());
+    const std::size_t size = sharedTelemetrySize(count);
+
+    // Never resize or clear an existing segment: readers still mapping it
+    // would fault on the truncated pages or see a torn layout. A segment left
+    // behind by an earlier run is unlinked instead (its readers keep their
+    // mapping and reopen by name) and a fresh one is created exclusively.
+    shm_unlink(shmName.c_str());
+    int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+    {
+        XPlaneLog::error(fmt::format("shm_open('{}') failed: {}", shmName, std::strerror(errno)));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        XPlaneLog::error(fmt::format("ftruncate('{}') failed: {}", shmName, std::strerror(errno)));
+        ::close(fd);
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        XPlaneLog::error(fmt::format("mmap('{}') failed: {}", shmName, std::strerror(errno)));
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    segmentDevice = static_cast<std::uint64_t>(st.st_dev);
+    segmentInode = static_cast<std::uint64_t>(st.st_ino);
+    std::memset(addr, 0, size);
+
+    // Names are written before the magic so a reader never sees a half-built segment
+    char* names = static_cast<char*>(addr) + sharedTelemetryNamesOffset();
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        std::memcpy(names + i * kSharedTelemetryNameLength, channels[i].name.c_str(),
+                    channels[i].name.size());
+    }
+
+    header = new (addr) SharedTelemetryHeader{};
+    header->version = kSharedTelemetryVersion;
+    header->channelCount = count;
+    header->nameLength = static_cast<std::uint32_t>(kSharedTelemetryNameLength);
+    header->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kSharedTelemetryMagic;
+
+    mapping = addr;
+    mappingSize = size;
+    values = reinterpret_cast<double*>(static_cast<char*>(addr) +
+                                       sharedTelemetryValuesOffset(count));
+    scratch.resize(count);
+
+    XPlaneLog::info(fmt::format("Telemetry segment '{}' opened with {} channels", shmName, count));
+    return true;
+#endif
+}
+
+void SharedTelemetryPublisher::close()
+{
+#ifndef _WIN32
+    if (mapping)
+    {
+        munmap(mapping, mappingSize);
+        if (ownsName())
+        {
+            shm_unlink(shmName.c_str());
+        }
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    values = nullptr;
+}
+
+bool SharedTelemetryPublisher::ownsName() const
+{
+#ifdef _WIN32
+    return false;
+#else
+    // Another publisher may have replaced the segment under the same name since
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    const bool same = fstat(fd, &st) == 0 &&
+                      static_cast<std::uint64_t>(st.st_dev) == segmentDevice &&
+                      static_cast<std::uint64_t>(st.st_ino) == segmentInode;
+    ::close(fd);
+    return same;
+#endif
+}
+
+void SharedTelemetryPublisher::publish()
+{
+    if (!header)
+    {
+        return;
+    }
+
+    // Sample outside the critical section so readers retry as little as possible
+    for (std::size_t i = 0; i < channels.size(); ++i)
+    {
+        const Channel& channel = channels[i];
+        scratch[i] = channel.custom ? channel.custom() : channel.dataRef.read();
+    }
+
+    const float now = XPLMGetElapsedTime();
+    const std::uint64_t seq = header->sequence.load(std::memory_order_relaxed);
+
+    header->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header->frame = ++frame;
+    header->publishTime = now;
+    std::memcpy(values, scratch.data(), scratch.size() * sizeof(double));
+
+    header->sequence.store(seq + 2, std::memory_order_release);
+}
+
+void SharedTelemetryPublisher::enableFlightLoop()
+{
+    flightLoop.start(
+        [](void* self, float) { static_cast<SharedTelemetryPublisher*>(self)->publish(); }, this);
+}
+
+void SharedTelemetryPublisher::disableFlightLoop()
+{
+    flightLoop.stop();
+}
+
+} // namespace XPlaneUtilities
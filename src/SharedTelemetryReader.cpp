@@ -0,0 +1,152 @@
+#include <XPlaneUtilities/SharedTelemetry.h>
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>    // For O_RDONLY
+#include <sys/mman.h> // For shm_open and mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#endif
+
+namespace XPlaneUtilities
+{
+
+SharedTelemetryReader::~SharedTelemetryReader()
+{
+    close();
+}
+
+bool SharedTelemetryReader::open(const std::string& name)
+{
+    close();
+
+#ifdef _WIN32
+    (void)name;
+    return false;
+#else
+    std::string shmName = (!name.empty() && name[0] == '/') ? name : "/" + name;
+
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(SharedTelemetryHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return false;
+    }
+
+    auto hdr = static_cast<const SharedTelemetryHeader*>(addr);
+    if (hdr->magic != kSharedTelemetryMagic || hdr->version != kSharedTelemetryVersion ||
+        hdr->nameLength != kSharedTelemetryNameLength ||
+        size < sharedTelemetrySize(hdr->channelCount))
+    {
+        munmap(addr, size);
+        return false;
+    }
+
+    mapping = addr;
+    mappingSize = size;
+    header = hdr;
+    names = static_cast<const char*>(addr) + sharedTelemetryNamesOffset();
+    values = reinterpret_cast<const double*>(static_cast<const char*>(addr) +
+                                             sharedTelemetryValuesOffset(hdr->channelCount));
+    return true;
+#endif
+}
+
+void SharedTelemetryReader::close()
+{
+#ifndef _WIN32
+    if (mapping)
+    {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    names = nullptr;
+    values = nullptr;
+}
+
+std::uint32_t SharedTelemetryReader::channelCount() const
+{
+    return header ? header->channelCount : 0;
+}
+
+std::string SharedTelemetryReader::channelName(std::uint32_t index) const
+{
+    if (!header || index >= header->channelCount)
+    {
+        return std::string();
+    }
+
+    const char* entry = names + index * kSharedTelemetryNameLength;
+    return std::string(entry, strnlen(entry, kSharedTelemetryNameLength));
+}
+
+int SharedTelemetryReader::find(const std::string& name) const
+{
+    for (std::uint32_t i = 0; i < channelCount(); ++i)
+    {
+        const char* entry = names + i * kSharedTelemetryNameLength;
+        if (name.size() < kSharedTelemetryNameLength &&
+            std::strncmp(entry, name.c_str(), kSharedTelemetryNameLength) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool SharedTelemetryReader::read(SharedTelemetrySnapshot& out, int maxRetries) const
+{
+    if (!header)
+    {
+        return false;
+    }
+
+    const std::uint32_t count = header->channelCount;
+    out.values.resize(count);
+
+    for (int attempt = 0; attempt < maxRetries; ++attempt)
+    {
+        std::uint64_t before = header->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            continue; // Writer in progress
+        }
+
+        out.frame = header->frame;
+        out.publishTime = header->publishTime;
+        std::memcpy(out.values.data(), values, count * sizeof(double));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) == before)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint64_t SharedTelemetryReader::sequence() const
+{
+    return header ? header->sequence.load(std::memory_order_acquire) : 0;
+}
+
+} // namespace XPlaneUtilities
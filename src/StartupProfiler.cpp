@@ -0,0 +1,256 @@
+#include <XPlaneUtilities/StartupProfiler.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string_view>
+
+namespace XPlaneUtilities
+{
+namespace
+{
+struct Event
+{
+    const char* component;
+    std::string name;
+    std::int64_t start;    // Nanoseconds since the trace origin
+    std::int64_t duration; // Nanoseconds
+    unsigned thread;
+    bool outermost; // No enclosing scope of the same component
+};
+
+std::atomic<bool> enabled{false};
+std::atomic<unsigned> nextThread{1};
+
+std::mutex eventsMutex;
+std::vector<Event> events;
+std::int64_t origin = 0;
+bool hasOrigin = false;
+
+// Components with an open scope on this thread, innermost last
+thread_local std::vector<const char*> openComponents;
+
+std::int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Small sequential ids read better in trace viewers than native thread ids
+unsigned threadIndex()
+{
+    thread_local const unsigned index = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void appendJsonString(fmt::memory_buffer& out, std::string_view text)
+{
+    out.push_back('"');
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            fmt::format_to(std::back_inserter(out), "\\\"");
+            break;
+        case '\\':
+            fmt::format_to(std::back_inserter(out), "\\\\");
+            break;
+        case '\n':
+            fmt::format_to(std::back_inserter(out), "\\n");
+            break;
+        case '\t':
+            fmt::format_to(std::back_inserter(out), "\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                fmt::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<int>(c));
+            }
+            else
+            {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+} // namespace
+
+//==========================================================================
+// Scope
+//==========================================================================
+
+StartupProfiler::Scope::Scope(const char* component, const char* name) : component(component)
+{
+    if (enabled.load(std::memory_order_relaxed))
+    {
+        this->name = name;
+        begin();
+    }
+}
+
+StartupProfiler::Scope::Scope(const char* component, const std::string& name)
+    : component(component)
+{
+    if (enabled.load(std::memory_order_relaxed))
+    {
+        this->name = name;
+        begin();
+    }
+}
+
+void StartupProfiler::Scope::begin()
+{
+    outermost = std::none_of(openComponents.begin(), openComponents.end(),
+                             [this](const char* open) { return std::strcmp(open, component) == 0; });
+    openComponents.push_back(component);
+    active = true;
+    start = now();
+}
+
+StartupProfiler::Scope::~Scope()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    const std::int64_t end = now();
+    openComponents.pop_back();
+
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    if (enabled.load(std::memory_order_relaxed))
+    {
+        events.push_back(
+            {component, std::move(name), start - origin, end - start, threadIndex(), outermost});
+    }
+}
+
+//==========================================================================
+// Recording
+//==========================================================================
+
+void StartupProfiler::enable()
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    if (!hasOrigin)
+    {
+        origin = now();
+        hasOrigin = true;
+    }
+    enabled.store(true);
+}
+
+void StartupProfiler::disable()
+{
+    enabled.store(false);
+}
+
+bool StartupProfiler::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void StartupProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    events.clear();
+}
+
+std::size_t StartupProfiler::eventCount()
+{
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    return events.size();
+}
+
+std::vector<StartupProfiler::ComponentTotal> StartupProfiler::getTotals()
+{
+    std::vector<ComponentTotal> totals;
+    std::lock_guard<std::mutex> lock(eventsMutex);
+    for (const Event& event : events)
+    {
+        auto it = std::find_if(totals.begin(), totals.end(), [&event](const ComponentTotal& t)
+                               { return t.component == event.component; });
+        if (it == totals.end())
+        {
+            totals.push_back({event.component, 0.0, 0});
+            it = totals.end() - 1;
+        }
+
+        ++it->events;
+        if (event.outermost)
+        {
+            it->milliseconds += static_cast<double>(event.duration) / 1e6;
+        }
+    }
+    return totals;
+}
+
+//==========================================================================
+// Output
+//==========================================================================
+
+bool StartupProfiler::writeTrace(const std::string& path)
+{
+    const std::vector<ComponentTotal> totals = getTotals();
+
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    std::size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        for (const Event& event : events)
+        {
+            // Complete ("X") events in microseconds; viewers nest them by time
+            fmt::format_to(std::back_inserter(out), "{}\n{{\"name\":", count ? "," : "");
+            appendJsonString(out, event.name);
+            fmt::format_to(std::back_inserter(out), ",\"cat\":");
+            appendJsonString(out, event.component);
+            fmt::format_to(std::back_inserter(out),
+                           ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                           static_cast<double>(event.start) / 1e3,
+                           static_cast<double>(event.duration) / 1e3, event.thread);
+            ++count;
+        }
+    }
+
+    fmt::format_to(std::back_inserter(out), "\n],\"otherData\":{{");
+    for (std::size_t i = 0; i < totals.size(); ++i)
+    {
+        fmt::format_to(std::back_inserter(out), "{}", i ? "," : "");
+        appendJsonString(out, totals[i].component);
+        fmt::format_to(std::back_inserter(out), ":\"{:.3f} ms in {} scopes\"",
+                       totals[i].milliseconds, totals[i].events);
+    }
+    fmt::format_to(std::back_inserter(out), "}}}}\n");
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file)
+    {
+        XPlaneLog::warn("Cannot write startup trace to " + path);
+        return false;
+    }
+
+    XPlaneLog::info(fmt::format("Startup trace with {} events written to {}", count, path));
+    return true;
+}
+
+void StartupProfiler::logSummary()
+{
+    for (const ComponentTotal& total : getTotals())
+    {
+        XPlaneLog::info(fmt::format("Startup {}: {:.2f} ms in {} scopes", total.component,
+                                    total.milliseconds, total.events));
+    }
+}
+
+} // namespace XPlaneUtilities
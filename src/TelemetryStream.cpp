@@ -0,0 +1,332 @@
+#include <XPlaneUtilities/TelemetryStream.h>
+
+#include <cstring>
+
+namespace XPlaneUtilities
+{
+namespace TelemetryStream
+{
+
+std::size_t writeVarint(std::vector<std::uint8_t>& out, std::uint64_t v)
+{
+    std::size_t written = 0;
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+        ++written;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+    return written + 1;
+}
+
+bool readVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v)
+{
+    v = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        std::uint8_t byte = *p++;
+        v |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace TelemetryStream
+
+namespace
+{
+// Magic, version, type plus worst-case sequence, timestamp and entry count varints
+constexpr std::size_t kMaxHeaderSize = 4 + 5 + 10 + 5;
+
+// Worst-case size of one value entry: channel delta and zigzag value varints
+constexpr std::size_t kMaxValueEntrySize = 5 + 10;
+
+void writeDouble(std::vector<std::uint8_t>& out, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i)
+    {
+        out.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+    }
+}
+
+bool readDouble(const std::uint8_t*& p, const std::uint8_t* end, double& value)
+{
+    if (end - p < 8)
+    {
+        return false;
+    }
+
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        bits |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    }
+    p += 8;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+} // namespace
+
+//==========================================================================
+// TelemetryFrameEncoder
+//==========================================================================
+
+TelemetryFrameEncoder::TelemetryFrameEncoder(std::size_t channelCount, std::size_t mtu)
+    : mtu(mtu < kMaxHeaderSize + kMaxValueEntrySize ? kMaxHeaderSize + kMaxValueEntrySize : mtu),
+      lastSent(channelCount, 0)
+{
+    body.reserve(this->mtu);
+}
+
+void TelemetryFrameEncoder::beginFrame(TelemetryStream::FrameType type)
+{
+    frameType = type;
+    body.clear();
+    bodyEntries = 0;
+    lastChannel = 0;
+}
+
+void TelemetryFrameEncoder::flushFrame(std::uint64_t timestampMs,
+                                       std::vector<std::vector<std::uint8_t>>& frames)
+{
+    if (bodyEntries == 0)
+    {
+        return;
+    }
+
+    frames.emplace_back();
+    std::vector<std::uint8_t>& frame = frames.back();
+    frame.reserve(kMaxHeaderSize + body.size());
+    frame.push_back(TelemetryStream::kMagic0);
+    frame.push_back(TelemetryStream::kMagic1);
+    frame.push_back(TelemetryStream::kVersion);
+    frame.push_back(static_cast<std::uint8_t>(frameType));
+    TelemetryStream::writeVarint(frame, sequence++);
+    TelemetryStream::writeVarint(frame, timestampMs);
+    TelemetryStream::writeVarint(frame, bodyEntries);
+    frame.insert(frame.end(), body.begin(), body.end());
+
+    beginFrame(frameType);
+}
+
+void TelemetryFrameEncoder::encodeDelta(const std::vector<TelemetrySample>& changes,
+                                        std::uint64_t timestampMs,
+                                        std::vector<std::vector<std::uint8_t>>& frames)
+{
+    beginFrame(TelemetryStream::FrameType::Delta);
+    for (const TelemetrySample& sample : changes)
+    {
+        if (sample.channel >= lastSent.size())
+        {
+            continue;
+        }
+
+        if (body.size() + kMaxHeaderSize + kMaxValueEntrySize > mtu)
+        {
+            flushFrame(timestampMs, frames);
+        }
+
+        TelemetryStream::writeVarint(body, sample.channel - lastChannel);
+        TelemetryStream::writeVarint(body,
+                                     TelemetryStream::zigzagEncode(sample.value -
+                                                                   lastSent[sample.channel]));
+        lastSent[sample.channel] = sample.value;
+        lastChannel = sample.channel;
+        ++bodyEntries;
+    }
+    flushFrame(timestampMs, frames);
+}
+
+void TelemetryFrameEncoder::encodeKeyframe(std::uint64_t timestampMs,
+                                           std::vector<std::vector<std::uint8_t>>& frames)
+{
+    beginFrame(TelemetryStream::FrameType::Keyframe);
+    for (std::uint32_t channel = 0; channel < lastSent.size(); ++channel)
+    {
+        if (body.size() + kMaxHeaderSize + kMaxValueEntrySize > mtu)
+        {
+            flushFrame(timestampMs, frames);
+        }
+
+        TelemetryStream::writeVarint(body, channel - lastChannel);
+        TelemetryStream::writeVarint(body, TelemetryStream::zigzagEncode(lastSent[channel]));
+        lastChannel = channel;
+        ++bodyEntries;
+    }
+    flushFrame(timestampMs, frames);
+}
+
+void TelemetryFrameEncoder::encodeDescription(const std::vector<std::string>& names,
+                                              const std::vector<double>& resolutions,
+                                              std::uint64_t timestampMs,
+                                              std::vector<std::vector<std::uint8_t>>& frames)
+{
+    beginFrame(TelemetryStream::FrameType::Description);
+    for (std::uint32_t channel = 0; channel < names.size() && channel < resolutions.size();
+         ++channel)
+    {
+        // Names longer than a frame cannot be described and are truncated
+        std::size_t nameLength = names[channel].size();
+        const std::size_t maxName = mtu - kMaxHeaderSize - 5 - 8 - 5;
+        if (nameLength > maxName)
+        {
+            nameLength = maxName;
+        }
+
+        if (body.size() + kMaxHeaderSize + 5 + 8 + 5 + nameLength > mtu)
+        {
+            flushFrame(timestampMs, frames);
+        }
+
+        TelemetryStream::writeVarint(body, channel);
+        writeDouble(body, resolutions[channel]);
+        TelemetryStream::writeVarint(body, nameLength);
+        body.insert(body.end(), names[channel].begin(), names[channel].begin() + nameLength);
+        ++bodyEntries;
+    }
+    flushFrame(timestampMs, frames);
+}
+
+//==========================================================================
+// TelemetryFrameDecoder
+//==========================================================================
+
+void TelemetryFrameDecoder::ensureChannel(std::uint32_t channel)
+{
+    if (channel >= values.size())
+    {
+        values.resize(channel + 1, 0);
+        synced.resize(channel + 1, false);
+        resolutions.resize(channel + 1, 1.0);
+        names.resize(channel + 1);
+    }
+}
+
+bool TelemetryFrameDecoder::decode(const std::uint8_t* data, std::size_t length,
+                                   std::vector<TelemetryUpdate>& updates)
+{
+    const std::uint8_t* p = data;
+    const std::uint8_t* end = data + length;
+
+    if (length < 4 || p[0] != TelemetryStream::kMagic0 || p[1] != TelemetryStream::kMagic1 ||
+        p[2] != TelemetryStream::kVersion)
+    {
+        return false;
+    }
+
+    // Unknown types come from a newer sender; their entries cannot be parsed
+    const auto type = static_cast<TelemetryStream::FrameType>(p[3]);
+    if (type != TelemetryStream::FrameType::Delta && type != TelemetryStream::FrameType::Keyframe &&
+        type != TelemetryStream::FrameType::Description)
+    {
+        return false;
+    }
+    p += 4;
+
+    std::uint64_t seq, timestamp, count;
+    if (!TelemetryStream::readVarint(p, end, seq) ||
+        !TelemetryStream::readVarint(p, end, timestamp) ||
+        !TelemetryStream::readVarint(p, end, count))
+    {
+        return false;
+    }
+
+    // A forward gap means some deltas were lost: values stay stale until the
+    // next keyframe. A frame a little older than the last one was reordered
+    // or duplicated and is dropped; one far older comes from a restarted sender.
+    const auto sequence = static_cast<std::uint32_t>(seq);
+    const auto gap = static_cast<std::int32_t>(sequence - expectedSequence);
+    const bool old = haveSequence && gap < 0 &&
+                     gap >= -static_cast<std::int32_t>(TelemetryStream::kReorderWindow);
+    if (haveSequence && gap != 0 && !old)
+    {
+        lost += gap > 0 ? static_cast<std::uint64_t>(gap) : 0;
+        synced.assign(synced.size(), false);
+    }
+    if (old)
+    {
+        ++stale;
+    }
+    else
+    {
+        haveSequence = true;
+        expectedSequence = sequence + 1;
+        timestampMs = timestamp;
+    }
+
+    std::uint32_t channel = 0;
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        if (type == TelemetryStream::FrameType::Description)
+        {
+            std::uint64_t id, nameLength;
+            double resolution;
+            if (!TelemetryStream::readVarint(p, end, id) || id >= TelemetryStream::kMaxChannels ||
+                !readDouble(p, end, resolution) ||
+                !TelemetryStream::readVarint(p, end, nameLength) ||
+                static_cast<std::uint64_t>(end - p) < nameLength)
+            {
+                return false;
+            }
+
+            const auto described = static_cast<std::uint32_t>(id);
+            if (old)
+            {
+                p += nameLength;
+                continue;
+            }
+            ensureChannel(described);
+            resolutions[described] = resolution;
+            names[described].assign(reinterpret_cast<const char*>(p), nameLength);
+            p += nameLength;
+            continue;
+        }
+
+        std::uint64_t idDelta, encoded;
+        if (!TelemetryStream::readVarint(p, end, idDelta) ||
+            idDelta >= TelemetryStream::kMaxChannels - channel ||
+            !TelemetryStream::readVarint(p, end, encoded))
+        {
+            return false;
+        }
+
+        channel += static_cast<std::uint32_t>(idDelta);
+        if (old)
+        {
+            continue;
+        }
+        ensureChannel(channel);
+
+        const std::int64_t value = TelemetryStream::zigzagDecode(encoded);
+        if (type == TelemetryStream::FrameType::Keyframe)
+        {
+            values[channel] = value;
+            synced[channel] = true;
+        }
+        else if (synced[channel])
+        {
+            values[channel] += value;
+        }
+        else
+        {
+            continue;
+        }
+
+        updates.push_back({channel, static_cast<double>(values[channel]) * resolutions[channel]});
+    }
+
+    return true;
+}
+
+std::string TelemetryFrameDecoder::channelName(std::uint32_t channel) const
+{
+    return channel < names.size() ? names[channel] : std::string();
+}
+
+} // namespace XPlaneUtilities
@@ -0,0 +1,419 @@
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/TelemetryStreamer.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMProcessing.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fmt/format.h>
+
+#ifndef _WIN32
+#include <netdb.h>      // For getaddrinfo
+#include <sys/socket.h> // For socket, connect, send and sendmmsg
+#include <sys/types.h>
+#include <sys/uio.h> // For struct iovec
+#include <unistd.h>  // For close
+#endif
+
+namespace XPlaneUtilities
+{
+namespace
+{
+#if defined(__linux__)
+// Frames handed to the kernel per sendmmsg() call
+constexpr std::size_t kSendBatch = 64;
+#endif
+
+// How long the sender sleeps when idle before checking for keyframes
+constexpr auto kSenderIdleWait = std::chrono::milliseconds(100);
+
+// Channel descriptions are repeated every this many keyframes
+constexpr int kDescriptionEveryKeyframes = 10;
+
+// Largest quantised magnitude sent: 2^53 steps are exact in a double, and the
+// difference of two such values cannot overflow a delta
+constexpr double kMaxQuantised = 9007199254740992.0;
+} // namespace
+
+TelemetryStreamer::TelemetryStreamer(const std::string& host, std::uint16_t port, std::size_t mtu)
+    : host(host), port(port), mtu(mtu)
+{
+}
+
+TelemetryStreamer::~TelemetryStreamer()
+{
+    disableFlightLoop();
+    stop();
+}
+
+int TelemetryStreamer::addChannelInternal(Channel channel)
+{
+    if (running)
+    {
+        XPlaneLog::warn("Telemetry channel '" + channel.name + "' added after start(), ignoring");
+        return -1;
+    }
+
+    if (channels.size() >= TelemetryStream::kMaxChannels)
+    {
+        XPlaneLog::warn("Telemetry channel limit reached, '" + channel.name + "' ignored");
+        return -1;
+    }
+
+    channels.push_back(std::move(channel));
+    return static_cast<int>(channels.size() - 1);
+}
+
+int TelemetryStreamer::addDataRef(const std::string& name, double rateHz, double resolution)
+{
+    ScalarDataRef dataRef;
+    if (!dataRef.find(name, "telemetry channel skipped"))
+    {
+        return -1;
+    }
+
+    return addChannelInternal({name, dataRef, nullptr, rateHz > 0.0 ? 1.0 / rateHz : 0.0,
+                               resolution > 0.0 ? resolution : 1.0, 0.0, 0, false});
+}
+
+int TelemetryStreamer::addChannel(const std::string& name, std::function<double()> source,
+                                  double rateHz, double resolution)
+{
+    if (!source)
+    {
+        return -1;
+    }
+
+    return addChannelInternal({name, ScalarDataRef(), std::move(source),
+                               rateHz > 0.0 ? 1.0 / rateHz : 0.0,
+                               resolution > 0.0 ? resolution : 1.0, 0.0, 0, false});
+}
+
+void TelemetryStreamer::addFlightData(FlightDataProvider& provider, double rateHz)
+{
+    FlightDataProvider* p = &provider;
+    addChannel("sim/flightmodel/weight/m_fuel_total", [p]() { return p->getFuelOnBoard(); },
+               rateHz, 0.1);
+    addChannel("sim/time/zulu_time_sec", [p]() { return p->getZuluTimeSec(); }, rateHz, 0.01);
+    addChannel("sim/flightmodel/position/groundspeed", [p]() { return p->getGroundSpeed(); },
+               rateHz, 0.01);
+    addChannel("sim/flightmodel/position/latitude", [p]() { return p->getLatitude(); }, rateHz,
+               1e-7);
+    addChannel("sim/flightmodel/position/longitude", [p]() { return p->getLongitude(); }, rateHz,
+               1e-7);
+    addChannel("sim/flightmodel/position/indicated_airspeed",
+               [p]() { return p->getIndicatedAirspeed(); }, rateHz, 0.01);
+    addChannel("sim/flightmodel/position/elevation", [p]() { return p->getElevation(); }, rateHz,
+               0.01);
+}
+
+bool TelemetryStreamer::start()
+{
+    if (running)
+    {
+        return true;
+    }
+
+#ifdef _WIN32
+    XPlaneLog::error("UDP telemetry streaming is only supported on POSIX platforms");
+    return false;
+#else
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = nullptr;
+    const std::string service = std::to_string(port);
+    int rc = getaddrinfo(host.c_str(), service.c_str(), &hints, &result);
+    if (rc != 0)
+    {
+        XPlaneLog::error(fmt::format("Cannot resolve telemetry host '{}': {}", host,
+                                     gai_strerror(rc)));
+        return false;
+    }
+
+    for (addrinfo* ai = result; ai; ai = ai->ai_next)
+    {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        // Connected UDP socket so sendmmsg() needs no per-message address
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+        {
+            socketFd = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    freeaddrinfo(result);
+
+    if (socketFd < 0)
+    {
+        XPlaneLog::error(fmt::format("Cannot open telemetry socket to {}:{}", host, port));
+        return false;
+    }
+
+    staged.reserve(channels.size());
+    pending.reserve(channels.size());
+
+    running = true;
+    sender = std::thread(&TelemetryStreamer::senderLoop, this);
+
+    XPlaneLog::info(fmt::format("Telemetry streaming {} channels to {}:{}", channels.size(), host,
+                                port));
+    return true;
+#endif
+}
+
+void TelemetryStreamer::stop()
+{
+    if (!running)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
+    }
+    queueCv.notify_one();
+
+    if (sender.joinable())
+    {
+        sender.join();
+    }
+
+#ifndef _WIN32
+    if (socketFd >= 0)
+    {
+        ::close(socketFd);
+    }
+#endif
+    socketFd = -1;
+}
+
+double TelemetryStreamer::readChannel(const Channel& channel) const
+{
+    return channel.custom ? channel.custom() : channel.dataRef.read();
+}
+
+void TelemetryStreamer::sample()
+{
+    if (!running)
+    {
+        return;
+    }
+
+    const double now = XPLMGetElapsedTime();
+
+    staged.clear();
+    for (std::size_t i = 0; i < channels.size(); ++i)
+    {
+        Channel& channel = channels[i];
+        if (channel.interval > 0.0)
+        {
+            if (now < channel.nextDue)
+            {
+                continue;
+            }
+            channel.nextDue = now + channel.interval;
+        }
+
+        // llround() of NaN or of a value beyond 64 bits is unspecified
+        const double scaled = readChannel(channel) / channel.resolution;
+        if (std::isnan(scaled))
+        {
+            continue; // Receivers keep the last value
+        }
+        const auto quantised = static_cast<std::int64_t>(
+            std::llround(std::clamp(scaled, -kMaxQuantised, kMaxQuantised)));
+        if (channel.queued && quantised == channel.lastQueued)
+        {
+            continue;
+        }
+
+        channel.lastQueued = quantised;
+        channel.queued = true;
+        staged.push_back({static_cast<std::uint32_t>(i), quantised});
+    }
+
+    if (staged.empty())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.insert(pending.end(), staged.begin(), staged.end());
+        pendingTimestampMs = static_cast<std::uint64_t>(now * 1000.0);
+    }
+    samplesQueued += staged.size();
+    queueCv.notify_one();
+}
+
+void TelemetryStreamer::senderLoop()
+{
+    TelemetryFrameEncoder encoder(channels.size(), mtu);
+
+    std::vector<std::string> names;
+    std::vector<double> resolutions;
+    for (const Channel& channel : channels)
+    {
+        names.push_back(channel.name);
+        resolutions.push_back(channel.resolution);
+    }
+
+    std::vector<TelemetrySample> batch;
+    batch.reserve(channels.size());
+    std::vector<std::vector<std::uint8_t>> frames;
+
+    auto lastKeyframe = std::chrono::steady_clock::now();
+    int keyframesSinceDescription = kDescriptionEveryKeyframes;
+    bool needKeyframe = true;
+
+    while (true)
+    {
+        std::uint64_t timestampMs;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait_for(lock, kSenderIdleWait,
+                             [this] { return !running || !pending.empty(); });
+            if (!running)
+            {
+                break;
+            }
+            batch.swap(pending);
+            timestampMs = pendingTimestampMs;
+        }
+
+        frames.clear();
+
+        if (!batch.empty())
+        {
+            // Several samples per channel may have queued up: keep the last one
+            std::stable_sort(batch.begin(), batch.end(),
+                             [](const TelemetrySample& a, const TelemetrySample& b)
+                             { return a.channel < b.channel; });
+            std::size_t unique = 0;
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                if (unique > 0 && batch[unique - 1].channel == batch[i].channel)
+                {
+                    batch[unique - 1] = batch[i];
+                }
+                else
+                {
+                    batch[unique++] = batch[i];
+                }
+            }
+            batch.resize(unique);
+
+            encoder.encodeDelta(batch, timestampMs, frames);
+            batch.clear();
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (needKeyframe ||
+            std::chrono::duration<double>(now - lastKeyframe).count() >= keyframeInterval)
+        {
+            if (keyframesSinceDescription >= kDescriptionEveryKeyframes)
+            {
+                encoder.encodeDescription(names, resolutions, timestampMs, frames);
+                keyframesSinceDescription = 0;
+            }
+            encoder.encodeKeyframe(timestampMs, frames);
+            ++keyframesSinceDescription;
+            lastKeyframe = now;
+            needKeyframe = false;
+        }
+
+        sendFrames(frames);
+    }
+}
+
+void TelemetryStreamer::sendFrames(const std::vector<std::vector<std::uint8_t>>& frames)
+{
+#ifndef _WIN32
+    // Only frames the socket accepted count towards bytesSent
+    std::size_t bytes = 0;
+#if defined(__linux__)
+    iovec iov[kSendBatch];
+    mmsghdr msgs[kSendBatch];
+    std::size_t offset = 0;
+    while (offset < frames.size())
+    {
+        const std::size_t count = std::min(kSendBatch, frames.size() - offset);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& frame = frames[offset + i];
+            iov[i].iov_base = const_cast<std::uint8_t*>(frame.data());
+            iov[i].iov_len = frame.size();
+            std::memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent = sendmmsg(socketFd, msgs, static_cast<unsigned int>(count), 0);
+        ++sendCalls;
+        if (sent <= 0)
+        {
+            // Drop the rest of this batch; the next keyframe resynchronises receivers
+            ++sendErrors;
+            break;
+        }
+        for (int i = 0; i < sent; ++i)
+        {
+            bytes += msgs[i].msg_len;
+        }
+        offset += static_cast<std::size_t>(sent);
+        framesSent += static_cast<std::uint64_t>(sent);
+    }
+#else
+    for (const auto& frame : frames)
+    {
+        ++sendCalls;
+        const ssize_t sent = send(socketFd, frame.data(), frame.size(), 0);
+        if (sent < 0)
+        {
+            ++sendErrors;
+            continue;
+        }
+        bytes += static_cast<std::size_t>(sent);
+        ++framesSent;
+    }
+#endif
+    bytesSent += bytes;
+#else
+    (void)frames;
+#endif
+}
+
+TelemetryStreamer::Stats TelemetryStreamer::getStats() const
+{
+    Stats stats;
+    stats.samplesQueued = samplesQueued.load();
+    stats.framesSent = framesSent.load();
+    stats.bytesSent = bytesSent.load();
+    stats.sendCalls = sendCalls.load();
+    stats.sendErrors = sendErrors.load();
+    return stats;
+}
+
+void TelemetryStreamer::enableFlightLoop()
+{
+    flightLoop.start(
+        [](void* self, float) { static_cast<TelemetryStreamer*>(self)->sample(); }, this);
+}
+
+void TelemetryStreamer::disableFlightLoop()
+{
+    flightLoop.stop();
+}
+
+} // namespace XPlaneUtilities
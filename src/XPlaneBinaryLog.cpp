@@ -0,0 +1,243 @@
+#include <XPlaneUtilities/XPlaneBinaryLog.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+// Standard Library Headers
+#include <algorithm> // For std::find
+#include <chrono>    // For timestamps
+#include <cstdio>    // For std::FILE
+#include <memory>    // For std::unique_ptr
+#include <mutex>     // For std::mutex
+
+std::atomic<int> XPlaneBinaryLog::minLevel{spdlog::level::trace};
+std::atomic<bool> XPlaneBinaryLog::fileOpen{false};
+
+namespace
+{
+// Records are appended to the file once a thread buffer reaches this size
+constexpr std::size_t kThreadBufferSize = 64 * 1024;
+
+struct FormatDefinition
+{
+    std::uint8_t level;
+    std::string argTypes;
+    std::string file;
+    std::uint32_t line;
+    std::string format;
+};
+
+struct ThreadBuffer;
+
+// Process-wide state; the mutex guards the file, the format table and the buffer list
+struct BinaryLogState
+{
+    std::mutex mutex;
+    std::FILE* file = nullptr;
+    std::vector<FormatDefinition> formats;
+    std::vector<ThreadBuffer*> buffers;
+    std::uint32_t nextThreadId = 1;
+};
+
+BinaryLogState& state()
+{
+    static BinaryLogState instance;
+    return instance;
+}
+
+// Per-thread record buffer. Its own mutex is only contended while flush()
+// drains buffers of other threads, so the logging thread normally takes it
+// uncontended.
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    std::vector<char> data;
+    std::uint32_t threadId;
+
+    ThreadBuffer()
+    {
+        data.reserve(kThreadBufferSize);
+        std::lock_guard<std::mutex> lock(state().mutex);
+        threadId = state().nextThreadId++;
+        state().buffers.push_back(this);
+    }
+
+    ~ThreadBuffer()
+    {
+        std::lock_guard<std::mutex> lock(state().mutex);
+        {
+            std::lock_guard<std::mutex> bufferLock(mutex);
+            drainLocked();
+        }
+        auto& buffers = state().buffers;
+        buffers.erase(std::find(buffers.begin(), buffers.end(), this));
+    }
+
+    // Caller holds state().mutex and this->mutex
+    void drainLocked()
+    {
+        std::FILE* file = state().file;
+        if (file && !data.empty())
+        {
+            const char kind = XPlaneBinaryLog::kDataRecord;
+            const auto length = static_cast<std::uint32_t>(data.size());
+            std::fwrite(&kind, 1, 1, file);
+            std::fwrite(&threadId, sizeof(threadId), 1, file);
+            std::fwrite(&length, sizeof(length), 1, file);
+            std::fwrite(data.data(), 1, data.size(), file);
+        }
+        data.clear();
+    }
+};
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+// Caller holds state().mutex
+void writeFormatLocked(std::uint32_t id, const FormatDefinition& def)
+{
+    std::FILE* file = state().file;
+    if (!file)
+    {
+        return;
+    }
+
+    const char kind = XPlaneBinaryLog::kFormatRecord;
+    const auto argc = static_cast<std::uint16_t>(def.argTypes.size());
+    const auto fileLength = static_cast<std::uint16_t>(def.file.size());
+    const auto formatLength = static_cast<std::uint32_t>(def.format.size());
+
+    std::fwrite(&kind, 1, 1, file);
+    std::fwrite(&id, sizeof(id), 1, file);
+    std::fwrite(&def.level, sizeof(def.level), 1, file);
+    std::fwrite(&argc, sizeof(argc), 1, file);
+    std::fwrite(def.argTypes.data(), 1, argc, file);
+    std::fwrite(&def.line, sizeof(def.line), 1, file);
+    std::fwrite(&fileLength, sizeof(fileLength), 1, file);
+    std::fwrite(def.file.data(), 1, fileLength, file);
+    std::fwrite(&formatLength, sizeof(formatLength), 1, file);
+    std::fwrite(def.format.data(), 1, formatLength, file);
+}
+} // namespace
+
+void XPlaneBinaryLog::init(const std::string& plugin_name)
+{
+    const std::string path = XPlaneLog::logFilePath(plugin_name, ".binlog");
+    if (open(path))
+    {
+        XPlaneLog::info("Binary log file path: " + path);
+    }
+    else
+    {
+        XPlaneLog::error("Could not open binary log file: " + path);
+    }
+}
+
+bool XPlaneBinaryLog::open(const std::string& path)
+{
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    if (s.file)
+    {
+        std::fclose(s.file);
+        s.file = nullptr;
+    }
+
+    s.file = std::fopen(path.c_str(), "wb");
+    if (!s.file)
+    {
+        fileOpen = false;
+        return false;
+    }
+
+    std::fwrite(&kMagic, sizeof(kMagic), 1, s.file);
+    std::fwrite(&kVersion, sizeof(kVersion), 1, s.file);
+
+    // Call sites registered before open() still need their definitions
+    for (std::uint32_t id = 0; id < s.formats.size(); ++id)
+    {
+        writeFormatLocked(id, s.formats[id]);
+    }
+
+    fileOpen = true;
+    return true;
+}
+
+void XPlaneBinaryLog::flush()
+{
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (ThreadBuffer* buffer : s.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->drainLocked();
+    }
+
+    if (s.file)
+    {
+        std::fflush(s.file);
+    }
+}
+
+void XPlaneBinaryLog::shutdown()
+{
+    flush();
+
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    fileOpen = false;
+    if (s.file)
+    {
+        std::fclose(s.file);
+        s.file = nullptr;
+    }
+}
+
+std::uint32_t XPlaneBinaryLog::registerFormat(spdlog::level::level_enum level, const char* format,
+                                              const char* file, int line, const char* argTypes)
+{
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    const auto id = static_cast<std::uint32_t>(s.formats.size());
+    s.formats.push_back({static_cast<std::uint8_t>(level), argTypes, file,
+                         static_cast<std::uint32_t>(line), format});
+    writeFormatLocked(id, s.formats.back());
+    return id;
+}
+
+std::uint64_t XPlaneBinaryLog::nowNs()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count());
+}
+
+char* XPlaneBinaryLog::reserve(std::size_t size)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.mutex.lock();
+
+    if (buffer.data.size() + size > kThreadBufferSize && !buffer.data.empty())
+    {
+        // Buffer full: hand it to the file. Lock order is state, then buffer.
+        buffer.mutex.unlock();
+        {
+            std::lock_guard<std::mutex> lock(state().mutex);
+            std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+            buffer.drainLocked();
+        }
+        buffer.mutex.lock();
+    }
+
+    const std::size_t offset = buffer.data.size();
+    buffer.data.resize(offset + size);
+    return buffer.data.data() + offset;
+}
+
+void XPlaneBinaryLog::commit()
+{
+    threadBuffer().mutex.unlock();
+}
@@ -1,11 +1,30 @@
 #include <XPlaneUtilities/XPlaneLog.h>
+#include <XPlaneUtilities/MemoryResources.h>
+#include <XPlaneUtilities/StartupProfiler.h>
+#include <XPlaneUtilities/XPlaneBinaryLog.h>
 
 // Standard Library Headers
+#include <algorithm>  // For std::min and std::stable_sort
+#include <csignal>    // For std::signal and std::raise
+#include <cstring>    // For std::memcpy
+#include <ctime>      // For std::time and std::mktime
+#include <exception>  // For std::set_terminate
 #include <filesystem> // For handling file system paths
-#include <memory>     // For std::shared_ptr and std::make_shared
+#include <memory>     // For std::shared_ptr, std::make_shared and std::allocate_shared
 #include <mutex>      // For std::mutex used in custom sink
 #include <string>     // For std::string
 
+// Platform Headers (black box file descriptor and signal handling)
+#ifdef _WIN32
+#include <fcntl.h>    // For _O_* flags
+#include <io.h>       // For _open, _write and _close
+#include <sys/stat.h> // For _S_IREAD and _S_IWRITE
+#else
+#include <fcntl.h>  // For open
+#include <signal.h> // For sigaction
+#include <unistd.h> // For write and close
+#endif
+
 // Third-Party Library Headers
 #include <fmt/format.h>                      // For fmt::to_string and fmt::format_to
 #include <spdlog/details/log_msg.h>          // For spdlog::details::log_msg
@@ -16,12 +35,29 @@
 
 // X-Plane SDK Headers
 #include "XPLMPlugin.h"    // For XPLMGetMyID
+#include "XPLMProcessing.h" // For XPLMCreateFlightLoop
 #include "XPLMUtilities.h" // For XPLMDebugString and XPLMGetPluginInfo
 
 std::shared_ptr<spdlog::logger> XPlaneLog::logger = nullptr;
+std::shared_ptr<XPlaneLog::ThrottleSink> XPlaneLog::throttle = nullptr;
+std::shared_ptr<XPlaneLog::ThreadRingSink> XPlaneLog::threadRings = nullptr;
+std::mutex XPlaneLog::subsystemsMutex;
+std::vector<XPlaneLog::Subsystem> XPlaneLog::subsystems;
+std::string XPlaneLog::logFile;
+std::string XPlaneLog::pluginName;
+std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> XPlaneLog::deferredSink = nullptr;
+void* XPlaneLog::deferredLoop = nullptr;
+std::unique_ptr<XPlaneLog::BlackBox> XPlaneLog::blackBox = nullptr;
+std::atomic<XPlaneLog::BlackBox*> XPlaneLog::activeBlackBox{nullptr};
+std::atomic<int> XPlaneLog::blackBoxLevel{spdlog::level::trace};
 
 // Initialize logger with plugin name
 void XPlaneLog::init(const std::string& plugin_name)
+{
+    init(plugin_name, InitOptions());
+}
+
+void XPlaneLog::init(const std::string& plugin_name, const InitOptions& options)
 {
     // Ensure the logger is not already initialized
     if (logger)
@@ -29,35 +65,37 @@ void XPlaneLog::init(const std::string& plugin_name)
         return;
     }
 
+    XPlaneUtilities::StartupProfiler::Scope profile("XPlaneLog", "init");
+
     // Create an XPlaneLog::Sink instance
     auto xplane_sink = std::make_shared<Sink>();
 
-    // Optionally, create other sinks (e.g., console and file sinks)
-    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-
-    // Determine the plugin's directory
-    char pluginPath[512];
-    XPLMGetPluginInfo(XPLMGetMyID(), nullptr, pluginPath, nullptr, nullptr);
-
-    // Construct the path to Log.txt within the plugin's directory
-    std::filesystem::path path(pluginPath);
-    // std::filesystem::path logFileName = "Log.txt";
-
-    // Sanitize plugin_name to be a valid filename
-    std::string sanitized_plugin_name = plugin_name;
-    std::replace_if(
-        sanitized_plugin_name.begin(), sanitized_plugin_name.end(),
-        [](char c) { return !std::isalnum(c) && c != '_' && c != '+' && c != '-'; }, '_');
-
-    std::filesystem::path logFileName = sanitized_plugin_name + ".log";
-    // Navigate up two levels: from win_x64/ImGuiSimBrief.xpl -> win_x64/ -> ImGuiSimBrief.refactor/
-    std::filesystem::path logFilePath = path.parent_path().parent_path() / logFileName;
-
-    auto file_sink =
-        std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
+    // All sinks sit behind the throttle so a log storm is filtered once, not per sink
+    throttle = std::make_shared<ThrottleSink>();
+    if (options.deferSinks)
+    {
+        // Log.txt only for now; the records also go to a memory buffer that
+        // is replayed into the console and file sinks once they are open
+        pluginName = plugin_name;
+        deferredSink =
+            std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(options.deferredRecords);
+        throttle->set_sinks({deferredSink, xplane_sink});
 
-    spdlog::sinks_init_list sink_list = {console_sink, file_sink, xplane_sink};
-    logger = std::make_shared<spdlog::logger>(plugin_name, sink_list.begin(), sink_list.end());
+        XPLMCreateFlightLoop_t params;
+        params.structSize = sizeof(params);
+        params.phase = xplm_FlightLoop_Phase_BeforeFlightModel;
+        params.callbackFunc = &XPlaneLog::deferredSinksCallback;
+        params.refcon = nullptr;
+        deferredLoop = XPLMCreateFlightLoop(&params);
+        XPLMScheduleFlightLoop(static_cast<XPLMFlightLoopID>(deferredLoop), -1.0f, 1);
+    }
+    else
+    {
+        auto sinks = createSinks(plugin_name);
+        sinks.push_back(xplane_sink);
+        throttle->set_sinks(sinks);
+    }
+    logger = createLogger(plugin_name);
 
     // Set a custom formatter for the logger
     logger->set_formatter(std::make_unique<XPlaneLog::Formatter>());
@@ -70,24 +108,333 @@ void XPlaneLog::init(const std::string& plugin_name)
 
     spdlog::set_default_logger(logger);
 #ifdef NDEBUG
-    spdlog::set_level(
-        spdlog::level::info); // Production: only info, warn, error, critical (no debug/trace)
+    setLevel(*logger,
+             spdlog::level::info); // Production: only info, warn, error, critical (no debug/trace)
 #else
-    spdlog::set_level(spdlog::level::trace); // Debug: show all messages including trace and debug
+    setLevel(*logger, spdlog::level::trace); // Debug: show all messages including trace and debug
 #endif
     spdlog::flush_on(spdlog::level::info); // Flush logs on info level and higher
+
+    // Subsystem loggers requested before init() start writing now
+    {
+        std::lock_guard<std::mutex> lock(subsystemsMutex);
+        for (const auto& subsystem : subsystems)
+        {
+            gateOf(*subsystem.logger)->setDownstream(throttle);
+            subsystem.logger->flush_on(spdlog::level::info);
+            spdlog::register_logger(subsystem.logger);
+        }
+    }
     
     // Report where the log file is located
-    logger->info("spdlog file path: {}", logFilePath.string());
+    if (!deferredSink)
+    {
+        logger->info("spdlog file path: {}", logFile);
+    }
+
+    if (options.binaryLog)
+    {
+        XPlaneBinaryLog::init(plugin_name);
+    }
+}
+
+std::vector<spdlog::sink_ptr> XPlaneLog::createSinks(const std::string& plugin_name)
+{
+    using XPlaneUtilities::StartupProfiler;
+
+    // Optionally, create other sinks (e.g., console and file sinks)
+    spdlog::sink_ptr console_sink;
+    {
+        StartupProfiler::Scope profile("XPlaneLog", "console sink");
+        console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    }
+    {
+        StartupProfiler::Scope profile("XPlaneLog", "logFilePath");
+        logFile = logFilePath(plugin_name, ".log");
+    }
+    spdlog::sink_ptr file_sink;
+    {
+        StartupProfiler::Scope profile("XPlaneLog", "file sink");
+        file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFile, true);
+    }
+    return {console_sink, file_sink};
+}
+
+void XPlaneLog::openDeferredSinks()
+{
+    if (!deferredSink)
+    {
+        return;
+    }
+
+    XPlaneUtilities::StartupProfiler::Scope profile("XPlaneLog", "openDeferredSinks");
+    auto sinks = createSinks(pluginName);
+    for (const auto& sink : sinks)
+    {
+        sink->set_formatter(std::make_unique<XPlaneLog::Formatter>());
+    }
+    throttle->replaceSink(deferredSink, sinks);
+    deferredSink = nullptr;
+
+    logger->info("spdlog file path: {}", logFile);
+}
+
+float XPlaneLog::deferredSinksCallback(float, float, int, void*)
+{
+    openDeferredSinks();
+    return 0.0f; // Once; destroyed by shutdown()
+}
+
+std::string XPlaneLog::logFilePath(const std::string& plugin_name, const std::string& extension)
+{
+    // Determine the plugin's directory
+    char pluginPath[512];
+    XPLMGetPluginInfo(XPLMGetMyID(), nullptr, pluginPath, nullptr, nullptr);
+
+    // Construct the path to Log.txt within the plugin's directory
+    std::filesystem::path path(pluginPath);
+    // std::filesystem::path logFileName = "Log.txt";
+
+    // Sanitize plugin_name to be a valid filename
+    std::string sanitized_plugin_name = plugin_name;
+    std::replace_if(
+        sanitized_plugin_name.begin(), sanitized_plugin_name.end(),
+        [](char c) { return !std::isalnum(c) && c != '_' && c != '+' && c != '-'; }, '_');
+
+    std::filesystem::path logFileName = sanitized_plugin_name + extension;
+    // Navigate up two levels: from win_x64/ImGuiSimBrief.xpl -> win_x64/ -> ImGuiSimBrief.refactor/
+    return (path.parent_path().parent_path() / logFileName).string();
 }
 
 void XPlaneLog::shutdown()
 {
     if (logger)
     {
+        // Records of a session that never reached a flight loop still get written
+        openDeferredSinks();
+        if (deferredLoop)
+        {
+            XPLMDestroyFlightLoop(static_cast<XPLMFlightLoopID>(deferredLoop));
+            deferredLoop = nullptr;
+        }
+        disableThreadBuffers();
+        XPlaneBinaryLog::shutdown(); // Buffered binary records would be lost otherwise
+        throttle->drain(); // Report anything still being suppressed
         logger->flush();
+        dumpBlackBox("shutdown");
+        removeCrashHandlers();
+        disableBlackBox();
         spdlog::drop_all(); // Drops all registered loggers
+        {
+            std::lock_guard<std::mutex> lock(subsystemsMutex);
+            subsystems.clear();
+        }
         logger = nullptr;
+        throttle = nullptr;
+    }
+}
+
+std::shared_ptr<spdlog::logger> XPlaneLog::getLogger(const std::string& subsystem)
+{
+    std::lock_guard<std::mutex> lock(subsystemsMutex);
+    for (const auto& existing : subsystems)
+    {
+        if (existing.name == subsystem)
+        {
+            return existing.logger;
+        }
+    }
+
+    const std::string name = logger ? logger->name() + "." + subsystem : subsystem;
+    auto child = createLogger(name);
+    if (logger)
+    {
+        setLevel(*child, getLevel(*logger));
+        child->flush_on(logger->flush_level());
+        spdlog::register_logger(child);
+    }
+
+    subsystems.push_back({subsystem, child});
+    return child;
+}
+
+std::vector<std::string> XPlaneLog::getSubsystems()
+{
+    std::lock_guard<std::mutex> lock(subsystemsMutex);
+    std::vector<std::string> names;
+    names.reserve(subsystems.size());
+    for (const auto& subsystem : subsystems)
+    {
+        names.push_back(subsystem.name);
+    }
+    return names;
+}
+
+spdlog::sink_ptr XPlaneLog::activeSink()
+{
+    if (threadRings)
+    {
+        return threadRings;
+    }
+    return throttle;
+}
+
+XPlaneLog::LevelGate* XPlaneLog::gateOf(const spdlog::logger& target)
+{
+    const auto& sinks = target.sinks();
+    return sinks.empty() ? nullptr : dynamic_cast<LevelGate*>(sinks.front().get());
+}
+
+std::shared_ptr<spdlog::logger> XPlaneLog::createLogger(const std::string& name)
+{
+    auto gate = std::make_shared<LevelGate>(activeSink(), spdlog::level::info);
+    return std::make_shared<spdlog::logger>(name, std::move(gate));
+}
+
+std::vector<std::shared_ptr<spdlog::logger>> XPlaneLog::allLoggersLocked()
+{
+    std::vector<std::shared_ptr<spdlog::logger>> loggers;
+    if (logger)
+    {
+        loggers.push_back(logger);
+    }
+    for (const auto& subsystem : subsystems)
+    {
+        loggers.push_back(subsystem.logger);
+    }
+    return loggers;
+}
+
+void XPlaneLog::setLevel(spdlog::logger& target, spdlog::level::level_enum level)
+{
+    LevelGate* gate = gateOf(target);
+    if (!gate)
+    {
+        target.set_level(level);
+        return;
+    }
+
+    // The logger itself lets records through down to the capture level;
+    // the gate decides whether they reach the sinks or the black box
+    gate->outputLevel.store(level);
+    const auto capture = static_cast<spdlog::level::level_enum>(blackBoxLevel.load());
+    target.set_level(activeBlackBox.load() ? std::min(level, capture) : level);
+}
+
+spdlog::level::level_enum XPlaneLog::getLevel(const spdlog::logger& target)
+{
+    const LevelGate* gate = gateOf(target);
+    return gate ? static_cast<spdlog::level::level_enum>(gate->outputLevel.load())
+                : target.level();
+}
+
+void XPlaneLog::setThrottleOptions(const ThrottleOptions& options)
+{
+    if (throttle)
+    {
+        throttle->setOptions(options);
+    }
+}
+
+XPlaneLog::ThrottleStats XPlaneLog::getThrottleStats()
+{
+    return throttle ? throttle->getStats() : ThrottleStats{};
+}
+
+void XPlaneLog::enableThreadBuffers()
+{
+    enableThreadBuffers(ThreadBufferOptions());
+}
+
+void XPlaneLog::enableThreadBuffers(const ThreadBufferOptions& options)
+{
+    if (!logger || threadRings)
+    {
+        return;
+    }
+
+    threadRings = std::make_shared<ThreadRingSink>(throttle, options);
+    threadRings->registerThread(); // The sim thread never takes the registration lock later
+
+    std::lock_guard<std::mutex> lock(subsystemsMutex);
+    for (const auto& target : allLoggersLocked())
+    {
+        gateOf(*target)->setDownstream(threadRings);
+    }
+}
+
+void XPlaneLog::disableThreadBuffers()
+{
+    if (!logger || !threadRings)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(subsystemsMutex);
+        for (const auto& target : allLoggersLocked())
+        {
+            gateOf(*target)->setDownstream(throttle);
+        }
+    }
+    threadRings->stop();
+    const ThreadBufferStats stats = threadRings->getStats();
+    threadRings = nullptr;
+
+    if (stats.dropped > 0)
+    {
+        logger->warn("Thread log buffers were full, dropped {} messages", stats.dropped);
+    }
+}
+
+XPlaneLog::ThreadBufferStats XPlaneLog::getThreadBufferStats()
+{
+    return threadRings ? threadRings->getStats() : ThreadBufferStats{};
+}
+
+void XPlaneLog::enableBlackBox(std::size_t records, spdlog::level::level_enum captureLevel)
+{
+    if (!logger || blackBox)
+    {
+        return;
+    }
+
+    openDeferredSinks(); // The black box appends to the log file
+    blackBox = std::make_unique<BlackBox>(records, logFile);
+    blackBoxLevel.store(captureLevel);
+    activeBlackBox.store(blackBox.get());
+
+    // Re-apply the output levels so the loggers let captured levels through
+    std::lock_guard<std::mutex> lock(subsystemsMutex);
+    for (const auto& target : allLoggersLocked())
+    {
+        setLevel(*target, getLevel(*target));
+    }
+}
+
+void XPlaneLog::disableBlackBox()
+{
+    if (!blackBox)
+    {
+        return;
+    }
+
+    activeBlackBox.store(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(subsystemsMutex);
+        for (const auto& target : allLoggersLocked())
+        {
+            setLevel(*target, getLevel(*target));
+        }
+    }
+    blackBox = nullptr;
+}
+
+void XPlaneLog::dumpBlackBox(const char* reason)
+{
+    if (BlackBox* box = activeBlackBox.load())
+    {
+        box->dump(reason);
     }
 }
 
@@ -128,8 +475,10 @@ void XPlaneLog::Sink::sink_it_(const spdlog::details::log_msg& msg)
     spdlog::memory_buf_t formatted;
     base_sink<std::mutex>::formatter_->format(msg, formatted);
 
-    // Write the message to X-Plane Log.txt using XPLMDebugString
-    XPLMDebugString(fmt::to_string(formatted).c_str());
+    // Write the message to X-Plane Log.txt using XPLMDebugString; terminated
+    // in place rather than copied into a std::string
+    formatted.push_back('\0');
+    XPLMDebugString(formatted.data());
 }
 
 void XPlaneLog::Sink::flush_()
@@ -137,35 +486,949 @@ void XPlaneLog::Sink::flush_()
     // Flush function can be empty as XPLMDebugString doesn't have a corresponding flush function
 }
 
-void XPlaneLog::Formatter::format(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest)
+// Implementation of the throttling sink
+XPlaneLog::ThrottleSink::ThrottleSink()
+    : repeatPool(XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Logging)),
+      repeats(&repeatPool)
+{
+}
+
+void XPlaneLog::ThrottleSink::setOptions(const ThrottleOptions& newOptions)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    options = newOptions;
+    for (auto& bucket : buckets)
+    {
+        bucket.tokens = 0.0;
+        bucket.lastRefill = {};
+    }
+}
+
+XPlaneLog::ThrottleStats XPlaneLog::ThrottleSink::getStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats;
+}
+
+void XPlaneLog::ThrottleSink::drain()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // log_msg only views the name, so keep it alive for the sweep
+    const std::string name = logger ? logger->name() : std::string();
+    spdlog::details::log_msg context(name, spdlog::level::info, spdlog::string_view_t());
+    sweep(context, true);
+}
+
+void XPlaneLog::ThrottleSink::replaceSink(
+    const std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt>& buffer,
+    const std::vector<spdlog::sink_ptr>& sinks)
+{
+    // Holding the fan-out lock keeps new records out of the buffer meanwhile
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& record : buffer->last_raw())
+    {
+        for (const auto& sink : sinks)
+        {
+            sink->log(record);
+        }
+    }
+    for (const auto& sink : sinks)
+    {
+        sink->flush();
+    }
+
+    sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), buffer), sinks_.end());
+    sinks_.insert(sinks_.begin(), sinks.begin(), sinks.end());
+}
+
+std::uint64_t XPlaneLog::ThrottleSink::messageKey(const spdlog::details::log_msg& msg)
+{
+    // FNV-1a over the call site and the rendered payload
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const auto file = reinterpret_cast<std::uintptr_t>(msg.source.filename);
+    const auto line = static_cast<std::uint64_t>(msg.source.line);
+    mix(reinterpret_cast<const char*>(&file), sizeof(file));
+    mix(reinterpret_cast<const char*>(&line), sizeof(line));
+    mix(msg.payload.data(), msg.payload.size());
+    return hash;
+}
+
+void XPlaneLog::ThrottleSink::emitSummary(const spdlog::details::log_msg& context,
+                                          spdlog::level::level_enum level,
+                                          const std::string& text)
+{
+    spdlog::details::log_msg summary(context.time, spdlog::source_loc{}, context.logger_name, level,
+                                     text);
+    dist_sink<std::mutex>::sink_it_(summary);
+}
+
+void XPlaneLog::ThrottleSink::sweep(const spdlog::details::log_msg& context, bool all)
+{
+    for (auto it = repeats.begin(); it != repeats.end();)
+    {
+        if (all || context.time - it->second.windowStart >= options.dedupWindow)
+        {
+            if (it->second.suppressed > 0)
+            {
+                emitSummary(context, it->second.level,
+                            fmt::format("Message repeated {} more times: {}",
+                                        it->second.suppressed, it->second.text));
+            }
+            it = repeats.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (std::size_t level = 0; level < buckets.size(); ++level)
+    {
+        Bucket& bucket = buckets[level];
+        if (all && bucket.dropped > 0)
+        {
+            auto lvl = static_cast<spdlog::level::level_enum>(level);
+            emitSummary(context, lvl,
+                        fmt::format("Rate limit dropped {} {} messages", bucket.dropped,
+                                    spdlog::level::to_string_view(lvl)));
+            bucket.dropped = 0;
+        }
+    }
+
+    lastSweep = context.time;
+}
+
+void XPlaneLog::ThrottleSink::sink_it_(const spdlog::details::log_msg& msg)
+{
+    // Upper bound on remembered messages so unique messages cannot grow the table forever
+    constexpr std::size_t kMaxTracked = 4096;
+
+    if (options.dedupWindow.count() > 0)
+    {
+        if (msg.time - lastSweep >= options.dedupWindow || repeats.size() >= kMaxTracked)
+        {
+            sweep(msg, repeats.size() >= kMaxTracked);
+        }
+
+        const std::uint64_t key = messageKey(msg);
+        auto it = repeats.find(key);
+        if (it != repeats.end() && msg.time - it->second.windowStart < options.dedupWindow)
+        {
+            ++it->second.suppressed;
+            ++stats.duplicatesSuppressed;
+            return;
+        }
+
+        if (it != repeats.end())
+        {
+            // Window expired: report the suppressed run and start a new one
+            if (it->second.suppressed > 0)
+            {
+                emitSummary(msg, it->second.level,
+                            fmt::format("Message repeated {} more times: {}",
+                                        it->second.suppressed, it->second.text));
+            }
+            it->second.windowStart = msg.time;
+            it->second.suppressed = 0;
+        }
+        else
+        {
+            repeats.emplace(key, Repeat{msg.time, msg.level, 0,
+                                        std::pmr::string(msg.payload.data(), msg.payload.size(),
+                                                         &repeatPool)});
+        }
+    }
+
+    const double rate = options.ratePerSecond[msg.level];
+    if (rate > 0.0)
+    {
+        Bucket& bucket = buckets[msg.level];
+        const double burst = options.burst[msg.level] > 1.0 ? options.burst[msg.level] : 1.0;
+        if (bucket.lastRefill == spdlog::log_clock::time_point{})
+        {
+            bucket.tokens = burst;
+        }
+        else
+        {
+            const double elapsed =
+                std::chrono::duration<double>(msg.time - bucket.lastRefill).count();
+            bucket.tokens = std::min(burst, bucket.tokens + elapsed * rate);
+        }
+        bucket.lastRefill = msg.time;
+
+        if (bucket.tokens < 1.0)
+        {
+            ++bucket.dropped;
+            ++stats.rateLimited;
+            return;
+        }
+        bucket.tokens -= 1.0;
+
+        if (bucket.dropped > 0)
+        {
+            emitSummary(msg, msg.level,
+                        fmt::format("Rate limit dropped {} {} messages", bucket.dropped,
+                                    spdlog::level::to_string_view(msg.level)));
+            bucket.dropped = 0;
+        }
+    }
+
+    dist_sink<std::mutex>::sink_it_(msg);
+}
+
+// Implementation of the per-thread ring buffers
+namespace
+{
+// Distinguishes ring sinks so a thread re-registers after the mode is re-enabled
+std::atomic<std::uint64_t> nextRingGeneration{1};
+
+// Fixed part of a record; logger name and payload bytes follow it
+struct RingRecord
+{
+    std::int64_t time;
+    std::size_t threadId;
+    const char* file;
+    const char* function;
+    std::int32_t line;
+    std::uint32_t size; // Whole record including padding, 0 marks the wrap filler
+    std::uint32_t payloadLength;
+    std::uint16_t nameLength;
+    std::uint8_t level;
+};
+
+constexpr std::size_t alignRecord(std::size_t size)
+{
+    return (size + alignof(RingRecord) - 1) & ~(alignof(RingRecord) - 1);
+}
+} // namespace
+
+// Single-producer single-consumer byte ring. The owning thread advances head,
+// the collector advances tail; neither ever waits for the other.
+struct XPlaneLog::ThreadRingSink::Ring
+{
+    Ring(std::size_t bytes, std::pmr::memory_resource* resource) : resource(resource)
+    {
+        capacity = 1024;
+        while (capacity < bytes)
+        {
+            capacity <<= 1;
+        }
+        data = static_cast<std::uint64_t*>(resource->allocate(capacity, alignof(std::uint64_t)));
+    }
+
+    ~Ring() { resource->deallocate(data, capacity, alignof(std::uint64_t)); }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    char* bytes() { return reinterpret_cast<char*>(data); }
+
+    bool push(const spdlog::details::log_msg& msg)
+    {
+        const std::size_t need =
+            alignRecord(sizeof(RingRecord) + msg.logger_name.size() + msg.payload.size());
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t offset = h & (capacity - 1);
+        const std::size_t contiguous = capacity - offset;
+        const std::size_t filler = need > contiguous ? contiguous : 0;
+
+        if (need > capacity || h + filler + need - tail.load(std::memory_order_acquire) > capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (filler >= sizeof(RingRecord))
+        {
+            // Shorter gaps are skipped by the reader without a marker
+            RingRecord wrap{};
+            std::memcpy(bytes() + offset, &wrap, sizeof(wrap));
+        }
+
+        char* p = bytes() + ((h + filler) & (capacity - 1));
+        RingRecord record;
+        record.time = msg.time.time_since_epoch().count();
+        record.threadId = msg.thread_id;
+        record.file = msg.source.filename;
+        record.function = msg.source.funcname;
+        record.line = msg.source.line;
+        record.size = static_cast<std::uint32_t>(need);
+        record.payloadLength = static_cast<std::uint32_t>(msg.payload.size());
+        record.nameLength = static_cast<std::uint16_t>(msg.logger_name.size());
+        record.level = static_cast<std::uint8_t>(msg.level);
+        std::memcpy(p, &record, sizeof(record));
+        std::memcpy(p + sizeof(record), msg.logger_name.data(), record.nameLength);
+        std::memcpy(p + sizeof(record) + record.nameLength, msg.payload.data(),
+                    record.payloadLength);
+
+        head.store(h + filler + need, std::memory_order_release);
+        return true;
+    }
+
+    // Collector side: hand every published record to fn and release the space
+    template<typename Fn>
+    std::size_t drain(Fn&& fn)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(std::memory_order_acquire);
+        std::size_t count = 0;
+
+        while (t != h)
+        {
+            const std::size_t offset = t & (capacity - 1);
+            const std::size_t contiguous = capacity - offset;
+            RingRecord record{};
+            if (contiguous >= sizeof(record))
+            {
+                std::memcpy(&record, bytes() + offset, sizeof(record));
+            }
+            if (record.size == 0)
+            {
+                t += contiguous; // Skip the filler up to the wrap point
+                continue;
+            }
+
+            fn(record, bytes() + offset + sizeof(record));
+            t += record.size;
+            ++count;
+        }
+
+        tail.store(t, std::memory_order_release);
+        return count;
+    }
+
+    std::pmr::memory_resource* resource; // MemoryComponent::Logging
+    std::uint64_t* data;
+    std::size_t capacity;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+};
+
+// The calling thread's ring; marked retired when the thread exits so the
+// collector can release it once drained
+struct XPlaneLog::ThreadRingSink::RingHolder
+{
+    std::shared_ptr<Ring> ring;
+    std::uint64_t generation = 0;
+
+    ~RingHolder()
+    {
+        if (ring)
+        {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+XPlaneLog::ThreadRingSink::ThreadRingSink(std::shared_ptr<spdlog::sinks::sink> downstream,
+                                          const ThreadBufferOptions& options)
+    : downstream(std::move(downstream)), options(options),
+      generation(nextRingGeneration.fetch_add(1)),
+      pending(XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Logging))
+{
+    collector = std::thread(&ThreadRingSink::collectorLoop, this);
+}
+
+XPlaneLog::ThreadRingSink::~ThreadRingSink()
+{
+    stop();
+}
+
+void XPlaneLog::ThreadRingSink::log(const spdlog::details::log_msg& msg)
+{
+    threadRing().push(msg);
+}
+
+void XPlaneLog::ThreadRingSink::set_pattern(const std::string& pattern)
+{
+    downstream->set_pattern(pattern);
+}
+
+void XPlaneLog::ThreadRingSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter)
+{
+    downstream->set_formatter(std::move(formatter));
+}
+
+void XPlaneLog::ThreadRingSink::registerThread()
+{
+    threadRing();
+}
+
+XPlaneLog::ThreadRingSink::Ring& XPlaneLog::ThreadRingSink::threadRing()
+{
+    thread_local RingHolder holder;
+    if (holder.generation != generation)
+    {
+        // First message of this thread in this mode: the only time a logging
+        // thread takes a lock
+        if (holder.ring)
+        {
+            holder.ring->retired.store(true, std::memory_order_release);
+        }
+        std::pmr::memory_resource* resource =
+            XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Logging);
+        holder.ring = std::allocate_shared<Ring>(std::pmr::polymorphic_allocator<Ring>(resource),
+                                                 options.ringBytes, resource);
+        holder.generation = generation;
+
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(holder.ring);
+    }
+    return *holder.ring;
+}
+
+void XPlaneLog::ThreadRingSink::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+
+    wake.notify_one();
+    if (collector.joinable())
+    {
+        collector.join();
+    }
+    collect(true);
+}
+
+XPlaneLog::ThreadBufferStats XPlaneLog::ThreadRingSink::getStats()
+{
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    ThreadBufferStats stats;
+    stats.records = records;
+    stats.dropped = retiredDropped;
+    stats.threads = rings.size();
+    for (const auto& ring : rings)
+    {
+        stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void XPlaneLog::ThreadRingSink::collectorLoop()
+{
+    while (running.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, options.collectInterval, [this] { return !running.load(); });
+        }
+        collect(false);
+    }
+}
+
+void XPlaneLog::ThreadRingSink::collect(bool all)
+{
+    // Records younger than this may still be overtaken by an older record
+    // that another thread is about to publish, so they wait for the next pass
+    const auto holdBack = options.collectInterval;
+    const auto cutoff = spdlog::log_clock::now() - holdBack;
+
+    std::vector<std::shared_ptr<Ring>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        snapshot = rings;
+    }
+
+    for (const auto& ring : snapshot)
+    {
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        ring->drain(
+            [this](const RingRecord& record, const char* text)
+            {
+                Pending entry(pending.get_allocator());
+                entry.time = spdlog::log_clock::time_point(
+                    spdlog::log_clock::duration(record.time));
+                entry.level = static_cast<spdlog::level::level_enum>(record.level);
+                entry.source = spdlog::source_loc(record.file, record.line, record.function);
+                entry.threadId = record.threadId;
+                entry.loggerName.assign(text, record.nameLength);
+                entry.payload.assign(text + record.nameLength, record.payloadLength);
+                pending.push_back(std::move(entry));
+            });
+
+        if (retired)
+        {
+            // The owner has exited and its last records were just drained
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            retiredDropped += ring->dropped.load(std::memory_order_relaxed);
+            rings.erase(std::remove(rings.begin(), rings.end(), ring), rings.end());
+        }
+    }
+
+    if (pending.empty())
+    {
+        return;
+    }
+
+    // Each ring is already in time order; merge them into one sequence
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](const Pending& a, const Pending& b) { return a.time < b.time; });
+
+    std::size_t emitted = 0;
+    for (; emitted < pending.size(); ++emitted)
+    {
+        const Pending& entry = pending[emitted];
+        if (!all && entry.time > cutoff)
+        {
+            break;
+        }
+
+        spdlog::details::log_msg msg(entry.time, entry.source, entry.loggerName, entry.level,
+                                     entry.payload);
+        msg.thread_id = entry.threadId;
+        downstream->log(msg);
+    }
+
+    if (emitted > 0)
+    {
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(emitted));
+        downstream->flush();
+
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        records += emitted;
+    }
+}
+
+// Implementation of the level gate
+XPlaneLog::LevelGate::LevelGate(spdlog::sink_ptr downstream, spdlog::level::level_enum outputLevel)
+    : outputLevel(outputLevel), downstream(std::move(downstream))
+{
+}
+
+void XPlaneLog::LevelGate::log(const spdlog::details::log_msg& msg)
+{
+    if (msg.level < outputLevel.load(std::memory_order_relaxed))
+    {
+        if (BlackBox* box = activeBlackBox.load(std::memory_order_acquire))
+        {
+            box->record(msg);
+        }
+        return;
+    }
+
+    const spdlog::sink_ptr sink = std::atomic_load(&downstream);
+    if (!sink)
+    {
+        return; // Logger created before init()
+    }
+
+    sink->log(msg);
+    if (msg.level == spdlog::level::critical && activeBlackBox.load())
+    {
+        // Context for the failure goes right after the critical message
+        sink->flush();
+        dumpBlackBox("critical");
+    }
+}
+
+void XPlaneLog::LevelGate::setDownstream(spdlog::sink_ptr sink)
+{
+    std::atomic_store(&downstream, std::move(sink));
+}
+
+void XPlaneLog::LevelGate::flush()
+{
+    if (const spdlog::sink_ptr sink = std::atomic_load(&downstream))
+    {
+        sink->flush();
+    }
+}
+
+void XPlaneLog::LevelGate::set_pattern(const std::string& pattern)
+{
+    if (const spdlog::sink_ptr sink = std::atomic_load(&downstream))
+    {
+        sink->set_pattern(pattern);
+    }
+}
+
+void XPlaneLog::LevelGate::set_formatter(std::unique_ptr<spdlog::formatter> formatter)
+{
+    if (const spdlog::sink_ptr sink = std::atomic_load(&downstream))
+    {
+        sink->set_formatter(std::move(formatter));
+    }
+}
+
+// Implementation of the black box
+namespace
+{
+constexpr std::size_t kBlackBoxText = 232; // Logger name and payload, truncated
+
+struct BlackBoxRecord
+{
+    std::int64_t time; // Nanoseconds since the epoch
+    std::uint16_t nameLength;
+    std::uint16_t textLength;
+    std::uint8_t level;
+    char text[kBlackBoxText];
+};
+
+// Minimal formatting helpers; dump() may run inside a signal handler, so no
+// allocation, locale or stdio
+struct LineWriter
+{
+    char buffer[512];
+    std::size_t length = 0;
+
+    void put(const char* text, std::size_t size)
+    {
+        size = std::min(size, sizeof(buffer) - length);
+        std::memcpy(buffer + length, text, size);
+        length += size;
+    }
+
+    void put(const char* text) { put(text, std::strlen(text)); }
+
+    void number(std::uint64_t value, int width)
+    {
+        char digits[20];
+        int count = 0;
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0 && count < 20);
+        while (count < width && count < 20)
+        {
+            digits[count++] = '0';
+        }
+        while (count > 0 && length < sizeof(buffer))
+        {
+            buffer[length++] = digits[--count];
+        }
+    }
+
+    // "YYYY-MM-DD HH:MM:SS.mmm" from local seconds since the epoch
+    void timestamp(std::int64_t seconds, std::int64_t millis)
+    {
+        std::int64_t days = seconds / 86400;
+        std::int64_t secondOfDay = seconds % 86400;
+        if (secondOfDay < 0)
+        {
+            secondOfDay += 86400;
+            --days;
+        }
+
+        // Civil date from days since 1970-01-01 (proleptic Gregorian calendar)
+        const std::int64_t z = days + 719468;
+        const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const std::int64_t doe = z - era * 146097;
+        const std::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const std::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const std::int64_t mp = (5 * doy + 2) / 153;
+        const std::int64_t day = doy - (153 * mp + 2) / 5 + 1;
+        const std::int64_t month = mp < 10 ? mp + 3 : mp - 9;
+        const std::int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+        number(static_cast<std::uint64_t>(year), 4);
+        put("-");
+        number(static_cast<std::uint64_t>(month), 2);
+        put("-");
+        number(static_cast<std::uint64_t>(day), 2);
+        put(" ");
+        number(static_cast<std::uint64_t>(secondOfDay / 3600), 2);
+        put(":");
+        number(static_cast<std::uint64_t>(secondOfDay / 60 % 60), 2);
+        put(":");
+        number(static_cast<std::uint64_t>(secondOfDay % 60), 2);
+        put(".");
+        number(static_cast<std::uint64_t>(millis), 3);
+    }
+};
+
+void writeAll(int fd, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        const int written = _write(fd, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t written = ::write(fd, data, size);
+#endif
+        if (written <= 0)
+        {
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+const char* const kLevelNames[] = {"TRACE", "DEBUG",    "INFO", "WARNING",
+                                   "ERROR", "CRITICAL", "OFF"};
+} // namespace
+
+// Seqlock slot: sequence is odd while the record is being written and
+// 2 * (index + 1) once record holds entry number index
+struct XPlaneLog::BlackBox::Slot
+{
+    std::atomic<std::uint64_t> sequence{0};
+    BlackBoxRecord record;
+};
+
+XPlaneLog::BlackBox::BlackBox(std::size_t records, const std::string& path)
+    : resource(XPlaneUtilities::MemoryResources::get(XPlaneUtilities::MemoryComponent::Logging))
+{
+    capacity = 1;
+    while (capacity < records)
+    {
+        capacity <<= 1;
+    }
+    slots = static_cast<Slot*>(resource->allocate(capacity * sizeof(Slot), alignof(Slot)));
+    std::uninitialized_default_construct_n(slots, capacity);
+
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+    std::tm utc{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+    gmtime_s(&utc, &now);
+    fd = _open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    localtime_r(&now, &local);
+    gmtime_r(&now, &utc);
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+#endif
+    utc.tm_isdst = local.tm_isdst;
+    utcOffset = static_cast<long>(std::difftime(std::mktime(&local), std::mktime(&utc)));
+}
+
+XPlaneLog::BlackBox::~BlackBox()
+{
+    if (fd >= 0)
+    {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+    std::destroy_n(slots, capacity);
+    resource->deallocate(slots, capacity * sizeof(Slot), alignof(Slot));
+}
+
+void XPlaneLog::BlackBox::record(const spdlog::details::log_msg& msg)
+{
+    const std::uint64_t index = next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & (capacity - 1)];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    BlackBoxRecord& record = slot.record;
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      msg.time.time_since_epoch())
+                      .count();
+    record.level = static_cast<std::uint8_t>(msg.level);
+    record.nameLength =
+        static_cast<std::uint16_t>(std::min(msg.logger_name.size(), kBlackBoxText / 4));
+    record.textLength = static_cast<std::uint16_t>(
+        std::min(msg.payload.size(), kBlackBoxText - record.nameLength));
+    std::memcpy(record.text, msg.logger_name.data(), record.nameLength);
+    std::memcpy(record.text + record.nameLength, msg.payload.data(), record.textLength);
+
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void XPlaneLog::BlackBox::dump(const char* reason)
+{
+    if (fd < 0 || dumping.test_and_set(std::memory_order_acquire))
+    {
+        return; // Another thread (or an interrupted one) is already dumping
+    }
+
+    const std::uint64_t end = next.load(std::memory_order_acquire);
+    std::uint64_t begin = dumped.load(std::memory_order_relaxed);
+    if (end - begin > capacity)
+    {
+        begin = end - capacity;
+    }
+
+    if (begin < end)
+    {
+        LineWriter header;
+        header.put("---- Black box (");
+        header.put(reason);
+        header.put("): last ");
+        header.number(end - begin, 1);
+        header.put(" records below the log level ----\n");
+        writeAll(fd, header.buffer, header.length);
+
+        for (std::uint64_t index = begin; index < end; ++index)
+        {
+            const Slot& slot = slots[index & (capacity - 1)];
+            const std::uint64_t expected = 2 * index + 2;
+            if (slot.sequence.load(std::memory_order_acquire) != expected)
+            {
+                continue; // Overwritten or still being written
+            }
+
+            BlackBoxRecord record;
+            std::memcpy(&record, &slot.record, sizeof(record));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected)
+            {
+                continue;
+            }
+
+            const std::int64_t ms = record.time / 1000000;
+            const std::int64_t local = ms / 1000 + utcOffset;
+
+            LineWriter line;
+            line.put("[");
+            line.timestamp(local, ms % 1000);
+            line.put("] [");
+            line.put(record.text, record.nameLength);
+            line.put("] [");
+            line.put(kLevelNames[std::min<std::size_t>(record.level, 6)]);
+            line.put("] ");
+            line.put(record.text + record.nameLength, record.textLength);
+            line.put("\n");
+            writeAll(fd, line.buffer, line.length);
+        }
+
+        static const char footer[] = "---- End of black box ----\n";
+        writeAll(fd, footer, sizeof(footer) - 1);
+    }
+
+    dumped.store(end, std::memory_order_relaxed);
+    dumping.clear(std::memory_order_release);
+}
+
+// Implementation of the crash handlers
+namespace
+{
+std::terminate_handler previousTerminate = nullptr;
+bool crashHandlersInstalled = false;
+
+const int kCrashSignals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL
+#ifndef _WIN32
+                             , SIGBUS
+#endif
+};
+
+#ifdef _WIN32
+using SignalHandler = void (*)(int);
+SignalHandler previousSignals[sizeof(kCrashSignals) / sizeof(kCrashSignals[0])];
+#else
+struct sigaction previousSignals[sizeof(kCrashSignals) / sizeof(kCrashSignals[0])];
+#endif
+
+std::size_t signalSlot(int signal)
+{
+    for (std::size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); ++i)
+    {
+        if (kCrashSignals[i] == signal)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+void onTerminate()
+{
+    XPlaneLog::dumpBlackBox("terminate");
+    if (previousTerminate)
+    {
+        previousTerminate();
+    }
+    std::abort();
+}
+
+void onCrashSignal(int signal)
 {
-    // Extract and convert log level to uppercase
-    std::string log_level = spdlog::level::to_string_view(msg.level).data();
-    std::transform(log_level.begin(), log_level.end(), log_level.begin(), ::toupper);
+    XPlaneLog::dumpBlackBox("fatal signal");
+
+    // Restore whoever handled the signal before us and let it run
+    const std::size_t slot = signalSlot(signal);
+#ifdef _WIN32
+    std::signal(signal, previousSignals[slot] ? previousSignals[slot] : SIG_DFL);
+#else
+    sigaction(signal, &previousSignals[slot], nullptr);
+#endif
+    std::raise(signal);
+}
+} // namespace
 
-    // Create a custom pattern that includes the uppercase log level
-    std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%n] [" + log_level + "] %v";
+void XPlaneLog::installCrashHandlers()
+{
+    if (crashHandlersInstalled)
+    {
+        return;
+    }
+
+    previousTerminate = std::set_terminate(onTerminate);
+    for (std::size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); ++i)
+    {
+#ifdef _WIN32
+        previousSignals[i] = std::signal(kCrashSignals[i], onCrashSignal);
+#else
+        struct sigaction action{};
+        action.sa_handler = onCrashSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESETHAND | SA_NODEFER;
+        sigaction(kCrashSignals[i], &action, &previousSignals[i]);
+#endif
+    }
+    crashHandlersInstalled = true;
+}
 
-    // Use the pattern formatter with the custom pattern to format the message
-    spdlog::pattern_formatter formatter(pattern);
-    formatter.format(msg, dest);
+void XPlaneLog::removeCrashHandlers()
+{
+    if (!crashHandlersInstalled)
+    {
+        return;
+    }
 
-    // Convert to string
-    std::string formatted_str = fmt::to_string(dest);
+    // The plugin may be unloaded, so nothing may keep pointing into it
+    std::set_terminate(previousTerminate);
+    for (std::size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); ++i)
+    {
+#ifdef _WIN32
+        std::signal(kCrashSignals[i], previousSignals[i] ? previousSignals[i] : SIG_DFL);
+#else
+        sigaction(kCrashSignals[i], &previousSignals[i], nullptr);
+#endif
+    }
+    crashHandlersInstalled = false;
+}
 
-    // Ensure it ends with a single newline
-    if (!formatted_str.empty())
+XPlaneLog::Formatter::Formatter()
+{
+    for (int level = 0; level < spdlog::level::n_levels; ++level)
     {
-        // Remove any existing CR or LF characters
-        formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\r'),
-                            formatted_str.end());
-        formatted_str.erase(std::remove(formatted_str.begin(), formatted_str.end(), '\n'),
-                            formatted_str.end());
-        // Add a single newline character
-        formatted_str += '\n';
+        const auto name =
+            spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(level));
+        std::string upper(name.data(), name.size());
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        patterns[level] = std::make_unique<spdlog::pattern_formatter>(
+            "[%Y-%m-%d %H:%M:%S.%e] [%n] [" + upper + "] %v", spdlog::pattern_time_type::local,
+            std::string());
     }
+}
+
+void XPlaneLog::Formatter::format(const spdlog::details::log_msg& msg, spdlog::memory_buf_t& dest)
+{
+    patterns[msg.level]->format(msg, dest);
 
-    // Clear the destination buffer and append the formatted string
-    dest.clear();
-    fmt::format_to(std::back_inserter(dest), "{}", formatted_str);
+    // One line per record: drop any CR or LF, then end with a single newline
+    char* end = std::remove_if(dest.data(), dest.data() + dest.size(),
+                               [](char c) { return c == '\r' || c == '\n'; });
+    dest.resize(static_cast<std::size_t>(end - dest.data()));
+    dest.push_back('\n');
 }
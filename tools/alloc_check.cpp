@@ -0,0 +1,403 @@
+/*
+ *   xpu-alloc-check - Check that the per-frame paths of the library do not allocate
+ *
+ *   Usage: xpu-alloc-check [frames]
+ *
+ *   Runs each path below against mock_xplm.cpp, first for enough frames to
+ *   reach its steady state (rolling windows full, buffers grown), then for
+ *   the given number of measured frames (default 2000) while counting every
+ *   heap allocation on the calling thread: global operator new, which the
+ *   default MemoryResources and std::function targets go through as well.
+ *
+ *       datarefs     DataRefAccess get and set of int, float and double
+ *       batch        the same writes plus array elements recorded by an
+ *                    active DataRefWriteBatch and flushed once per frame
+ *       flightdata   FlightDataProvider getters and the formatted Zulu time
+ *       metrics      DerivedMetrics::update() over the flight data graph,
+ *                    with its 30 s EMA and 60 s rolling window
+ *       traffic      TrafficDataProvider::update() with 20 targets
+ *       exports      reads of DataRefExport datarefs through every type
+ *       logging      XPlaneLog messages with arguments through the console,
+ *                    file and Log.txt sinks, and through per-thread buffers
+ *       menus        MenuItem::Item check mark, enabled state and title
+ *                    refreshed every frame
+ *
+ *   Prints one line per path and exits 1 if any of them allocated.
+ */
+
+#include "mock_xplm.h"
+
+#include <XPlaneUtilities/DataRefAccess.h>
+#include <XPlaneUtilities/DataRefExport.h>
+#include <XPlaneUtilities/DataRefWriteBatch.h>
+#include <XPlaneUtilities/DerivedMetrics.h>
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/MenuHandler.h>
+#include <XPlaneUtilities/TrafficDataProvider.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace XPlaneUtilities;
+
+//==========================================================================
+// Allocation counting
+//==========================================================================
+
+namespace
+{
+thread_local std::uint64_t threadAllocations = 0;
+
+void* allocate(std::size_t size)
+{
+    ++threadAllocations;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    ++threadAllocations;
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+// The array and nothrow forms forward to these in libstdc++ and libc++
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+constexpr float kFrameSeconds = 1.0f / 60.0f;
+
+int failures = 0;
+int measuredFrames = 2000;
+
+// Run frame(i) for warmup frames, then count the allocations of the
+// measured frames
+template<typename Fn>
+std::uint64_t measure(int warmup, Fn&& frame)
+{
+    int i = 0;
+    for (; i < warmup; ++i)
+    {
+        frame(i);
+    }
+
+    const std::uint64_t before = threadAllocations;
+    for (; i < warmup + measuredFrames; ++i)
+    {
+        frame(i);
+    }
+    return threadAllocations - before;
+}
+
+void report(const char* name, std::uint64_t allocations)
+{
+    if (allocations == 0)
+    {
+        std::printf("ok    %s\n", name);
+    }
+    else
+    {
+        std::printf("FAIL  %s: %llu allocations in %d frames\n", name,
+                    static_cast<unsigned long long>(allocations), measuredFrames);
+        ++failures;
+    }
+}
+
+// Sends stdout to /dev/null while alive, so the console sink stays quiet
+class DiscardStdout
+{
+public:
+    DiscardStdout()
+    {
+        std::fflush(stdout);
+        saved = dup(STDOUT_FILENO);
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        close(null);
+    }
+
+    ~DiscardStdout()
+    {
+        std::fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+
+private:
+    int saved;
+};
+
+// Simulator datarefs the checks drive; set through XPLM handles so that
+// the harness itself does not allocate while measuring
+XPLMDataRef fuelRef, zuluRef, groundSpeedRef, latitudeRef, elevationRef;
+XPLMDataRef tcasXRef, tcasZRef;
+
+void defineSimulator()
+{
+    MockXPLM::defineDataRef("sim/flightmodel/weight/m_fuel_total", xplmType_Float, true);
+    MockXPLM::defineDataRef("sim/time/zulu_time_sec", xplmType_Float, true);
+    MockXPLM::defineDataRef("sim/flightmodel/position/groundspeed", xplmType_Float, true);
+    MockXPLM::defineDataRef("sim/flightmodel/position/latitude", xplmType_Double, true);
+    MockXPLM::defineDataRef("sim/flightmodel/position/longitude", xplmType_Double, false);
+    MockXPLM::defineDataRef("sim/flightmodel/position/indicated_airspeed", xplmType_Float,
+                            false);
+    MockXPLM::defineDataRef("sim/flightmodel/position/elevation", xplmType_Double, true);
+
+    MockXPLM::defineDataRef("xpu/check/int", xplmType_Int, true);
+    MockXPLM::defineDataRef("xpu/check/float", xplmType_Float, true);
+    MockXPLM::defineDataRef("xpu/check/double", xplmType_Double, true);
+    MockXPLM::defineDataRef("xpu/check/floats", xplmType_FloatArray, true, 16);
+
+    MockXPLM::defineDataRef("sim/cockpit2/tcas/indicators/tcas_num_acf", xplmType_Int, false);
+    MockXPLM::defineDataRef("sim/cockpit2/tcas/targets/modeS_id", xplmType_IntArray, false, 64);
+    for (const char* field : {"x", "y", "z", "vx", "vy", "vz", "lat", "lon", "ele", "psi"})
+    {
+        MockXPLM::defineDataRef(std::string("sim/cockpit2/tcas/targets/position/") + field,
+                                xplmType_FloatArray, true, 64);
+    }
+
+    fuelRef = XPLMFindDataRef("sim/flightmodel/weight/m_fuel_total");
+    zuluRef = XPLMFindDataRef("sim/time/zulu_time_sec");
+    groundSpeedRef = XPLMFindDataRef("sim/flightmodel/position/groundspeed");
+    latitudeRef = XPLMFindDataRef("sim/flightmodel/position/latitude");
+    elevationRef = XPLMFindDataRef("sim/flightmodel/position/elevation");
+    tcasXRef = XPLMFindDataRef("sim/cockpit2/tcas/targets/position/x");
+    tcasZRef = XPLMFindDataRef("sim/cockpit2/tcas/targets/position/z");
+}
+
+// Simulator state for frame i
+void advanceSimulator(int i)
+{
+    const double t = i * static_cast<double>(kFrameSeconds);
+    XPLMSetDataf(fuelRef, static_cast<float>(12000.0 - 0.8 * t));
+    XPLMSetDataf(zuluRef, static_cast<float>(52200.0 + t));
+    XPLMSetDataf(groundSpeedRef, 120.0f + static_cast<float>(i % 100) * 0.1f);
+    XPLMSetDatad(latitudeRef, 47.4582 + t * 1e-4);
+    XPLMSetDatad(elevationRef, 432.0 + t);
+}
+
+//==========================================================================
+// Checks
+//==========================================================================
+
+void checkDataRefs()
+{
+    DataRefAccess<int> i("xpu/check/int");
+    DataRefAccess<float> f("xpu/check/float");
+    DataRefAccess<double> d("xpu/check/double");
+    report("datarefs", measure(10, [&](int frame) {
+        i = i.get() + 1;
+        f = static_cast<float>(frame) * 0.5f;
+        d.set(d.get() + 0.25);
+    }));
+}
+
+void checkBatch()
+{
+    DataRefAccess<int> i("xpu/check/int");
+    DataRefAccess<float> f("xpu/check/float");
+    const XPLMDataRef floats = XPLMFindDataRef("xpu/check/floats");
+    DataRefWriteBatch writes;
+    writes.activate();
+    report("batch", measure(10, [&](int frame) {
+        i = frame;
+        i = i.get() + 1; // Coalesced, read back from the batch
+        f = static_cast<float>(frame);
+        for (int k = 15; k >= 0; k -= 2)
+        {
+            writes.setFloatElement(floats, k, static_cast<float>(frame + k));
+        }
+        writes.setFloatElement(floats, 3, 1.0f);
+        writes.flush();
+    }));
+    writes.deactivate();
+}
+
+void checkFlightData()
+{
+    FlightDataProvider flightData;
+    char utc[8];
+    volatile double sink = 0.0;
+    report("flightdata", measure(10, [&](int frame) {
+        advanceSimulator(frame);
+        sink = flightData.getFuelOnBoard() + flightData.getZuluTimeSec() +
+               flightData.getGroundSpeed() + flightData.getLatitude() +
+               flightData.getLongitude() + flightData.getIndicatedAirspeed() +
+               flightData.getElevation();
+        flightData.getZuluTimeFormatted(utc);
+    }));
+    (void)sink;
+}
+
+void checkMetrics()
+{
+    FlightDataProvider flightData;
+    DerivedMetrics metrics;
+    metrics.addFlightData(flightData);
+    const int gs = metrics.find("groundspeed");
+    metrics.addRollingMax("groundspeed_max", gs, 60.0);
+
+    // Long enough to fill the 60 s windows
+    report("metrics", measure(static_cast<int>(90.0f / kFrameSeconds), [&](int frame) {
+        advanceSimulator(frame);
+        metrics.update(kFrameSeconds);
+    }));
+}
+
+void checkTraffic()
+{
+    MockXPLM::setValue("sim/cockpit2/tcas/indicators/tcas_num_acf", 21);
+    TrafficDataProvider traffic;
+    report("traffic", measure(10, [&](int frame) {
+        float x[21];
+        float z[21];
+        for (int k = 0; k < 21; ++k)
+        {
+            x[k] = static_cast<float>(k * 500 + frame);
+            z[k] = static_cast<float>(k * -300);
+        }
+        XPLMSetDatavf(tcasXRef, x, 0, 21);
+        XPLMSetDatavf(tcasZRef, z, 0, 21);
+        traffic.update();
+    }));
+}
+
+void checkExports()
+{
+    int counter = 0;
+    DataRefExport<int> counterExport(
+        "xpu/check/export/counter", &counter,
+        [](void* ref) { return *static_cast<int*>(ref); },
+        [](void* ref, int value) { *static_cast<int*>(ref) = value; });
+    double altitude = 0.0;
+    DataRefExport<double> altitudeExport(
+        "xpu/check/export/altitude", &altitude,
+        [](void* ref) { return *static_cast<double*>(ref); }, xplmType_Float | xplmType_Double);
+    report("exports", measure(10, [&](int frame) {
+        counter = frame;
+        altitude = frame * 0.5;
+        MockXPLM::readPluginDataRefs();
+    }));
+}
+
+void checkLogging()
+{
+    auto frame = [](int i) {
+        XPLANE_LOG_INFO("fuel {:.1f} kg at frame {}", 12000.0 - i * 0.01, i);
+    };
+
+    std::uint64_t direct;
+    std::uint64_t buffered;
+    {
+        DiscardStdout discard;
+        // Warm up with more distinct messages than the throttle remembers
+        // (4096), so its table has reached full size and recycles entries
+        direct = measure(5000, frame);
+        XPlaneLog::ThreadBufferOptions buffers;
+        buffers.ringBytes = 4 * 1024 * 1024; // Nothing dropped
+        XPlaneLog::enableThreadBuffers(buffers);
+        buffered = measure(5000, frame);
+        XPlaneLog::disableThreadBuffers();
+    }
+    report("logging", direct);
+    report("logging (thread buffers)", buffered);
+}
+
+void checkMenus()
+{
+    MenuItem menu("Allocation Check");
+    MenuItem::Item beacon = menu.addSubItem("Beacon", []() {});
+    MenuItem::Item fuel = menu.addSubItem("Fuel 12.0 t remaining", []() {});
+    char title[32];
+    report("menus", measure(10, [&](int frame) {
+        beacon.setChecked(frame % 2 == 0);
+        beacon.setEnabled(frame % 3 != 0);
+        std::snprintf(title, sizeof(title), "Fuel %4.1f t remaining", 12.0 - frame * 0.001);
+        fuel.setTitle(title);
+    }));
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        measuredFrames = std::atoi(argv[1]);
+        if (measuredFrames <= 0)
+        {
+            std::fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // XPlaneLog puts its file two levels above the plugin binary
+    const std::filesystem::path logDir = std::filesystem::temp_directory_path();
+    MockXPLM::setPluginPath((logDir / "64" / "check.xpl").string());
+    {
+        DiscardStdout discard;
+        XPlaneLog::init("xpu-alloc-check");
+    }
+    defineSimulator();
+
+    checkDataRefs();
+    checkBatch();
+    checkFlightData();
+    checkMetrics();
+    checkTraffic();
+    checkExports();
+    checkLogging();
+    checkMenus();
+
+    {
+        DiscardStdout discard;
+        XPlaneLog::shutdown();
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+ *   xpu-binlog-bench - Compare XPLANE_BINLOG with the XPlaneLog text path
+ *
+ *   Usage: xpu-binlog-bench [iterations]
+ *
+ *   Logs the same message with the same arguments through XPLANE_BINLOG,
+ *   through XPlaneLog's synchronous sinks (console, file and Log.txt) and
+ *   through XPlaneLog's per-thread buffers, and prints the cost per message
+ *   on the calling thread plus the bytes each path writes per message. The
+ *   binary log's flush is reported separately because it is paid at flush
+ *   or shutdown rather than at the call site. XPlaneLog runs against
+ *   mock_xplm.cpp; the console output is discarded while measuring and the
+ *   files are written to the temporary directory.
+ */
+
+#include "mock_xplm.h"
+
+#include <XPlaneUtilities/XPlaneBinaryLog.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+const char* const kPhases[] = {"taxi", "climb", "cruise", "descent"};
+
+template<typename Fn>
+double nsPerCall(long iterations, Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i)
+    {
+        fn(i);
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+double fuelFlowOf(long i)
+{
+    return 0.5 + static_cast<double>(i % 1000) * 0.001;
+}
+
+// Size of a file now, 0 if it does not exist
+double fileSize(const std::filesystem::path& path)
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    return error ? 0.0 : static_cast<double>(size);
+}
+
+// Sends stdout to /dev/null while alive so the console sink does not flood
+// the terminal or dominate the measurement
+class DiscardStdout
+{
+public:
+    DiscardStdout()
+    {
+        std::fflush(stdout);
+        saved = dup(STDOUT_FILENO);
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        close(null);
+    }
+
+    ~DiscardStdout()
+    {
+        std::fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+
+private:
+    int saved;
+};
+
+void report(const char* name, double ns, double bytes)
+{
+    std::printf("%-28s %10.1f %10.1f\n", name, ns, bytes);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    if (iterations <= 0)
+    {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    // XPlaneLog puts its files two levels above the plugin binary
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    MockXPLM::setPluginPath((dir / "64" / "bench.xpl").string());
+    const std::filesystem::path textPath = dir / "xpu-binlog-bench.log";
+    const std::filesystem::path binaryPath = dir / "xpu-binlog-bench.binlog";
+
+    double binaryNs = 0.0;
+    double flushNs = 0.0;
+    double syncNs = 0.0;
+    double bufferedNs = 0.0;
+    double binaryBytes = 0.0;
+    double syncBytes = 0.0;
+    double bufferedBytes = 0.0;
+    std::uint64_t dropped = 0;
+    {
+        DiscardStdout discard;
+
+        XPlaneLog::InitOptions options;
+        options.binaryLog = true;
+        XPlaneLog::init("xpu-binlog-bench", options);
+
+        // Unique payloads so the throttle never collapses repeats
+        XPLANE_BINLOG(spdlog::level::info, "warm up {}", 0);
+        XPlaneBinaryLog::flush();
+        const double binaryStart = fileSize(binaryPath);
+        binaryNs = nsPerCall(iterations, [](long i) {
+            XPLANE_BINLOG(spdlog::level::info, "fuel flow {:.2f} kg/s at frame {} in {}",
+                          fuelFlowOf(i), i, kPhases[i % 4]);
+        });
+        const auto flushStart = std::chrono::steady_clock::now();
+        XPlaneBinaryLog::flush();
+        const std::chrono::duration<double, std::nano> flushed =
+            std::chrono::steady_clock::now() - flushStart;
+        flushNs = flushed.count() / static_cast<double>(iterations);
+        binaryBytes = (fileSize(binaryPath) - binaryStart) / static_cast<double>(iterations);
+
+        XPLANE_LOG_CALL(spdlog::level::info, "warm up {}", 0);
+        const double syncStart = fileSize(textPath);
+        syncNs = nsPerCall(iterations, [](long i) {
+            XPLANE_LOG_CALL(spdlog::level::info, "fuel flow {:.2f} kg/s at frame {} in {}",
+                            fuelFlowOf(i), i, kPhases[i % 4]);
+        });
+        syncBytes = (fileSize(textPath) - syncStart) / static_cast<double>(iterations);
+
+        // Rings large enough that the collector never has to keep up
+        XPlaneLog::ThreadBufferOptions buffers;
+        buffers.ringBytes = 64 * 1024 * 1024;
+        XPlaneLog::enableThreadBuffers(buffers);
+        const double bufferedStart = fileSize(textPath);
+        bufferedNs = nsPerCall(iterations, [](long i) {
+            XPLANE_LOG_CALL(spdlog::level::info, "fuel flow {:.2f} kg/s at frame {} in {}",
+                            fuelFlowOf(i), i, kPhases[i % 4]);
+        });
+        dropped = XPlaneLog::getThreadBufferStats().dropped;
+        XPlaneLog::disableThreadBuffers();
+        bufferedBytes = (fileSize(textPath) - bufferedStart) / static_cast<double>(iterations);
+
+        XPlaneLog::shutdown();
+    }
+
+    std::printf("%-28s %10s %10s\n", "path (per message)", "ns", "bytes");
+    report("XPLANE_BINLOG", binaryNs, binaryBytes);
+    report("XPLANE_BINLOG flush", flushNs, 0.0);
+    report("XPlaneLog text", syncNs, syncBytes);
+    report("XPlaneLog thread buffers", bufferedNs, bufferedBytes);
+    if (dropped > 0)
+    {
+        std::printf("(thread buffers dropped %llu of %ld messages)\n",
+                    static_cast<unsigned long long>(dropped), iterations);
+    }
+    std::printf("(text log %s, binary log %s)\n", textPath.string().c_str(),
+                binaryPath.string().c_str());
+    return 0;
+}
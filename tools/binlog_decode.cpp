@@ -0,0 +1,300 @@
+/*
+ *   xpu-binlog-decode - Render an XPlaneBinaryLog file as text
+ *
+ *   Usage: xpu-binlog-decode [--min-level level] file.binlog
+ *
+ *   Records from all threads are merged by timestamp and printed in the same
+ *   layout as the XPlaneLog text sinks.
+ */
+
+#include <XPlaneUtilities/XPlaneBinaryLog.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <fmt/args.h>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+namespace
+{
+struct Format
+{
+    bool defined = false;
+    std::uint8_t level = 0;
+    std::string argTypes;
+    std::string file;
+    std::uint32_t line = 0;
+    std::string format;
+};
+
+struct Entry
+{
+    std::uint64_t timestamp;
+    std::uint32_t threadId;
+    std::uint32_t formatId;
+    std::string text;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const std::vector<char>& bytes)
+        : p(bytes.data()), end(bytes.data() + bytes.size())
+    {
+    }
+
+    bool atEnd() const { return p >= end; }
+
+    template <typename T> bool read(T& value)
+    {
+        if (static_cast<std::size_t>(end - p) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& out, std::size_t length)
+    {
+        if (static_cast<std::size_t>(end - p) < length)
+        {
+            return false;
+        }
+        out.assign(p, length);
+        p += length;
+        return true;
+    }
+
+    const char* position() const { return p; }
+    void skip(std::size_t n) { p += n; }
+
+private:
+    const char* p;
+    const char* end;
+};
+
+bool readFormat(Reader& in, std::vector<Format>& formats)
+{
+    std::uint32_t id;
+    std::uint16_t argc, fileLength;
+    std::uint32_t formatLength;
+    Format def;
+
+    if (!in.read(id) || !in.read(def.level) || !in.read(argc) ||
+        !in.readString(def.argTypes, argc) || !in.read(def.line) || !in.read(fileLength) ||
+        !in.readString(def.file, fileLength) || !in.read(formatLength) ||
+        !in.readString(def.format, formatLength))
+    {
+        return false;
+    }
+
+    def.defined = true;
+    if (id >= formats.size())
+    {
+        formats.resize(id + 1);
+    }
+    formats[id] = std::move(def);
+    return true;
+}
+
+std::string render(const Format& def, Reader& in, bool& ok)
+{
+    fmt::dynamic_format_arg_store<fmt::format_context> args;
+    ok = true;
+
+    for (char type : def.argTypes)
+    {
+        switch (type)
+        {
+        case XPlaneBinaryLog::kSigned:
+        {
+            std::int64_t v = 0;
+            ok = in.read(v);
+            args.push_back(v);
+            break;
+        }
+        case XPlaneBinaryLog::kUnsigned:
+        {
+            std::uint64_t v = 0;
+            ok = in.read(v);
+            args.push_back(v);
+            break;
+        }
+        case XPlaneBinaryLog::kDouble:
+        {
+            double v = 0.0;
+            ok = in.read(v);
+            args.push_back(v);
+            break;
+        }
+        case XPlaneBinaryLog::kBool:
+        {
+            char v = 0;
+            ok = in.read(v);
+            args.push_back(v != 0);
+            break;
+        }
+        case XPlaneBinaryLog::kChar:
+        {
+            char v = 0;
+            ok = in.read(v);
+            args.push_back(v);
+            break;
+        }
+        case XPlaneBinaryLog::kString:
+        {
+            std::uint32_t length;
+            std::string v;
+            ok = in.read(length) && in.readString(v, length);
+            args.push_back(v);
+            break;
+        }
+        default:
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return std::string();
+        }
+    }
+
+    try
+    {
+        return fmt::vformat(def.format, args);
+    }
+    catch (const fmt::format_error& e)
+    {
+        return def.format + " <format error: " + e.what() + ">";
+    }
+}
+
+std::string levelName(std::uint8_t level)
+{
+    auto name = spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(level));
+    std::string upper(name.data(), name.size());
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    return upper;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int minLevel = spdlog::level::trace;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--min-level") == 0 && i + 1 < argc)
+        {
+            minLevel = spdlog::level::from_str(argv[++i]);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (!path)
+    {
+        std::fprintf(stderr, "Usage: %s [--min-level level] file.binlog\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+
+    Reader in(bytes);
+    std::uint32_t magic, version;
+    if (!in.read(magic) || !in.read(version) || magic != XPlaneBinaryLog::kMagic ||
+        version != XPlaneBinaryLog::kVersion)
+    {
+        std::fprintf(stderr, "%s is not a version %u binary log\n", path,
+                     XPlaneBinaryLog::kVersion);
+        return 1;
+    }
+
+    std::vector<Format> formats;
+    std::vector<Entry> entries;
+    bool truncated = false;
+
+    while (!in.atEnd() && !truncated)
+    {
+        char kind;
+        in.read(kind);
+
+        if (kind == XPlaneBinaryLog::kFormatRecord)
+        {
+            truncated = !readFormat(in, formats);
+            continue;
+        }
+
+        std::uint32_t threadId, length;
+        if (kind != XPlaneBinaryLog::kDataRecord || !in.read(threadId) || !in.read(length))
+        {
+            truncated = true;
+            break;
+        }
+
+        const char* chunkEnd = in.position() + length;
+        while (in.position() < chunkEnd)
+        {
+            Entry entry;
+            entry.threadId = threadId;
+            if (!in.read(entry.formatId) || !in.read(entry.timestamp) ||
+                entry.formatId >= formats.size() || !formats[entry.formatId].defined)
+            {
+                truncated = true;
+                break;
+            }
+
+            bool ok;
+            entry.text = render(formats[entry.formatId], in, ok);
+            if (!ok)
+            {
+                truncated = true;
+                break;
+            }
+
+            if (formats[entry.formatId].level >= minLevel)
+            {
+                entries.push_back(std::move(entry));
+            }
+        }
+    }
+
+    // Thread buffers are flushed independently, so restore global order
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.timestamp < b.timestamp; });
+
+    for (const Entry& entry : entries)
+    {
+        const auto time = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(entry.timestamp)));
+        const auto ms = (entry.timestamp / 1000000) % 1000;
+        fmt::print("[{:%Y-%m-%d %H:%M:%S}.{:03}] [T{}] [{}] {}\n",
+                   fmt::localtime(std::chrono::system_clock::to_time_t(time)), ms, entry.threadId,
+                   levelName(formats[entry.formatId].level), entry.text);
+    }
+
+    if (truncated)
+    {
+        std::fprintf(stderr, "Warning: %s ends with a truncated or corrupt record\n", path);
+    }
+    return 0;
+}
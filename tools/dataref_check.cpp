@@ -0,0 +1,237 @@
+/*
+ *   xpu-dataref-check - Check declared datarefs against the simulator's DataRefs.txt
+ *
+ *   Usage: xpu-dataref-check [--cache file.idx] [--quiet] DataRefs.txt FILE...
+ *
+ *   FILE is either a declaration list with one dataref per line,
+ *
+ *       # name                                      [type]   [w]
+ *       sim/cockpit/electrical/beacon_lights_on     int      w
+ *       sim/flightmodel/position/latitude           double
+ *
+ *   or a C/C++ source file, in which every string literal starting with
+ *   "sim/" is checked for existence. Exits with 1 if any dataref is unknown,
+ *   has an unexpected type or is read-only where write access is declared.
+ */
+
+#include <XPlaneUtilities/DataRefCatalog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using XPlaneUtilities::DataRefCatalog;
+
+namespace
+{
+struct Totals
+{
+    unsigned checked = 0;
+    unsigned problems = 0;
+};
+
+void printUsage(const char* argv0)
+{
+    std::fprintf(stderr, "Usage: %s [--cache file.idx] [--quiet] DataRefs.txt FILE...\n", argv0);
+}
+
+bool isSourceFile(const std::string& path)
+{
+    static const char* const kExtensions[] = {".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp"};
+    const std::size_t dot = path.rfind('.');
+    if (dot == std::string::npos)
+    {
+        return false;
+    }
+    for (const char* ext : kExtensions)
+    {
+        if (path.compare(dot, std::string::npos, ext) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void report(const DataRefCatalog& catalog, const std::string& file, unsigned line,
+            const std::string& name, std::uint32_t types, bool needWrite, bool quiet,
+            Totals& totals)
+{
+    ++totals.checked;
+    const DataRefCatalog::Check result = catalog.check(name, types, needWrite);
+    if (result == DataRefCatalog::Check::Ok)
+    {
+        if (!quiet)
+        {
+            std::printf("%s:%u: ok %s\n", file.c_str(), line, name.c_str());
+        }
+        return;
+    }
+
+    ++totals.problems;
+    DataRefCatalog::Entry entry;
+    switch (result)
+    {
+    case DataRefCatalog::Check::Unknown:
+        std::printf("%s:%u: unknown dataref %s\n", file.c_str(), line, name.c_str());
+        break;
+    case DataRefCatalog::Check::TypeMismatch:
+        catalog.find(name, entry);
+        std::printf("%s:%u: %s is %s, declared %s\n", file.c_str(), line, name.c_str(),
+                    DataRefCatalog::typeName(entry.types).c_str(),
+                    DataRefCatalog::typeName(types).c_str());
+        break;
+    case DataRefCatalog::Check::ReadOnly:
+        std::printf("%s:%u: %s is read-only\n", file.c_str(), line, name.c_str());
+        break;
+    case DataRefCatalog::Check::Ok:
+        break;
+    }
+}
+
+// One declaration per line: name [type] [w]
+bool checkDeclarations(const DataRefCatalog& catalog, const std::string& path, bool quiet,
+                       Totals& totals)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string text;
+    unsigned lineNumber = 0;
+    while (std::getline(in, text))
+    {
+        ++lineNumber;
+        const std::size_t hash = text.find('#');
+        std::istringstream line(text.substr(0, hash));
+
+        std::string name, field;
+        if (!(line >> name))
+        {
+            continue;
+        }
+
+        std::uint32_t types = 0;
+        bool needWrite = false;
+        while (line >> field)
+        {
+            std::uint32_t arraySize;
+            if (field == "w" || field == "rw")
+            {
+                needWrite = true;
+            }
+            else if (field != "r" && !DataRefCatalog::parseType(field, types, arraySize))
+            {
+                std::printf("%s:%u: cannot parse '%s'\n", path.c_str(), lineNumber,
+                            field.c_str());
+                ++totals.problems;
+            }
+        }
+
+        report(catalog, path, lineNumber, name, types, needWrite, quiet, totals);
+    }
+    return true;
+}
+
+// Every "sim/..." string literal in a source file
+bool checkSource(const DataRefCatalog& catalog, const std::string& path, bool quiet,
+                 Totals& totals)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string text;
+    unsigned lineNumber = 0;
+    while (std::getline(in, text))
+    {
+        ++lineNumber;
+        std::size_t pos = 0;
+        while ((pos = text.find("\"sim/", pos)) != std::string::npos)
+        {
+            const std::size_t end = text.find('"', pos + 1);
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            report(catalog, path, lineNumber, text.substr(pos + 1, end - pos - 1), 0, false,
+                   quiet, totals);
+            pos = end + 1;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string cachePath;
+    bool quiet = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cachePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--quiet") == 0)
+        {
+            quiet = true;
+        }
+        else if (argv[i][0] != '-' || argv[i][1] == '\0')
+        {
+            paths.push_back(argv[i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (paths.size() < 2)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    DataRefCatalog catalog;
+    const auto start = std::chrono::steady_clock::now();
+    const bool loaded =
+        cachePath.empty() ? catalog.loadText(paths[0]) : catalog.load(paths[0], cachePath);
+    if (!loaded)
+    {
+        std::fprintf(stderr, "%s\n", catalog.error().c_str());
+        return 1;
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::fprintf(stderr, "%zu datarefs (%.*s) loaded in %.2f ms\n", catalog.size(),
+                 static_cast<int>(catalog.sourceVersion().size()), catalog.sourceVersion().data(),
+                 elapsed.count());
+
+    Totals totals;
+    for (std::size_t i = 1; i < paths.size(); ++i)
+    {
+        const bool ok = isSourceFile(paths[i]) ? checkSource(catalog, paths[i], quiet, totals)
+                                               : checkDeclarations(catalog, paths[i], quiet, totals);
+        if (!ok)
+        {
+            ++totals.problems;
+        }
+    }
+
+    std::printf("%u datarefs checked, %u problems\n", totals.checked, totals.problems);
+    return totals.problems ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/*
+ *   xpu-format-bench - Compare FlightDataFormat with the equivalent snprintf calls
+ *
+ *   Usage: xpu-format-bench [iterations]
+ */
+
+#include <XPlaneUtilities/FlightDataFormat.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace FDF = XPlaneUtilities::FlightDataFormat;
+
+namespace
+{
+unsigned long checksum = 0; // Keeps the optimiser from dropping the work
+
+template<typename Fn>
+double nsPerCall(long iterations, Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i)
+    {
+        fn(i);
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+void report(const char* name, double snprintfNs, double lutNs)
+{
+    std::printf("%-22s %10.1f %10.1f %8.1fx\n", name, snprintfNs, lutNs, snprintfNs / lutNs);
+}
+
+// Reference implementations of the same formats. Unsigned fields reduced to
+// their ranges as the library does, so the compiler can see they fit.
+int snprintfHHMM(char* out, float seconds)
+{
+    const unsigned s = static_cast<unsigned>(seconds) % 86400;
+    return std::snprintf(out, FDF::kTimeHHMMSize, "%02u%02u", s / 3600, s % 3600 / 60);
+}
+
+int snprintfHHMMSS(char* out, float seconds)
+{
+    const unsigned s = static_cast<unsigned>(seconds) % 86400;
+    return std::snprintf(out, FDF::kTimeHHMMSSSize, "%02u:%02u:%02u", s / 3600, s % 3600 / 60,
+                         s % 60);
+}
+
+int snprintfDDHHMMZ(char* out, int day, float seconds)
+{
+    const unsigned s = static_cast<unsigned>(seconds) % 86400;
+    return std::snprintf(out, FDF::kTimeDDHHMMZSize, "%02u%02u%02uZ",
+                         static_cast<unsigned>(day) % 100, s / 3600, s % 3600 / 60);
+}
+
+int snprintfLatitudeDMS(char* out, double degrees)
+{
+    const auto tenths = static_cast<unsigned long long>(std::llround(std::fabs(degrees) * 36000.0));
+    return std::snprintf(out, FDF::kLatitudeDMSSize, "%c%02llu %02llu %02llu.%llu",
+                         degrees < 0.0 ? 'S' : 'N', tenths / 36000 % 100, tenths / 600 % 60,
+                         tenths / 10 % 60, tenths % 10);
+}
+
+int snprintfDecimal(char* out, double value)
+{
+    return std::snprintf(out, FDF::kDecimalSize, "%.6f", value);
+}
+
+int snprintfFlightLevel(char* out, double feet)
+{
+    return std::snprintf(out, FDF::kAltitudeSize, "FL%03lld", std::llround(feet / 100.0));
+}
+
+// Inputs that vary per iteration
+float timeOf(long i)
+{
+    return static_cast<float>(i % 86400);
+}
+
+double latitudeOf(long i)
+{
+    return -89.0 + static_cast<double>(i % 178000) * 0.001;
+}
+
+double altitudeOf(long i)
+{
+    return static_cast<double>(i % 45000);
+}
+
+bool verify()
+{
+    char a[64];
+    char b[64];
+    bool ok = true;
+    for (long i = 0; i < 200000; i += 7)
+    {
+        snprintfHHMM(a, timeOf(i));
+        FDF::formatTimeHHMM(b, timeOf(i));
+        ok &= std::strcmp(a, b) == 0;
+        snprintfHHMMSS(a, timeOf(i));
+        FDF::formatTimeHHMMSS(b, timeOf(i));
+        ok &= std::strcmp(a, b) == 0;
+        snprintfDDHHMMZ(a, static_cast<int>(i % 31) + 1, timeOf(i));
+        FDF::formatTimeDDHHMMZ(b, static_cast<int>(i % 31) + 1, timeOf(i));
+        ok &= std::strcmp(a, b) == 0;
+        snprintfLatitudeDMS(a, latitudeOf(i));
+        FDF::formatLatitudeDMS(b, latitudeOf(i));
+        ok &= std::strcmp(a, b) == 0;
+        snprintfFlightLevel(a, altitudeOf(i));
+        FDF::formatFlightLevel(b, altitudeOf(i));
+        ok &= std::strcmp(a, b) == 0;
+        if (!ok)
+        {
+            std::fprintf(stderr, "Mismatch at %ld: '%s' vs '%s'\n", i, a, b);
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+    if (iterations <= 0)
+    {
+        std::fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    if (!verify())
+    {
+        return 1;
+    }
+
+    char buffer[64];
+    std::printf("%-22s %10s %10s %9s\n", "format (ns/call)", "snprintf", "lut", "speedup");
+
+    // The original FlightDataProvider::formatTimeHHMM path, including the std::string
+    report("HHMM std::string", nsPerCall(iterations, [&](long i) {
+               char b[FDF::kTimeHHMMSize];
+               snprintfHHMM(b, timeOf(i));
+               checksum += std::string(b).size();
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatTimeHHMM(buffer, timeOf(i));
+           }));
+
+    report("HHMM", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(snprintfHHMM(buffer, timeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatTimeHHMM(buffer, timeOf(i));
+           }));
+
+    report("HH:MM:SS", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(snprintfHHMMSS(buffer, timeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatTimeHHMMSS(buffer, timeOf(i));
+           }));
+
+    report("DDHHMMZ", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(
+                   snprintfDDHHMMZ(buffer, static_cast<int>(i % 31) + 1, timeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatTimeDDHHMMZ(buffer, static_cast<int>(i % 31) + 1, timeOf(i));
+           }));
+
+    report("latitude DMS", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(snprintfLatitudeDMS(buffer, latitudeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatLatitudeDMS(buffer, latitudeOf(i));
+           }));
+
+    report("decimal %.6f", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(snprintfDecimal(buffer, latitudeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatDecimal(buffer, latitudeOf(i), 6);
+           }));
+
+    report("flight level", nsPerCall(iterations, [&](long i) {
+               checksum += static_cast<unsigned long>(snprintfFlightLevel(buffer, altitudeOf(i)));
+           }),
+           nsPerCall(iterations, [&](long i) {
+               checksum += FDF::formatFlightLevel(buffer, altitudeOf(i));
+           }));
+
+    std::printf("(checksum %lu)\n", checksum);
+    return 0;
+}
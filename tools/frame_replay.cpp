@@ -0,0 +1,796 @@
+/*
+ *   xpu-frame-replay - Replay dataref sequences through a plugin against a mock XPLM
+ *
+ *   Usage: xpu-frame-replay [options] script.txt
+ *
+ *       --frames N              Override the frame count of the script
+ *       --warmup N              Frames left out of the statistics (default 60)
+ *       --baseline FILE         Compare with a stored baseline; exit 1 on regression
+ *       --write-baseline FILE   Store the statistics of this run
+ *       --cpu-tolerance R       Allowed relative increase of mean and p95 CPU time (0.25);
+ *                               negative reports CPU time without checking it
+ *       --alloc-tolerance N     Allowed increase of allocations per frame (0)
+ *       --sdk-tolerance N       Allowed increase of XPLM calls per frame (0)
+ *       --frames-csv FILE       Write the per-frame measurements
+ *       --log-dir DIR           Directory of the plugin's log file (default .)
+ *       --memory                Print MemoryResources statistics per component
+ *
+ *   The plugin under test is linked in (replay_workload.cpp unless
+ *   XPLANE_UTILITIES_REPLAY_PLUGIN_SOURCES names other sources) and runs
+ *   against mock_xplm.cpp. Each frame applies the script's dataref values,
+ *   then measures the menu actions due in that frame, one round of flight
+ *   loops and one read of every dataref the plugin exports: thread CPU time,
+ *   heap allocations on the main thread and XPLM calls. Allocations and XPLM
+ *   calls are deterministic, so their tolerances default to zero. CPU time is
+ *   only checked against a baseline from the same kind of build (release or
+ *   not, recorded as release_build). CI checks a Release build against
+ *   tools/replay_baseline.txt with a CPU tolerance of 2 (three times the
+ *   baseline), wide enough for shared runners.
+ *
+ *   Script, one command per line, # starts a comment:
+ *
+ *       frames 6000                       Frames to run
+ *       dt 0.016667                       Seconds per frame
+ *       read 1                            Read exported datarefs every N frames (0: never)
+ *       define NAME TYPE [VALUE] [w]      Simulator dataref; TYPE int, float, double,
+ *                                         int[N], float[N] or a|b combination
+ *       set FRAME NAME VALUE              NAME[i] sets one array element
+ *       ramp FIRST LAST NAME FROM TO      Linear change over frames FIRST..LAST
+ *       menu FRAME TITLE                  Choose a menu item
+ *       csv FILE                          Recorded values: header "frame,NAME,...",
+ *                                         one row per frame listed
+ */
+
+#include "mock_xplm.h"
+
+#include <XPlaneUtilities/MemoryResources.h>
+
+#include <XPLMDefs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The plugin under test
+PLUGIN_API int XPluginStart(char* name, char* sig, char* desc);
+PLUGIN_API int XPluginEnable();
+PLUGIN_API void XPluginDisable();
+PLUGIN_API void XPluginStop();
+PLUGIN_API void XPluginReceiveMessage(XPLMPluginID from, int message, void* param);
+
+//==========================================================================
+// Allocation counting
+//==========================================================================
+
+namespace
+{
+thread_local std::uint64_t threadAllocations = 0;
+
+void* allocate(std::size_t size)
+{
+    ++threadAllocations;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    ++threadAllocations;
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+// The array and nothrow forms forward to these in libstdc++ and libc++
+void* operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+//==========================================================================
+// Script
+//==========================================================================
+
+struct Set
+{
+    int frame;
+    std::string name;
+    int index; // -1 for scalars
+    double value;
+};
+
+struct Ramp
+{
+    int first;
+    int last;
+    std::string name;
+    double from;
+    double to;
+};
+
+struct MenuAction
+{
+    int frame;
+    std::string title;
+};
+
+struct Script
+{
+    int frames = 3600;
+    float dt = 1.0f / 60.0f;
+    int readEvery = 1;
+    std::vector<Set> sets;
+    std::vector<Ramp> ramps;
+    std::vector<MenuAction> menus;
+};
+
+bool parseType(const std::string& text, XPLMDataTypeID& types, int& arraySize)
+{
+    types = 0;
+    arraySize = 0;
+    std::istringstream parts(text);
+    std::string part;
+    while (std::getline(parts, part, '|'))
+    {
+        int size = 0;
+        const std::size_t bracket = part.find('[');
+        if (bracket != std::string::npos)
+        {
+            size = std::atoi(part.c_str() + bracket + 1);
+            part.erase(bracket);
+        }
+
+        if (part == "int")
+        {
+            types |= size ? xplmType_IntArray : xplmType_Int;
+        }
+        else if (part == "float")
+        {
+            types |= size ? xplmType_FloatArray : xplmType_Float;
+        }
+        else if (part == "double" && !size)
+        {
+            types |= xplmType_Double;
+        }
+        else
+        {
+            return false;
+        }
+        arraySize = std::max(arraySize, size);
+    }
+    return types != 0;
+}
+
+// "name[3]" -> name, 3
+void splitElement(const std::string& text, std::string& name, int& index)
+{
+    const std::size_t bracket = text.find('[');
+    name = text.substr(0, bracket);
+    index = bracket == std::string::npos ? -1 : std::atoi(text.c_str() + bracket + 1);
+}
+
+std::vector<std::string> splitCsv(const std::string& text)
+{
+    std::vector<std::string> fields(1);
+    for (const char c : text)
+    {
+        if (c == ',')
+        {
+            fields.emplace_back();
+        }
+        else if (c != '\r')
+        {
+            fields.back().push_back(c);
+        }
+    }
+    return fields;
+}
+
+std::string directoryOf(const std::string& path)
+{
+    const std::size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+bool loadCsv(const std::string& path, Script& script)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string text;
+    std::getline(in, text);
+    const std::vector<std::string> header = splitCsv(text);
+    std::vector<std::string> names(header.size());
+    std::vector<int> indices(header.size(), -1);
+    for (std::size_t column = 1; column < header.size(); ++column)
+    {
+        splitElement(header[column], names[column], indices[column]);
+        if (!MockXPLM::hasDataRef(names[column]))
+        {
+            MockXPLM::defineDataRef(names[column], xplmType_Float | xplmType_Double, false);
+        }
+    }
+
+    unsigned lineNumber = 1;
+    while (std::getline(in, text))
+    {
+        ++lineNumber;
+        const std::vector<std::string> fields = splitCsv(text);
+        if (fields.size() == 1 && fields[0].empty())
+        {
+            continue;
+        }
+        if (fields.size() != header.size())
+        {
+            std::fprintf(stderr, "%s:%u: expected %zu columns\n", path.c_str(), lineNumber,
+                         header.size());
+            return false;
+        }
+
+        const int frame = std::atoi(fields[0].c_str());
+        for (std::size_t column = 1; column < fields.size(); ++column)
+        {
+            // Empty fields leave the value unchanged
+            if (!fields[column].empty())
+            {
+                script.sets.push_back({frame, names[column], indices[column],
+                                       std::atof(fields[column].c_str())});
+            }
+        }
+    }
+    return true;
+}
+
+bool loadScript(const std::string& path, Script& script)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    std::string text;
+    unsigned lineNumber = 0;
+    while (std::getline(in, text))
+    {
+        ++lineNumber;
+        std::istringstream line(text.substr(0, text.find('#')));
+        std::string command;
+        if (!(line >> command))
+        {
+            continue;
+        }
+
+        bool ok = true;
+        if (command == "frames")
+        {
+            ok = static_cast<bool>(line >> script.frames);
+        }
+        else if (command == "dt")
+        {
+            ok = static_cast<bool>(line >> script.dt);
+        }
+        else if (command == "read")
+        {
+            ok = static_cast<bool>(line >> script.readEvery);
+        }
+        else if (command == "define")
+        {
+            std::string name, type, field;
+            XPLMDataTypeID types;
+            int arraySize;
+            ok = (line >> name >> type) && parseType(type, types, arraySize);
+            bool writable = false;
+            double value = 0.0;
+            while (ok && line >> field)
+            {
+                if (field == "w")
+                {
+                    writable = true;
+                }
+                else
+                {
+                    value = std::atof(field.c_str());
+                }
+            }
+            ok = ok && MockXPLM::defineDataRef(name, types, writable, arraySize) &&
+                 MockXPLM::setValue(name, value);
+        }
+        else if (command == "set")
+        {
+            Set set;
+            std::string target;
+            ok = static_cast<bool>(line >> set.frame >> target >> set.value);
+            splitElement(target, set.name, set.index);
+            script.sets.push_back(set);
+        }
+        else if (command == "ramp")
+        {
+            Ramp ramp;
+            ok = static_cast<bool>(line >> ramp.first >> ramp.last >> ramp.name >> ramp.from >>
+                                   ramp.to) &&
+                 ramp.last >= ramp.first;
+            script.ramps.push_back(ramp);
+        }
+        else if (command == "menu")
+        {
+            MenuAction action;
+            ok = static_cast<bool>(line >> action.frame);
+            std::getline(line >> std::ws, action.title);
+            ok = ok && !action.title.empty();
+            script.menus.push_back(action);
+        }
+        else if (command == "csv")
+        {
+            std::string file;
+            ok = static_cast<bool>(line >> file);
+            if (ok && !loadCsv(file[0] == '/' ? file : directoryOf(path) + file, script))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::fprintf(stderr, "%s:%u: cannot parse '%s'\n", path.c_str(), lineNumber,
+                         text.c_str());
+            return false;
+        }
+    }
+
+    std::stable_sort(script.sets.begin(), script.sets.end(),
+                     [](const Set& a, const Set& b) { return a.frame < b.frame; });
+    std::stable_sort(script.menus.begin(), script.menus.end(),
+                     [](const MenuAction& a, const MenuAction& b) { return a.frame < b.frame; });
+    return true;
+}
+
+//==========================================================================
+// Measurement
+//==========================================================================
+
+struct FrameSample
+{
+    double cpuMicroseconds;
+    std::uint64_t allocations;
+    std::uint64_t sdkCalls;
+};
+
+struct Summary
+{
+    std::map<std::string, double> values;
+};
+
+// CPU times of optimised and unoptimised builds are not comparable
+#ifdef NDEBUG
+constexpr double kReleaseBuild = 1.0;
+#else
+constexpr double kReleaseBuild = 0.0;
+#endif
+
+double threadCpuMicroseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e6 + static_cast<double>(ts.tv_nsec) / 1e3;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    const std::size_t index = static_cast<std::size_t>(
+        std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, index ? index - 1 : 0)];
+}
+
+Summary summarize(const std::vector<FrameSample>& samples)
+{
+    Summary summary;
+    std::vector<double> cpu;
+    double cpuSum = 0.0, allocSum = 0.0, sdkSum = 0.0;
+    double allocMax = 0.0, sdkMax = 0.0;
+    for (const FrameSample& sample : samples)
+    {
+        cpu.push_back(sample.cpuMicroseconds);
+        cpuSum += sample.cpuMicroseconds;
+        allocSum += static_cast<double>(sample.allocations);
+        sdkSum += static_cast<double>(sample.sdkCalls);
+        allocMax = std::max(allocMax, static_cast<double>(sample.allocations));
+        sdkMax = std::max(sdkMax, static_cast<double>(sample.sdkCalls));
+    }
+    std::sort(cpu.begin(), cpu.end());
+
+    const double n = samples.empty() ? 1.0 : static_cast<double>(samples.size());
+    summary.values["frames"] = static_cast<double>(samples.size());
+    summary.values["release_build"] = kReleaseBuild;
+    summary.values["cpu_mean_us"] = cpuSum / n;
+    summary.values["cpu_p50_us"] = percentile(cpu, 0.50);
+    summary.values["cpu_p95_us"] = percentile(cpu, 0.95);
+    summary.values["cpu_p99_us"] = percentile(cpu, 0.99);
+    summary.values["cpu_max_us"] = cpu.empty() ? 0.0 : cpu.back();
+    summary.values["allocations_mean"] = allocSum / n;
+    summary.values["allocations_max"] = allocMax;
+    summary.values["sdk_calls_mean"] = sdkSum / n;
+    summary.values["sdk_calls_max"] = sdkMax;
+    return summary;
+}
+
+//==========================================================================
+// Baseline
+//==========================================================================
+
+bool writeBaseline(const std::string& path, const Summary& summary)
+{
+    std::ofstream out(path, std::ios::trunc);
+    out << "# xpu-frame-replay baseline\n";
+    char value[64];
+    for (const auto& entry : summary.values)
+    {
+        std::snprintf(value, sizeof(value), "%.4f", entry.second);
+        out << entry.first << '=' << value << '\n';
+    }
+    if (!out)
+    {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool readBaseline(const std::string& path, Summary& summary)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "Cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::string text;
+    while (std::getline(in, text))
+    {
+        const std::size_t equals = text.find('=');
+        if (text.empty() || text[0] == '#' || equals == std::string::npos)
+        {
+            continue;
+        }
+        summary.values[text.substr(0, equals)] = std::atof(text.c_str() + equals + 1);
+    }
+    return true;
+}
+
+struct Tolerances
+{
+    double cpu = 0.25;  // Relative
+    double alloc = 0.0; // Absolute, per frame
+    double sdk = 0.0;   // Absolute, per frame
+};
+
+// Prints one row per metric; returns false if any checked metric regressed
+bool compare(const Summary& baseline, const Summary& current, const Tolerances& tolerances)
+{
+    struct Check
+    {
+        const char* key;
+        double limit; // Negative: reported only
+        bool relative;
+    };
+    const auto built = baseline.values.find("release_build");
+    const bool sameBuild = built == baseline.values.end() || built->second == kReleaseBuild;
+    if (!sameBuild)
+    {
+        std::printf("CPU time not checked: the baseline is from a %s build\n",
+                    built->second != 0.0 ? "release" : "non-release");
+    }
+    const double cpu = sameBuild ? tolerances.cpu : -1.0;
+
+    const Check checks[] = {
+        {"cpu_mean_us", cpu, true},                 {"cpu_p50_us", -1.0, true},
+        {"cpu_p95_us", cpu, true},                  {"cpu_p99_us", -1.0, true},
+        {"cpu_max_us", -1.0, true},                 {"allocations_mean", tolerances.alloc, false},
+        {"allocations_max", tolerances.alloc, false}, {"sdk_calls_mean", tolerances.sdk, false},
+        {"sdk_calls_max", tolerances.sdk, false},
+    };
+
+    bool ok = true;
+    std::printf("%-18s %12s %12s %9s\n", "metric", "baseline", "current", "change");
+    for (const Check& check : checks)
+    {
+        auto it = baseline.values.find(check.key);
+        const double now = current.values.at(check.key);
+        if (it == baseline.values.end())
+        {
+            std::printf("%-18s %12s %12.2f\n", check.key, "-", now);
+            continue;
+        }
+
+        const double before = it->second;
+        const double allowed = check.relative ? before * (1.0 + check.limit) : before + check.limit;
+        // Rounding of the stored value must not count as a regression
+        const bool regressed = check.limit >= 0.0 && now > allowed + 1e-4;
+        ok = ok && !regressed;
+
+        const double change = before != 0.0 ? (now - before) / before * 100.0 : 0.0;
+        std::printf("%-18s %12.2f %12.2f %+8.1f%%%s\n", check.key, before, now, change,
+                    regressed ? "  REGRESSION" : "");
+    }
+    return ok;
+}
+
+void printUsage(const char* argv0)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [--frames N] [--warmup N] [--baseline FILE] [--write-baseline FILE]\n"
+                 "       [--cpu-tolerance R] [--alloc-tolerance N] [--sdk-tolerance N]\n"
+                 "       [--frames-csv FILE] [--log-dir DIR] [--memory] script.txt\n",
+                 argv0);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string scriptPath, baselinePath, writeBaselinePath, framesCsvPath, logDir = ".";
+    int frames = -1;
+    int warmup = 60;
+    bool memory = false;
+    Tolerances tolerances;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+        {
+            warmup = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--write-baseline") == 0 && hasValue)
+        {
+            writeBaselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--cpu-tolerance") == 0 && hasValue)
+        {
+            tolerances.cpu = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--alloc-tolerance") == 0 && hasValue)
+        {
+            tolerances.alloc = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--sdk-tolerance") == 0 && hasValue)
+        {
+            tolerances.sdk = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--frames-csv") == 0 && hasValue)
+        {
+            framesCsvPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--log-dir") == 0 && hasValue)
+        {
+            logDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--memory") == 0)
+        {
+            memory = true;
+        }
+        else if (argv[i][0] != '-' && scriptPath.empty())
+        {
+            scriptPath = argv[i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (scriptPath.empty())
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    Script script;
+    if (!loadScript(scriptPath, script))
+    {
+        return 2;
+    }
+    if (frames >= 0)
+    {
+        script.frames = frames;
+    }
+
+    // XPlaneLog puts its file two levels above the plugin binary
+    MockXPLM::setPluginPath(logDir + "/64/replay.xpl");
+    if (memory)
+    {
+        XPlaneUtilities::MemoryResources::enableAccounting();
+    }
+
+    char name[256] = {}, sig[256] = {}, desc[256] = {};
+    if (!XPluginStart(name, sig, desc) || !XPluginEnable())
+    {
+        std::fprintf(stderr, "Plugin failed to start\n");
+        return 2;
+    }
+
+    std::vector<FrameSample> samples;
+    samples.reserve(static_cast<std::size_t>(std::max(0, script.frames - warmup)));
+    std::size_t nextSet = 0, nextMenu = 0;
+    std::size_t accessorReads = 0;
+
+    for (int frame = 0; frame < script.frames; ++frame)
+    {
+        // Simulator side, not measured
+        for (; nextSet < script.sets.size() && script.sets[nextSet].frame <= frame; ++nextSet)
+        {
+            const Set& set = script.sets[nextSet];
+            const bool ok = set.index < 0 ? MockXPLM::setValue(set.name, set.value)
+                                          : MockXPLM::setElement(set.name, set.index, set.value);
+            if (!ok)
+            {
+                std::fprintf(stderr, "Frame %d: cannot set %s\n", frame, set.name.c_str());
+            }
+        }
+        for (const Ramp& ramp : script.ramps)
+        {
+            if (frame >= ramp.first && frame <= ramp.last)
+            {
+                const double t = ramp.last > ramp.first
+                                     ? static_cast<double>(frame - ramp.first) / (ramp.last - ramp.first)
+                                     : 1.0;
+                MockXPLM::setValue(ramp.name, ramp.from + (ramp.to - ramp.from) * t);
+            }
+        }
+
+        // Plugin side
+        const std::uint64_t callsBefore = MockXPLM::sdkCalls();
+        const std::uint64_t allocationsBefore = threadAllocations;
+        const double cpuBefore = threadCpuMicroseconds();
+
+        for (; nextMenu < script.menus.size() && script.menus[nextMenu].frame <= frame; ++nextMenu)
+        {
+            if (!MockXPLM::chooseMenuItem(script.menus[nextMenu].title))
+            {
+                std::fprintf(stderr, "Frame %d: no menu item '%s'\n", frame,
+                             script.menus[nextMenu].title.c_str());
+            }
+        }
+        MockXPLM::runFrame(script.dt);
+        if (script.readEvery > 0 && frame % script.readEvery == 0)
+        {
+            accessorReads += MockXPLM::readPluginDataRefs();
+        }
+
+        const double cpu = threadCpuMicroseconds() - cpuBefore;
+        const std::uint64_t allocations = threadAllocations - allocationsBefore;
+        const std::uint64_t calls = MockXPLM::sdkCalls() - callsBefore;
+        if (frame >= warmup)
+        {
+            samples.push_back({cpu, allocations, calls});
+        }
+    }
+
+    std::printf("%d frames (%zu measured), %zu flight loops, %zu exported datarefs, "
+                "%zu accessor reads\n",
+                script.frames, samples.size(), MockXPLM::flightLoopCount(),
+                MockXPLM::pluginDataRefs().size(), accessorReads);
+
+    if (memory)
+    {
+        using XPlaneUtilities::MemoryComponent;
+        using XPlaneUtilities::MemoryResources;
+        for (int i = 0; i < static_cast<int>(MemoryComponent::Count); ++i)
+        {
+            const auto component = static_cast<MemoryComponent>(i);
+            const auto stats = MemoryResources::getStats(component);
+            std::printf("memory %-10s %8llu allocations %10llu bytes, peak %llu in use\n",
+                        MemoryResources::name(component),
+                        static_cast<unsigned long long>(stats.allocations),
+                        static_cast<unsigned long long>(stats.bytesAllocated),
+                        static_cast<unsigned long long>(stats.peakBytesInUse));
+        }
+    }
+
+    XPluginDisable();
+    XPluginStop();
+
+    if (!framesCsvPath.empty())
+    {
+        std::ofstream out(framesCsvPath, std::ios::trunc);
+        out << "frame,cpu_us,allocations,sdk_calls\n";
+        char row[96];
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            std::snprintf(row, sizeof(row), "%zu,%.3f,%llu,%llu\n",
+                          i + static_cast<std::size_t>(std::max(0, warmup)),
+                          samples[i].cpuMicroseconds,
+                          static_cast<unsigned long long>(samples[i].allocations),
+                          static_cast<unsigned long long>(samples[i].sdkCalls));
+            out << row;
+        }
+    }
+
+    const Summary current = summarize(samples);
+    if (!writeBaselinePath.empty() && !writeBaseline(writeBaselinePath, current))
+    {
+        return 2;
+    }
+
+    if (baselinePath.empty())
+    {
+        compare(Summary(), current, tolerances);
+        return 0;
+    }
+
+    Summary baseline;
+    if (!readBaseline(baselinePath, baseline))
+    {
+        return 2;
+    }
+    if (!compare(baseline, current, tolerances))
+    {
+        std::printf("Regression against %s\n", baselinePath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1062 @@
+#include "mock_xplm.h"
+
+#include <XPLMMenus.h>
+#include <XPLMPlugin.h>
+#include <XPLMProcessing.h>
+#include <XPLMUtilities.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+
+namespace
+{
+//==========================================================================
+// State
+//==========================================================================
+
+struct DataRef
+{
+    std::string name;
+    XPLMDataTypeID types = xplmType_Unknown;
+    bool writable = false;
+    bool plugin = false; // Registered by the plugin
+
+    // Simulator storage
+    double value = 0.0;
+    std::vector<double> elements;
+
+    // Plugin accessors
+    XPLMGetDatai_f getInt = nullptr;
+    XPLMSetDatai_f setInt = nullptr;
+    XPLMGetDataf_f getFloat = nullptr;
+    XPLMSetDataf_f setFloat = nullptr;
+    XPLMGetDatad_f getDouble = nullptr;
+    XPLMSetDatad_f setDouble = nullptr;
+    XPLMGetDatavi_f getIntArray = nullptr;
+    XPLMSetDatavi_f setIntArray = nullptr;
+    XPLMGetDatavf_f getFloatArray = nullptr;
+    XPLMSetDatavf_f setFloatArray = nullptr;
+    XPLMGetDatab_f getData = nullptr;
+    XPLMSetDatab_f setData = nullptr;
+    void* readRefcon = nullptr;
+    void* writeRefcon = nullptr;
+};
+
+struct FlightLoop
+{
+    XPLMCreateFlightLoop_t params;
+    bool alive = true;
+    bool scheduled = false;
+    bool inFrames = false; // Due at a cycle rather than a time
+    int dueCycle = 0;
+    double dueTime = 0.0;
+    double lastCall = 0.0;
+    XPLMFlightLoop_f legacyCallback = nullptr; // XPLMRegisterFlightLoopCallback
+};
+
+struct MenuEntry
+{
+    std::string title;
+    void* itemRef = nullptr;
+    XPLMCommandRef command = nullptr;
+    bool separator = false;
+    bool enabled = true;
+    XPLMMenuCheck check = xplm_Menu_NoCheck;
+};
+
+struct Menu
+{
+    std::string title;
+    XPLMMenuHandler_f handler = nullptr;
+    void* menuRef = nullptr;
+    std::vector<MenuEntry> items;
+    bool alive = true;
+};
+
+struct CommandHandler
+{
+    XPLMCommandCallback_f callback;
+    int before;
+    void* refcon;
+};
+
+struct Command
+{
+    std::string name;
+    std::string description;
+    std::vector<CommandHandler> handlers;
+};
+
+// unique_ptr keeps handles stable while the maps and lists grow
+std::map<std::string, std::unique_ptr<DataRef>> dataRefs;
+std::vector<std::unique_ptr<FlightLoop>> flightLoops;
+std::vector<std::unique_ptr<Menu>> menus;
+Menu pluginsMenu; // XPLMFindPluginsMenu
+std::map<std::string, std::unique_ptr<Command>> commands;
+
+// Per thread, so calls from logging threads do not blur the frame counts
+thread_local std::uint64_t calls = 0;
+double elapsed = 0.0;
+int cycle = 0;
+std::string pluginPath = "replay/64/replay.xpl";
+
+void count()
+{
+    ++calls;
+}
+
+DataRef* ref(XPLMDataRef handle)
+{
+    return static_cast<DataRef*>(handle);
+}
+
+Menu* menu(XPLMMenuID id)
+{
+    return static_cast<Menu*>(id);
+}
+
+MenuEntry* menuEntry(XPLMMenuID id, int index)
+{
+    Menu* m = menu(id);
+    if (!m || index < 0 || index >= static_cast<int>(m->items.size()))
+    {
+        return nullptr;
+    }
+    return &m->items[static_cast<std::size_t>(index)];
+}
+
+void schedule(FlightLoop& loop, float interval)
+{
+    loop.scheduled = interval != 0.0f;
+    loop.inFrames = interval < 0.0f;
+    if (loop.inFrames)
+    {
+        loop.dueCycle = cycle + std::max(1, static_cast<int>(-interval));
+    }
+    else
+    {
+        loop.dueTime = elapsed + interval;
+    }
+}
+
+// Begin or end phase: handlers that run before X-Plane first; a handler
+// returning 0 stops the rest
+void runCommand(Command& command, XPLMCommandPhase phase)
+{
+    const std::vector<CommandHandler> handlers = command.handlers;
+    for (int before = 1; before >= 0; --before)
+    {
+        for (const CommandHandler& handler : handlers)
+        {
+            if (handler.before == before &&
+                !handler.callback(&command, phase, handler.refcon))
+            {
+                return;
+            }
+        }
+    }
+}
+
+template<typename T>
+int copyElements(const DataRef& r, T* out, int offset, int max)
+{
+    const int size = static_cast<int>(r.elements.size());
+    if (!out)
+    {
+        return size;
+    }
+    const int n = std::max(0, std::min(max, size - offset));
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] = static_cast<T>(r.elements[static_cast<std::size_t>(offset + i)]);
+    }
+    return n;
+}
+
+template<typename T>
+void storeElements(DataRef& r, const T* values, int offset, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const int index = offset + i;
+        if (index >= 0 && index < static_cast<int>(r.elements.size()))
+        {
+            r.elements[static_cast<std::size_t>(index)] = values[i];
+        }
+    }
+}
+} // namespace
+
+//==========================================================================
+// Harness control
+//==========================================================================
+
+namespace MockXPLM
+{
+
+bool defineDataRef(const std::string& name, XPLMDataTypeID types, bool writable, int arraySize)
+{
+    auto& slot = dataRefs[name];
+    if (slot && slot->plugin)
+    {
+        return false;
+    }
+    if (!slot)
+    {
+        slot = std::make_unique<DataRef>();
+    }
+    slot->name = name;
+    slot->types = types;
+    slot->writable = writable;
+    slot->elements.assign(static_cast<std::size_t>(std::max(0, arraySize)), 0.0);
+    return true;
+}
+
+bool setValue(const std::string& name, double value)
+{
+    auto it = dataRefs.find(name);
+    if (it == dataRefs.end())
+    {
+        return false;
+    }
+
+    DataRef& r = *it->second;
+    if (!r.plugin)
+    {
+        r.value = value;
+        return true;
+    }
+    if (r.setDouble)
+    {
+        r.setDouble(r.writeRefcon, value);
+    }
+    else if (r.setFloat)
+    {
+        r.setFloat(r.writeRefcon, static_cast<float>(value));
+    }
+    else if (r.setInt)
+    {
+        r.setInt(r.writeRefcon, static_cast<int>(value));
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool setElement(const std::string& name, int index, double value)
+{
+    auto it = dataRefs.find(name);
+    if (it == dataRefs.end() || index < 0)
+    {
+        return false;
+    }
+
+    DataRef& r = *it->second;
+    if (!r.plugin)
+    {
+        if (index >= static_cast<int>(r.elements.size()))
+        {
+            return false;
+        }
+        r.elements[static_cast<std::size_t>(index)] = value;
+        return true;
+    }
+    if (r.setFloatArray)
+    {
+        float v = static_cast<float>(value);
+        r.setFloatArray(r.writeRefcon, &v, index, 1);
+    }
+    else if (r.setIntArray)
+    {
+        int v = static_cast<int>(value);
+        r.setIntArray(r.writeRefcon, &v, index, 1);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool hasDataRef(const std::string& name)
+{
+    return dataRefs.count(name) != 0;
+}
+
+bool getValue(const std::string& name, double& value)
+{
+    auto it = dataRefs.find(name);
+    if (it == dataRefs.end())
+    {
+        return false;
+    }
+
+    const DataRef& r = *it->second;
+    if (!r.plugin)
+    {
+        value = r.value;
+    }
+    else if (r.getDouble)
+    {
+        value = r.getDouble(r.readRefcon);
+    }
+    else if (r.getFloat)
+    {
+        value = r.getFloat(r.readRefcon);
+    }
+    else if (r.getInt)
+    {
+        value = r.getInt(r.readRefcon);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> pluginDataRefs()
+{
+    std::vector<std::string> names;
+    for (const auto& entry : dataRefs)
+    {
+        if (entry.second->plugin)
+        {
+            names.push_back(entry.first);
+        }
+    }
+    return names;
+}
+
+std::size_t readPluginDataRefs()
+{
+    static std::vector<int> ints;
+    static std::vector<float> floats;
+    static std::vector<char> bytes;
+
+    std::size_t reads = 0;
+    for (const auto& entry : dataRefs)
+    {
+        const DataRef& r = *entry.second;
+        if (!r.plugin)
+        {
+            continue;
+        }
+        if ((r.types & xplmType_Int) && r.getInt)
+        {
+            r.getInt(r.readRefcon);
+            ++reads;
+        }
+        if ((r.types & xplmType_Float) && r.getFloat)
+        {
+            r.getFloat(r.readRefcon);
+            ++reads;
+        }
+        if ((r.types & xplmType_Double) && r.getDouble)
+        {
+            r.getDouble(r.readRefcon);
+            ++reads;
+        }
+        if ((r.types & xplmType_IntArray) && r.getIntArray)
+        {
+            ints.resize(static_cast<std::size_t>(std::max(0, r.getIntArray(r.readRefcon, nullptr, 0, 0))));
+            r.getIntArray(r.readRefcon, ints.data(), 0, static_cast<int>(ints.size()));
+            reads += 2;
+        }
+        if ((r.types & xplmType_FloatArray) && r.getFloatArray)
+        {
+            floats.resize(static_cast<std::size_t>(std::max(0, r.getFloatArray(r.readRefcon, nullptr, 0, 0))));
+            r.getFloatArray(r.readRefcon, floats.data(), 0, static_cast<int>(floats.size()));
+            reads += 2;
+        }
+        if ((r.types & xplmType_Data) && r.getData)
+        {
+            bytes.resize(static_cast<std::size_t>(std::max(0, r.getData(r.readRefcon, nullptr, 0, 0))));
+            r.getData(r.readRefcon, bytes.data(), 0, static_cast<int>(bytes.size()));
+            reads += 2;
+        }
+    }
+    return reads;
+}
+
+void runFrame(float dt)
+{
+    ++cycle;
+    elapsed += dt;
+
+    for (int phase : {xplm_FlightLoop_Phase_BeforeFlightModel,
+                      xplm_FlightLoop_Phase_AfterFlightModel})
+    {
+        // Loops created by a callback run from the next frame on
+        const std::size_t count = flightLoops.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            FlightLoop& loop = *flightLoops[i];
+            if (!loop.alive || !loop.scheduled || loop.params.phase != phase)
+            {
+                continue;
+            }
+            if (loop.inFrames ? cycle < loop.dueCycle : elapsed < loop.dueTime)
+            {
+                continue;
+            }
+
+            const float sinceLastCall = static_cast<float>(elapsed - loop.lastCall);
+            loop.lastCall = elapsed;
+            const float next = loop.params.callbackFunc(sinceLastCall, dt, cycle, loop.params.refcon);
+            if (loop.alive)
+            {
+                schedule(loop, next);
+            }
+        }
+    }
+
+    flightLoops.erase(std::remove_if(flightLoops.begin(), flightLoops.end(),
+                                     [](const std::unique_ptr<FlightLoop>& loop)
+                                     { return !loop->alive; }),
+                      flightLoops.end());
+}
+
+std::size_t flightLoopCount()
+{
+    return static_cast<std::size_t>(
+        std::count_if(flightLoops.begin(), flightLoops.end(),
+                      [](const std::unique_ptr<FlightLoop>& loop) { return loop->alive; }));
+}
+
+bool chooseMenuItem(const std::string& title)
+{
+    // No allocation here: the harness measures the menu action that runs
+    auto choose = [&title](Menu& m)
+    {
+        for (const MenuEntry& item : m.items)
+        {
+            if (item.separator || !item.enabled || item.title != title)
+            {
+                continue;
+            }
+            if (item.command)
+            {
+                Command& command = *static_cast<Command*>(item.command);
+                runCommand(command, xplm_CommandBegin);
+                runCommand(command, xplm_CommandEnd);
+            }
+            else if (m.handler)
+            {
+                m.handler(m.menuRef, item.itemRef);
+            }
+            return true;
+        }
+        return false;
+    };
+
+    if (choose(pluginsMenu))
+    {
+        return true;
+    }
+    // By index: the action may create menus
+    for (std::size_t i = 0; i < menus.size(); ++i)
+    {
+        if (menus[i]->alive && choose(*menus[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void setPluginPath(const std::string& path)
+{
+    pluginPath = path;
+}
+
+std::uint64_t sdkCalls()
+{
+    return calls;
+}
+
+} // namespace MockXPLM
+
+//==========================================================================
+// XPLMDataAccess
+//==========================================================================
+
+XPLMDataRef XPLMFindDataRef(const char* name)
+{
+    count();
+    auto it = dataRefs.find(name);
+    return it == dataRefs.end() ? nullptr : it->second.get();
+}
+
+int XPLMCanWriteDataRef(XPLMDataRef handle)
+{
+    count();
+    return handle && ref(handle)->writable;
+}
+
+int XPLMIsDataRefGood(XPLMDataRef handle)
+{
+    count();
+    return handle != nullptr;
+}
+
+XPLMDataTypeID XPLMGetDataRefTypes(XPLMDataRef handle)
+{
+    count();
+    return handle ? ref(handle)->types : xplmType_Unknown;
+}
+
+int XPLMGetDatai(XPLMDataRef handle)
+{
+    count();
+    const DataRef* r = ref(handle);
+    if (!r)
+    {
+        return 0;
+    }
+    return r->plugin ? (r->getInt ? r->getInt(r->readRefcon) : 0) : static_cast<int>(r->value);
+}
+
+void XPLMSetDatai(XPLMDataRef handle, int value)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (!r || !r->writable)
+    {
+        return;
+    }
+    if (!r->plugin)
+    {
+        r->value = value;
+    }
+    else if (r->setInt)
+    {
+        r->setInt(r->writeRefcon, value);
+    }
+}
+
+float XPLMGetDataf(XPLMDataRef handle)
+{
+    count();
+    const DataRef* r = ref(handle);
+    if (!r)
+    {
+        return 0.0f;
+    }
+    return r->plugin ? (r->getFloat ? r->getFloat(r->readRefcon) : 0.0f)
+                     : static_cast<float>(r->value);
+}
+
+void XPLMSetDataf(XPLMDataRef handle, float value)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (!r || !r->writable)
+    {
+        return;
+    }
+    if (!r->plugin)
+    {
+        r->value = value;
+    }
+    else if (r->setFloat)
+    {
+        r->setFloat(r->writeRefcon, value);
+    }
+}
+
+double XPLMGetDatad(XPLMDataRef handle)
+{
+    count();
+    const DataRef* r = ref(handle);
+    if (!r)
+    {
+        return 0.0;
+    }
+    return r->plugin ? (r->getDouble ? r->getDouble(r->readRefcon) : 0.0) : r->value;
+}
+
+void XPLMSetDatad(XPLMDataRef handle, double value)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (!r || !r->writable)
+    {
+        return;
+    }
+    if (!r->plugin)
+    {
+        r->value = value;
+    }
+    else if (r->setDouble)
+    {
+        r->setDouble(r->writeRefcon, value);
+    }
+}
+
+int XPLMGetDatavi(XPLMDataRef handle, int* values, int offset, int max)
+{
+    count();
+    const DataRef* r = ref(handle);
+    if (!r)
+    {
+        return 0;
+    }
+    if (r->plugin)
+    {
+        return r->getIntArray ? r->getIntArray(r->readRefcon, values, offset, max) : 0;
+    }
+    return copyElements(*r, values, offset, max);
+}
+
+void XPLMSetDatavi(XPLMDataRef handle, int* values, int offset, int count_)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (!r || !r->writable)
+    {
+        return;
+    }
+    if (!r->plugin)
+    {
+        storeElements(*r, values, offset, count_);
+    }
+    else if (r->setIntArray)
+    {
+        r->setIntArray(r->writeRefcon, values, offset, count_);
+    }
+}
+
+int XPLMGetDatavf(XPLMDataRef handle, float* values, int offset, int max)
+{
+    count();
+    const DataRef* r = ref(handle);
+    if (!r)
+    {
+        return 0;
+    }
+    if (r->plugin)
+    {
+        return r->getFloatArray ? r->getFloatArray(r->readRefcon, values, offset, max) : 0;
+    }
+    return copyElements(*r, values, offset, max);
+}
+
+void XPLMSetDatavf(XPLMDataRef handle, float* values, int offset, int count_)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (!r || !r->writable)
+    {
+        return;
+    }
+    if (!r->plugin)
+    {
+        storeElements(*r, values, offset, count_);
+    }
+    else if (r->setFloatArray)
+    {
+        r->setFloatArray(r->writeRefcon, values, offset, count_);
+    }
+}
+
+int XPLMGetDatab(XPLMDataRef handle, void* values, int offset, int max)
+{
+    count();
+    const DataRef* r = ref(handle);
+    return r && r->plugin && r->getData ? r->getData(r->readRefcon, values, offset, max) : 0;
+}
+
+void XPLMSetDatab(XPLMDataRef handle, void* values, int offset, int count_)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (r && r->writable && r->plugin && r->setData)
+    {
+        r->setData(r->writeRefcon, values, offset, count_);
+    }
+}
+
+XPLMDataRef XPLMRegisterDataAccessor(const char* name, XPLMDataTypeID types, int writable,
+                                     XPLMGetDatai_f getInt, XPLMSetDatai_f setInt,
+                                     XPLMGetDataf_f getFloat, XPLMSetDataf_f setFloat,
+                                     XPLMGetDatad_f getDouble, XPLMSetDatad_f setDouble,
+                                     XPLMGetDatavi_f getIntArray, XPLMSetDatavi_f setIntArray,
+                                     XPLMGetDatavf_f getFloatArray, XPLMSetDatavf_f setFloatArray,
+                                     XPLMGetDatab_f getData, XPLMSetDatab_f setData,
+                                     void* readRefcon, void* writeRefcon)
+{
+    count();
+    auto& slot = dataRefs[name];
+    if (slot)
+    {
+        return nullptr; // Name already taken
+    }
+
+    slot = std::make_unique<DataRef>();
+    DataRef& r = *slot;
+    r.name = name;
+    r.types = types;
+    r.writable = writable != 0;
+    r.plugin = true;
+    r.getInt = getInt;
+    r.setInt = setInt;
+    r.getFloat = getFloat;
+    r.setFloat = setFloat;
+    r.getDouble = getDouble;
+    r.setDouble = setDouble;
+    r.getIntArray = getIntArray;
+    r.setIntArray = setIntArray;
+    r.getFloatArray = getFloatArray;
+    r.setFloatArray = setFloatArray;
+    r.getData = getData;
+    r.setData = setData;
+    r.readRefcon = readRefcon;
+    r.writeRefcon = writeRefcon;
+    return &r;
+}
+
+void XPLMUnregisterDataAccessor(XPLMDataRef handle)
+{
+    count();
+    DataRef* r = ref(handle);
+    if (r && r->plugin)
+    {
+        dataRefs.erase(r->name);
+    }
+}
+
+//==========================================================================
+// XPLMProcessing
+//==========================================================================
+
+float XPLMGetElapsedTime(void)
+{
+    count();
+    return static_cast<float>(elapsed);
+}
+
+int XPLMGetCycleNumber(void)
+{
+    count();
+    return cycle;
+}
+
+XPLMFlightLoopID XPLMCreateFlightLoop(XPLMCreateFlightLoop_t* params)
+{
+    count();
+    auto loop = std::make_unique<FlightLoop>();
+    loop->params = *params;
+    loop->lastCall = elapsed;
+    flightLoops.push_back(std::move(loop));
+    return flightLoops.back().get();
+}
+
+void XPLMDestroyFlightLoop(XPLMFlightLoopID id)
+{
+    count();
+    // Removed after the current frame, so a callback may destroy its own loop
+    static_cast<FlightLoop*>(id)->alive = false;
+}
+
+void XPLMScheduleFlightLoop(XPLMFlightLoopID id, float interval, int)
+{
+    count();
+    schedule(*static_cast<FlightLoop*>(id), interval);
+}
+
+void XPLMRegisterFlightLoopCallback(XPLMFlightLoop_f callback, float interval, void* refcon)
+{
+    count();
+    auto loop = std::make_unique<FlightLoop>();
+    loop->params = {static_cast<int>(sizeof(XPLMCreateFlightLoop_t)),
+                    xplm_FlightLoop_Phase_BeforeFlightModel, callback, refcon};
+    loop->legacyCallback = callback;
+    loop->lastCall = elapsed;
+    schedule(*loop, interval);
+    flightLoops.push_back(std::move(loop));
+}
+
+void XPLMUnregisterFlightLoopCallback(XPLMFlightLoop_f callback, void* refcon)
+{
+    count();
+    for (const auto& loop : flightLoops)
+    {
+        if (loop->alive && loop->legacyCallback == callback && loop->params.refcon == refcon)
+        {
+            loop->alive = false;
+            return;
+        }
+    }
+}
+
+//==========================================================================
+// XPLMMenus
+//==========================================================================
+
+XPLMMenuID XPLMFindPluginsMenu(void)
+{
+    count();
+    return &pluginsMenu;
+}
+
+XPLMMenuID XPLMFindAircraftMenu(void)
+{
+    count();
+    return nullptr;
+}
+
+XPLMMenuID XPLMCreateMenu(const char* name, XPLMMenuID, int, XPLMMenuHandler_f handler,
+                          void* menuRef)
+{
+    count();
+    auto m = std::make_unique<Menu>();
+    m->title = name ? name : "";
+    m->handler = handler;
+    m->menuRef = menuRef;
+    menus.push_back(std::move(m));
+    return menus.back().get();
+}
+
+void XPLMDestroyMenu(XPLMMenuID id)
+{
+    count();
+    if (Menu* m = menu(id))
+    {
+        m->alive = false;
+        m->items.clear();
+    }
+}
+
+void XPLMClearAllMenuItems(XPLMMenuID id)
+{
+    count();
+    if (Menu* m = menu(id))
+    {
+        m->items.clear();
+    }
+}
+
+int XPLMAppendMenuItem(XPLMMenuID id, const char* title, void* itemRef, int)
+{
+    count();
+    Menu* m = menu(id);
+    if (!m)
+    {
+        return -1;
+    }
+    MenuEntry item;
+    item.title = title ? title : "";
+    item.itemRef = itemRef;
+    m->items.push_back(item);
+    return static_cast<int>(m->items.size()) - 1;
+}
+
+int XPLMAppendMenuItemWithCommand(XPLMMenuID id, const char* title, XPLMCommandRef command)
+{
+    count();
+    Menu* m = menu(id);
+    if (!m)
+    {
+        return -1;
+    }
+    MenuEntry item;
+    item.title = title ? title : "";
+    item.command = command;
+    m->items.push_back(item);
+    return static_cast<int>(m->items.size()) - 1;
+}
+
+void XPLMAppendMenuSeparator(XPLMMenuID id)
+{
+    count();
+    if (Menu* m = menu(id))
+    {
+        MenuEntry item;
+        item.separator = true;
+        m->items.push_back(item);
+    }
+}
+
+void XPLMSetMenuItemName(XPLMMenuID id, int index, const char* title, int)
+{
+    count();
+    if (MenuEntry* item = menuEntry(id, index))
+    {
+        item->title = title ? title : "";
+    }
+}
+
+void XPLMCheckMenuItem(XPLMMenuID id, int index, XPLMMenuCheck check)
+{
+    count();
+    if (MenuEntry* item = menuEntry(id, index))
+    {
+        item->check = check;
+    }
+}
+
+void XPLMCheckMenuItemState(XPLMMenuID id, int index, XPLMMenuCheck* check)
+{
+    count();
+    MenuEntry* item = menuEntry(id, index);
+    if (item && check)
+    {
+        *check = item->check;
+    }
+}
+
+void XPLMEnableMenuItem(XPLMMenuID id, int index, int enabled)
+{
+    count();
+    if (MenuEntry* item = menuEntry(id, index))
+    {
+        item->enabled = enabled != 0;
+    }
+}
+
+void XPLMRemoveMenuItem(XPLMMenuID id, int index)
+{
+    count();
+    Menu* m = menu(id);
+    if (m && index >= 0 && index < static_cast<int>(m->items.size()))
+    {
+        m->items.erase(m->items.begin() + index);
+    }
+}
+
+//==========================================================================
+// XPLMPlugin
+//==========================================================================
+
+XPLMPluginID XPLMGetMyID(void)
+{
+    count();
+    return 1;
+}
+
+int XPLMCountPlugins(void)
+{
+    count();
+    return 1;
+}
+
+XPLMPluginID XPLMGetNthPlugin(int index)
+{
+    count();
+    return index == 0 ? 1 : XPLM_NO_PLUGIN_ID;
+}
+
+XPLMPluginID XPLMFindPluginBySignature(const char*)
+{
+    count();
+    return XPLM_NO_PLUGIN_ID; // No DataRefEditor / DataRefTool in the replay
+}
+
+void XPLMGetPluginInfo(XPLMPluginID, char* name, char* path, char* signature, char* description)
+{
+    count();
+    // The SDK documents 256-byte buffers
+    auto copy = [](char* out, const std::string& text)
+    {
+        if (out)
+        {
+            std::strncpy(out, text.c_str(), 255);
+            out[255] = '\0';
+        }
+    };
+    copy(name, "Frame Replay");
+    copy(path, pluginPath);
+    copy(signature, "xplaneutilities.framereplay");
+    copy(description, "xpu-frame-replay harness");
+}
+
+int XPLMIsPluginEnabled(XPLMPluginID)
+{
+    count();
+    return 1;
+}
+
+void XPLMSendMessageToPlugin(XPLMPluginID, int, void*)
+{
+    count();
+}
+
+//==========================================================================
+// XPLMUtilities
+//==========================================================================
+
+void XPLMDebugString(const char*)
+{
+    count();
+}
+
+void XPLMGetSystemPath(char* path)
+{
+    count();
+    std::strcpy(path, "./");
+}
+
+XPLMCommandRef XPLMFindCommand(const char* name)
+{
+    count();
+    auto it = commands.find(name);
+    return it == commands.end() ? nullptr : it->second.get();
+}
+
+XPLMCommandRef XPLMCreateCommand(const char* name, const char* description)
+{
+    count();
+    auto& slot = commands[name];
+    if (!slot)
+    {
+        slot = std::make_unique<Command>();
+        slot->name = name;
+        slot->description = description ? description : "";
+    }
+    return slot.get();
+}
+
+void XPLMCommandBegin(XPLMCommandRef command)
+{
+    count();
+    runCommand(*static_cast<Command*>(command), xplm_CommandBegin);
+}
+
+void XPLMCommandEnd(XPLMCommandRef command)
+{
+    count();
+    runCommand(*static_cast<Command*>(command), xplm_CommandEnd);
+}
+
+void XPLMCommandOnce(XPLMCommandRef command)
+{
+    count();
+    runCommand(*static_cast<Command*>(command), xplm_CommandBegin);
+    runCommand(*static_cast<Command*>(command), xplm_CommandEnd);
+}
+
+void XPLMRegisterCommandHandler(XPLMCommandRef command, XPLMCommandCallback_f callback, int before,
+                                void* refcon)
+{
+    count();
+    static_cast<Command*>(command)->handlers.push_back({callback, before, refcon});
+}
+
+void XPLMUnregisterCommandHandler(XPLMCommandRef command, XPLMCommandCallback_f callback,
+                                  int before, void* refcon)
+{
+    count();
+    auto& handlers = static_cast<Command*>(command)->handlers;
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                  [&](const CommandHandler& h)
+                                  {
+                                      return h.callback == callback && h.before == before &&
+                                             h.refcon == refcon;
+                                  }),
+                   handlers.end());
+}
@@ -0,0 +1,60 @@
+#ifndef MOCK_XPLM_H
+#define MOCK_XPLM_H
+
+/*
+ *   In-process stand-in for the XPLM library, used by xpu-frame-replay
+ *
+ *   Implements the data access, flight loop, menu, command, plugin and
+ *   utility calls the library makes, deterministically and single-threaded
+ *   (XPLMDebugString may also be called from logging threads). Simulator
+ *   datarefs are defined by the harness; datarefs registered by the plugin
+ *   are served through its accessors. Every XPLM call made by plugin code is
+ *   counted per thread; the control functions below are not.
+ */
+
+#include <XPLMDataAccess.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MockXPLM {
+
+// Simulator-owned dataref; scalars only, arrays have arraySize elements
+bool defineDataRef(const std::string &name, XPLMDataTypeID types, bool writable,
+                   int arraySize = 0);
+
+// Set a simulator dataref, or write a plugin dataref through its accessor
+bool setValue(const std::string &name, double value);
+bool setElement(const std::string &name, int index, double value);
+
+bool hasDataRef(const std::string &name);
+
+// Value as the plugin would read it with the widest scalar type
+bool getValue(const std::string &name, double &value);
+
+// Names of the datarefs the plugin registered
+std::vector<std::string> pluginDataRefs();
+
+// Read every plugin dataref once through each of its advertised types, as
+// DataRefEditor or a cockpit would; returns the number of accessor calls
+std::size_t readPluginDataRefs();
+
+// Advance the simulated clock and run the due flight loops, the
+// BeforeFlightModel phase first, each phase in creation order
+void runFrame(float dt);
+std::size_t flightLoopCount();
+
+// Choose the first menu item with this title, as a click would
+bool chooseMenuItem(const std::string &title);
+
+// Path returned by XPLMGetPluginInfo for the plugin itself
+void setPluginPath(const std::string &path);
+
+// XPLM calls made by plugin code on this thread since start
+std::uint64_t sdkCalls();
+
+} // namespace MockXPLM
+
+#endif // MOCK_XPLM_H
@@ -0,0 +1,186 @@
+/*
+ *   Sample plugin replayed by xpu-frame-replay
+ *
+ *   Exercises the per-frame paths of the library the way a typical plugin
+ *   does: FlightDataProvider reads, DerivedMetrics with exported nodes,
+ *   DataRefExport accessors, batched writes through DataRefWriteBatch, menu
+ *   actions (one of which destroys and rebuilds its own submenu) and a
+ *   display flight loop formatting flight data, refreshing a menu title and
+ *   logging a status line every ten seconds. Replace it with
+ *   your own plugin sources through XPLANE_UTILITIES_REPLAY_PLUGIN_SOURCES.
+ */
+
+#include <XPlaneUtilities/DataRefAccess.h>
+#include <XPlaneUtilities/DataRefExport.h>
+#include <XPlaneUtilities/DataRefWriteBatch.h>
+#include <XPlaneUtilities/DerivedMetrics.h>
+#include <XPlaneUtilities/FlightDataFormat.h>
+#include <XPlaneUtilities/FlightDataProvider.h>
+#include <XPlaneUtilities/MenuHandler.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <XPLMDefs.h>
+#include <XPLMProcessing.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+using namespace XPlaneUtilities;
+
+namespace
+{
+struct Workload
+{
+    FlightDataProvider flightData;
+    DerivedMetrics metrics;
+    DataRefWriteBatch writes;
+    DataRefAccess<int> beacon{"sim/cockpit/electrical/beacon_lights_on", 0};
+    std::unique_ptr<DataRefExport<float>> fuelTons;
+    std::unique_ptr<DataRefExport<int>> beaconCount;
+    std::unique_ptr<MenuItem> menu;
+    MenuItem::Item beaconItem;
+    MenuItem::Item fuelItem;
+    std::unique_ptr<MenuItem> units; // Rebuilt by its own item, as DynamicMenu does
+    bool metricUnits = true;
+    XPLMFlightLoopID displayLoop = nullptr;
+
+    int toggles = 0;
+    int displayFrames = 0;
+    char utc[FlightDataFormat::kTimeHHMMSSSize];
+    char fuelTitle[32];
+    fmt::memory_buffer line;
+};
+
+std::unique_ptr<Workload> workload;
+
+float displayCallback(float, float, int, void* refcon)
+{
+    Workload& w = *static_cast<Workload*>(refcon);
+
+    FlightDataFormat::formatTimeHHMMSS(w.utc, w.flightData.getZuluTimeSec());
+    w.line.clear();
+    FlightDataFormat::formatLatitudeDMS(w.line, w.flightData.getLatitude());
+    w.line.push_back(' ');
+    FlightDataFormat::formatLongitudeDMS(w.line, w.flightData.getLongitude());
+    w.line.push_back(' ');
+    FlightDataFormat::formatAltitude(w.line, w.flightData.getElevation() * 3.28084, 18000.0);
+
+    // Beacon follows the engine state: on while there is fuel flow
+    const double flow = w.metrics.get(w.metrics.find("fuel_flow"));
+    const bool burning = flow > 1e-3;
+    if (burning != (w.beacon.get() != 0))
+    {
+        w.beacon = burning ? 1 : 0;
+    }
+
+    std::snprintf(w.fuelTitle, sizeof(w.fuelTitle), "Fuel %.2f t",
+                  FlightDataProvider::kgToTons(w.flightData.getFuelOnBoard()));
+    w.fuelItem.setTitle(w.fuelTitle);
+
+    if (++w.displayFrames % 600 == 0)
+    {
+        XPLANE_LOG_INFO("{} {}, fuel flow {:.3f} kg/s", w.utc,
+                        std::string_view(w.line.data(), w.line.size()), flow);
+    }
+    return -1.0f;
+}
+
+void toggleBeacon()
+{
+    ++workload->toggles;
+    workload->beacon = workload->beacon.get() ? 0 : 1;
+    workload->beaconItem.setChecked(workload->beacon.get() != 0);
+}
+
+// The item's action replaces the submenu that holds it
+void buildUnitsMenu()
+{
+    Workload& w = *workload;
+    w.units = w.menu->addSubMenu("Units");
+    w.units->addSubItem(w.metricUnits ? "Imperial units" : "Metric units",
+                        []()
+                        {
+                            workload->metricUnits = !workload->metricUnits;
+                            buildUnitsMenu();
+                        });
+}
+} // namespace
+
+PLUGIN_API int XPluginStart(char* name, char* sig, char* desc)
+{
+    std::strcpy(name, "Frame Replay Workload");
+    std::strcpy(sig, "xplaneutilities.replay.workload");
+    std::strcpy(desc, "Sample plugin for xpu-frame-replay");
+
+    XPlaneLog::init("FrameReplay");
+    workload = std::make_unique<Workload>();
+    Workload& w = *workload;
+
+    w.metrics.addFlightData(w.flightData);
+    const int fuel = w.metrics.find("fuel");
+    const int percent = w.metrics.addFormula("fuel_percent", {fuel}, [](const double* in)
+                                             { return in[0] / 20000.0 * 100.0; });
+    w.metrics.exportNode(percent, "xpu/replay/fuel_percent");
+    w.metrics.exportNode(w.metrics.find("time_to_empty"), "xpu/replay/time_to_empty");
+    w.metrics.exportNode(w.metrics.find("distance_flown"), "xpu/replay/distance_flown");
+
+    w.fuelTons = std::make_unique<DataRefExport<float>>(
+        "xpu/replay/fuel_tons", &w,
+        [](void* ref)
+        {
+            return FlightDataProvider::kgToTons(
+                static_cast<Workload*>(ref)->flightData.getFuelOnBoard());
+        },
+        xplmType_Float | xplmType_Double);
+    w.beaconCount = std::make_unique<DataRefExport<int>>(
+        "xpu/replay/beacon_toggles", &w,
+        [](void* ref) { return static_cast<Workload*>(ref)->toggles; },
+        [](void* ref, int value) { static_cast<Workload*>(ref)->toggles = value; });
+
+    w.menu = std::make_unique<MenuItem>("Frame Replay");
+    w.beaconItem = w.menu->addSubItem("Toggle beacon", toggleBeacon);
+    w.fuelItem = w.menu->addSubItem("Fuel", []() {});
+    w.menu->addSeparator();
+    w.menu->addSubItem("Reset metrics", []() { workload->metrics.reset(); });
+    buildUnitsMenu();
+    return 1;
+}
+
+PLUGIN_API int XPluginEnable()
+{
+    Workload& w = *workload;
+    w.writes.activate();
+    w.writes.enableFlightLoop(xplm_FlightLoop_Phase_AfterFlightModel);
+    w.beacon = w.beacon.get(); // Gives the beacon its batch entry before the first frame
+    w.metrics.enableFlightLoop();
+
+    XPLMCreateFlightLoop_t params = {sizeof(XPLMCreateFlightLoop_t),
+                                     xplm_FlightLoop_Phase_BeforeFlightModel, displayCallback,
+                                     &w};
+    w.displayLoop = XPLMCreateFlightLoop(&params);
+    XPLMScheduleFlightLoop(w.displayLoop, -1.0f, 1);
+    return 1;
+}
+
+PLUGIN_API void XPluginDisable()
+{
+    Workload& w = *workload;
+    XPLMDestroyFlightLoop(w.displayLoop);
+    w.displayLoop = nullptr;
+    w.metrics.disableFlightLoop();
+    w.writes.disableFlightLoop();
+    w.writes.flush();
+    w.writes.deactivate();
+}
+
+PLUGIN_API void XPluginStop()
+{
+    workload.reset();
+    XPlaneLog::shutdown();
+}
+
+PLUGIN_API void XPluginReceiveMessage(XPLMPluginID, int, void*)
+{
+}
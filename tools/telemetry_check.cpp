@@ -0,0 +1,590 @@
+/*
+ *   xpu-telemetry-check - Round-trip checks of the telemetry transports
+ *
+ *   Usage: xpu-telemetry-check
+ *
+ *   Runs a SharedTelemetryPublisher against mock_xplm.cpp and reads its
+ *   segment from a separate (forked) process with SharedTelemetryReader,
+ *
+ *       snapshots    every snapshot the reader process copies while the
+ *                    publisher runs flat out is consistent
+ *       stale        opening over a segment left by an earlier run does not
+ *                    resize or clear it under a process that still maps it
+ *       ownership    close() does not unlink a segment another publisher
+ *                    created under the same name since
+ *
+ *   and passes TelemetryStreamer frames from the encoder to the decoder:
+ *
+ *       loopback     descriptions, keyframes and deltas split over many
+ *                    small frames decode to the encoded values
+ *       loss         after a lost frame deltas are ignored until a keyframe
+ *       reorder      reordered and duplicated frames are dropped without
+ *                    counting as lost; a restarted sender is picked up
+ *       malformed    crafted frames (huge or wrapping channel ids, unknown
+ *                    types, truncation, random bytes) are rejected without
+ *                    growing the decoder
+ *
+ *   Prints one line per check and exits 1 if any failed.
+ */
+
+#include "mock_xplm.h"
+
+#include <XPlaneUtilities/SharedTelemetry.h>
+#include <XPlaneUtilities/SharedTelemetryPublisher.h>
+#include <XPlaneUtilities/TelemetryStream.h>
+#include <XPlaneUtilities/XPlaneLog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using XPlaneUtilities::SharedTelemetryPublisher;
+using XPlaneUtilities::SharedTelemetryReader;
+using XPlaneUtilities::SharedTelemetrySnapshot;
+using XPlaneUtilities::TelemetryFrameDecoder;
+using XPlaneUtilities::TelemetryFrameEncoder;
+using XPlaneUtilities::TelemetrySample;
+using XPlaneUtilities::TelemetryUpdate;
+namespace TelemetryStream = XPlaneUtilities::TelemetryStream;
+
+using Frames = std::vector<std::vector<std::uint8_t>>;
+
+namespace
+{
+int failures = 0;
+
+void report(const char* check, bool ok, const std::string& detail = std::string())
+{
+    if (ok)
+    {
+        std::printf("ok    %s\n", check);
+    }
+    else
+    {
+        std::printf("FAIL  %s: %s\n", check, detail.c_str());
+        ++failures;
+    }
+}
+
+// Exit status of a child process as text, empty for a clean exit(0)
+std::string childFailure(int status)
+{
+    if (WIFSIGNALED(status))
+    {
+        return "reader killed by signal " + std::to_string(WTERMSIG(status));
+    }
+    if (WEXITSTATUS(status) != 0)
+    {
+        return "reader exited with " + std::to_string(WEXITSTATUS(status));
+    }
+    return std::string();
+}
+
+//==========================================================================
+// Shared memory
+//==========================================================================
+
+// Reader process: copy snapshots until one from frame minFrames or later
+// arrives; exit 1 on a torn snapshot, 2 if the segment never appears or
+// stops advancing
+[[noreturn]] void readSnapshots(const std::string& name, std::uint64_t minFrames)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    SharedTelemetryReader reader;
+    while (!reader.open(name))
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            _exit(2);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    SharedTelemetrySnapshot snapshot;
+    std::uint64_t lastFrame = 0;
+    while (lastFrame < minFrames)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            _exit(2);
+        }
+        if (!reader.read(snapshot) || snapshot.frame == 0)
+        {
+            continue;
+        }
+
+        const double k = snapshot.values[0];
+        if (snapshot.values[1] != 2.0 * k || snapshot.values[2] != -k ||
+            snapshot.frame < lastFrame || k != static_cast<double>(snapshot.frame))
+        {
+            _exit(1);
+        }
+        lastFrame = snapshot.frame;
+    }
+    _exit(0);
+}
+
+void checkSnapshots(const std::string& name)
+{
+    constexpr std::uint64_t kFrames = 20000;
+
+    double k = 0.0;
+    SharedTelemetryPublisher publisher(name);
+    publisher.addChannel("check/k", [&k]() { return k; });
+    publisher.addChannel("check/twice_k", [&k]() { return 2.0 * k; });
+    publisher.addChannel("check/minus_k", [&k]() { return -k; });
+    if (!publisher.open())
+    {
+        report("snapshots", false, "open() failed");
+        return;
+    }
+
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        readSnapshots(name, kFrames);
+    }
+
+    // Publish flat out until the reader has seen enough frames
+    int status = 0;
+    while (waitpid(child, &status, WNOHANG) == 0)
+    {
+        k += 1.0;
+        publisher.publish();
+    }
+    publisher.close();
+
+    const std::string failure = childFailure(status);
+    report("snapshots", failure.empty(),
+           WIFEXITED(status) && WEXITSTATUS(status) == 1 ? "torn snapshot" : failure);
+}
+
+void checkStaleSegment(const std::string& name)
+{
+    // A segment left by an earlier run, larger than the new one, with a
+    // pattern the reader process verifies after the publisher has opened
+    constexpr std::size_t kStaleSize = 64 * 1024;
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, kStaleSize) != 0)
+    {
+        report("stale", false, std::string("cannot create segment: ") + std::strerror(errno));
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return;
+    }
+    void* stale = mmap(nullptr, kStaleSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    std::memset(stale, 0xAB, kStaleSize);
+
+    int go[2];
+    if (pipe(go) != 0)
+    {
+        report("stale", false, "pipe() failed");
+        return;
+    }
+
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        // Keeps the inherited mapping, as a reader of the old run would
+        char byte;
+        close(go[1]);
+        if (read(go[0], &byte, 1) != 1)
+        {
+            _exit(2);
+        }
+        const unsigned char* bytes = static_cast<const unsigned char*>(stale);
+        for (std::size_t i = 0; i < kStaleSize; ++i)
+        {
+            if (bytes[i] != 0xAB)
+            {
+                _exit(1);
+            }
+        }
+        _exit(0);
+    }
+    close(go[0]);
+    munmap(stale, kStaleSize);
+
+    SharedTelemetryPublisher publisher(name);
+    publisher.addChannel("check/value", []() { return 1.0; });
+    const bool opened = publisher.open();
+    publisher.publish();
+
+    const char byte = 1;
+    (void)!write(go[1], &byte, 1);
+    close(go[1]);
+    int status = 0;
+    waitpid(child, &status, 0);
+
+    SharedTelemetryReader reader;
+    const bool fresh = reader.open(name) && reader.channelCount() == 1;
+
+    std::string failure = childFailure(status);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 1)
+    {
+        failure = "old segment overwritten";
+    }
+    if (!opened)
+    {
+        failure = "open() failed";
+    }
+    else if (!fresh)
+    {
+        failure = "new segment not readable";
+    }
+    report("stale", failure.empty(), failure);
+}
+
+void checkOwnership(const std::string& name)
+{
+    SharedTelemetryPublisher first(name);
+    first.addChannel("check/first", []() { return 1.0; });
+    SharedTelemetryPublisher second(name);
+    second.addChannel("check/second_a", []() { return 2.0; });
+    second.addChannel("check/second_b", []() { return 3.0; });
+
+    std::string failure;
+    if (!first.open() || !second.open())
+    {
+        failure = "open() failed";
+    }
+    else
+    {
+        first.close();
+        SharedTelemetryReader reader;
+        if (!reader.open(name) || reader.channelCount() != 2)
+        {
+            failure = "first publisher unlinked the second one's segment";
+        }
+
+        second.close();
+        if (failure.empty() && reader.open(name))
+        {
+            failure = "segment still linked after its publisher closed";
+        }
+    }
+    report("ownership", failure.empty(), failure);
+}
+
+//==========================================================================
+// Frame codec
+//==========================================================================
+
+// Feed frames to the decoder; false if any is rejected
+bool decodeAll(TelemetryFrameDecoder& decoder, const Frames& frames,
+               std::vector<TelemetryUpdate>& updates)
+{
+    bool ok = true;
+    for (const auto& frame : frames)
+    {
+        ok = decoder.decode(frame.data(), frame.size(), updates) && ok;
+    }
+    return ok;
+}
+
+void checkLoopback()
+{
+    constexpr std::uint32_t kChannels = 300;
+    std::vector<std::string> names;
+    std::vector<double> resolutions;
+    for (std::uint32_t i = 0; i < kChannels; ++i)
+    {
+        names.push_back("check/channel_" + std::to_string(i));
+        resolutions.push_back(i % 2 ? 0.01 : 1e-7);
+    }
+
+    // A small MTU splits every message over several frames
+    TelemetryFrameEncoder encoder(kChannels, 200);
+    TelemetryFrameDecoder decoder;
+    std::vector<std::int64_t> expected(kChannels, 0);
+    std::vector<TelemetryUpdate> updates;
+    Frames frames;
+    std::string failure;
+
+    encoder.encodeDescription(names, resolutions, 0, frames);
+    encoder.encodeKeyframe(0, frames);
+    if (frames.size() < 3 || !decodeAll(decoder, frames, updates))
+    {
+        failure = "description or keyframe rejected";
+    }
+
+    std::mt19937_64 random(29);
+    for (std::uint64_t step = 1; step <= 200 && failure.empty(); ++step)
+    {
+        // Changes of every magnitude, sorted by channel as the encoder expects
+        std::vector<TelemetrySample> changes;
+        for (std::uint32_t i = 0; i < kChannels; ++i)
+        {
+            if (random() % 3 == 0)
+            {
+                const int bits = static_cast<int>(random() % 50);
+                const auto delta = static_cast<std::int64_t>(random() >> (63 - bits)) -
+                                   (std::int64_t{1} << bits) / 2;
+                expected[i] += delta;
+                changes.push_back({i, expected[i]});
+            }
+        }
+
+        frames.clear();
+        updates.clear();
+        encoder.encodeDelta(changes, step * 10, frames);
+        if (!decodeAll(decoder, frames, updates) || updates.size() != changes.size())
+        {
+            failure = "delta frames rejected or incomplete at step " + std::to_string(step);
+            break;
+        }
+        for (const TelemetryUpdate& update : updates)
+        {
+            if (update.value != static_cast<double>(expected[update.channel]) *
+                                    resolutions[update.channel])
+            {
+                failure = "wrong value for channel " + std::to_string(update.channel);
+                break;
+            }
+        }
+    }
+
+    if (failure.empty() && (decoder.channelCount() != kChannels ||
+                            decoder.channelName(kChannels - 1) != names.back() ||
+                            decoder.lostFrames() != 0))
+    {
+        failure = "channel names or frame count differ";
+    }
+    report("loopback", failure.empty(), failure);
+}
+
+void checkLoss()
+{
+    TelemetryFrameEncoder encoder(4);
+    TelemetryFrameDecoder decoder;
+    std::vector<TelemetryUpdate> updates;
+    Frames frames;
+    std::string failure;
+
+    encoder.encodeKeyframe(0, frames);
+    encoder.encodeDelta({{0, 5}, {2, 7}}, 10, frames);
+    encoder.encodeDelta({{0, 6}}, 20, frames); // Lost
+    encoder.encodeDelta({{0, 8}, {2, 9}}, 30, frames);
+    frames.erase(frames.begin() + 2);
+    decodeAll(decoder, frames, updates);
+
+    // Keyframe (4 channels) and first delta (2) only
+    if (updates.size() != 6 || decoder.lostFrames() != 1)
+    {
+        failure = "deltas applied across a gap";
+    }
+
+    frames.clear();
+    updates.clear();
+    encoder.encodeKeyframe(40, frames);
+    decodeAll(decoder, frames, updates);
+    if (failure.empty() && (updates.size() != 4 || updates[0].value != 8.0 || updates[2].value != 9.0))
+    {
+        failure = "keyframe did not resynchronise";
+    }
+    report("loss", failure.empty(), failure);
+}
+
+void checkReorder()
+{
+    TelemetryFrameEncoder encoder(4);
+    TelemetryFrameDecoder decoder;
+    std::vector<TelemetryUpdate> updates;
+    Frames frames;
+    std::string failure;
+
+    encoder.encodeKeyframe(0, frames);
+    encoder.encodeDelta({{0, 5}}, 10, frames);
+    encoder.encodeDelta({{0, 6}}, 20, frames);
+    const Frames sent = frames;
+
+    // Duplicate: applied once
+    frames = {sent[0], sent[1], sent[1], sent[2]};
+    decodeAll(decoder, frames, updates);
+    if (updates.size() != 6 || updates.back().value != 6.0 || decoder.lostFrames() != 0 ||
+        decoder.staleFrames() != 1)
+    {
+        failure = "duplicate applied twice or counted as lost";
+    }
+
+    // Reordered: the late frame is dropped and the gap counts one frame
+    encoder.encodeDelta({{0, 7}}, 30, frames);
+    TelemetryFrameDecoder late;
+    frames = {sent[0], sent[2], sent[1], frames.back()};
+    updates.clear();
+    if (failure.empty() && (!decodeAll(late, frames, updates) || updates.size() != 4 ||
+                            late.lostFrames() != 1 || late.staleFrames() != 1))
+    {
+        failure = "reordered frame applied or counted as lost";
+    }
+
+    // A sender restarting far behind the last sequence is followed again
+    for (std::uint32_t i = 0; i < 2 * TelemetryStream::kReorderWindow; ++i)
+    {
+        frames.clear();
+        encoder.encodeDelta({{1, static_cast<std::int64_t>(i)}}, 50, frames);
+        decodeAll(decoder, frames, updates);
+    }
+    const std::uint64_t lost = decoder.lostFrames();
+    TelemetryFrameEncoder restarted(4);
+    frames.clear();
+    updates.clear();
+    restarted.encodeKeyframe(60, frames);
+    if (failure.empty() && (!decodeAll(decoder, frames, updates) || updates.size() != 4 ||
+                            decoder.lostFrames() != lost))
+    {
+        failure = "restarted sender ignored";
+    }
+    report("reorder", failure.empty(), failure);
+}
+
+// Frame header followed by caller-written entries. Each frame is newer than
+// the last, so the decoder never drops one as stale.
+std::vector<std::uint8_t> craftFrame(std::uint8_t type, std::uint64_t count)
+{
+    static std::uint64_t sequence = 0;
+    std::vector<std::uint8_t> frame = {TelemetryStream::kMagic0, TelemetryStream::kMagic1,
+                                       TelemetryStream::kVersion, type};
+    TelemetryStream::writeVarint(frame, sequence++);
+    TelemetryStream::writeVarint(frame, 0);
+    TelemetryStream::writeVarint(frame, count);
+    return frame;
+}
+
+std::vector<std::uint8_t> craftDescription(std::uint64_t id)
+{
+    std::vector<std::uint8_t> frame =
+        craftFrame(static_cast<std::uint8_t>(TelemetryStream::FrameType::Description), 1);
+    TelemetryStream::writeVarint(frame, id);
+    frame.insert(frame.end(), 8, 0); // Resolution 0.0
+    TelemetryStream::writeVarint(frame, 1);
+    frame.push_back('x');
+    return frame;
+}
+
+std::vector<std::uint8_t> craftValues(TelemetryStream::FrameType type,
+                                      const std::vector<std::uint64_t>& idDeltas)
+{
+    std::vector<std::uint8_t> frame = craftFrame(static_cast<std::uint8_t>(type), idDeltas.size());
+    for (std::uint64_t idDelta : idDeltas)
+    {
+        TelemetryStream::writeVarint(frame, idDelta);
+        TelemetryStream::writeVarint(frame, TelemetryStream::zigzagEncode(1));
+    }
+    return frame;
+}
+
+void checkMalformed()
+{
+    using TelemetryStream::FrameType;
+    const std::uint64_t limit = TelemetryStream::kMaxChannels;
+
+    struct Case
+    {
+        const char* what;
+        std::vector<std::uint8_t> frame;
+    };
+    const Case rejected[] = {
+        {"description id above 32 bits", craftDescription((std::uint64_t{1} << 40) + 3)},
+        {"description id 0xFFFFFFFF", craftDescription(0xFFFFFFFFull)},
+        {"description id at the limit", craftDescription(limit)},
+        {"keyframe id 0xFFFFFFFF", craftValues(FrameType::Keyframe, {0xFFFFFFFFull})},
+        {"keyframe id wrapping to 0", craftValues(FrameType::Keyframe, {0xFFFFFFFFull, 1})},
+        {"delta ids summing past the limit", craftValues(FrameType::Delta, {limit / 2, limit / 2})},
+        {"delta id above 32 bits", craftValues(FrameType::Delta, {std::uint64_t{1} << 33})},
+        {"unknown frame type", craftValues(static_cast<FrameType>(7), {0})},
+    };
+
+    TelemetryFrameDecoder decoder;
+    std::vector<TelemetryUpdate> updates;
+    std::string failure;
+    for (const Case& c : rejected)
+    {
+        if (decoder.decode(c.frame.data(), c.frame.size(), updates))
+        {
+            failure = std::string("accepted ") + c.what;
+            break;
+        }
+    }
+
+    // The largest valid id is still accepted
+    const auto last = craftValues(FrameType::Keyframe, {limit - 1});
+    if (failure.empty() && (!decoder.decode(last.data(), last.size(), updates) ||
+                            decoder.channelCount() != limit))
+    {
+        failure = "rejected the largest channel id";
+    }
+
+    // Every truncation of valid frames, then random bytes behind a valid header
+    TelemetryFrameEncoder encoder(64, 300);
+    Frames frames;
+    encoder.encodeDescription(std::vector<std::string>(64, "check/name"),
+                              std::vector<double>(64, 0.5), 0, frames);
+    encoder.encodeKeyframe(0, frames);
+    for (const auto& frame : frames)
+    {
+        for (std::size_t length = 0; length < frame.size(); ++length)
+        {
+            TelemetryFrameDecoder fresh;
+            fresh.decode(frame.data(), length, updates);
+        }
+    }
+
+    std::mt19937 random(29);
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::vector<std::uint8_t> frame = craftFrame(static_cast<std::uint8_t>(random() % 4),
+                                                     random() % 16);
+        const std::size_t header = frame.size();
+        frame.resize(header + random() % 64);
+        for (std::size_t b = header; b < frame.size(); ++b)
+        {
+            frame[b] = static_cast<std::uint8_t>(random());
+        }
+        updates.clear();
+        decoder.decode(frame.data(), frame.size(), updates);
+    }
+    if (failure.empty() && decoder.channelCount() > limit)
+    {
+        failure = "random frames grew the decoder past the limit";
+    }
+    report("malformed", failure.empty(), failure);
+}
+
+} // namespace
+
+int main()
+{
+    // XPlaneLog puts its file two levels above the plugin binary
+    const std::filesystem::path logDir = std::filesystem::temp_directory_path();
+    MockXPLM::setPluginPath((logDir / "64" / "check.xpl").string());
+    XPlaneLog::init("xpu-telemetry-check");
+
+    const std::string name = "/xpu_telemetry_check_" + std::to_string(getpid());
+    checkSnapshots(name);
+    checkStaleSegment(name);
+    checkOwnership(name);
+    shm_unlink(name.c_str());
+
+    checkLoopback();
+    checkLoss();
+    checkReorder();
+    checkMalformed();
+
+    XPlaneLog::shutdown();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+/*
+ *   xpu-telemetry-dump - Print snapshots from a SharedTelemetryPublisher segment
+ *
+ *   Usage: xpu-telemetry-dump [--once] [--interval ms] /segment_name
+ */
+
+#include <XPlaneUtilities/SharedTelemetry.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using XPlaneUtilities::SharedTelemetryReader;
+using XPlaneUtilities::SharedTelemetrySnapshot;
+
+static void printUsage(const char* argv0)
+{
+    std::fprintf(stderr, "Usage: %s [--once] [--interval ms] /segment_name\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+    bool once = false;
+    int intervalMs = 1000;
+    std::string name;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--once") == 0)
+        {
+            once = true;
+        }
+        else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc)
+        {
+            intervalMs = std::atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-' || argv[i][1] == '\0')
+        {
+            name = argv[i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (name.empty())
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    SharedTelemetryReader reader;
+    if (!reader.open(name))
+    {
+        std::fprintf(stderr, "Cannot map telemetry segment '%s'\n", name.c_str());
+        return 1;
+    }
+
+    SharedTelemetrySnapshot snapshot;
+    do
+    {
+        if (!reader.read(snapshot))
+        {
+            std::fprintf(stderr, "Snapshot busy, retrying\n");
+        }
+        else
+        {
+            std::printf("frame %llu  t=%.3f\n", static_cast<unsigned long long>(snapshot.frame),
+                        snapshot.publishTime);
+            for (std::uint32_t i = 0; i < reader.channelCount(); ++i)
+            {
+                std::printf("  %-56s %.9g\n", reader.channelName(i).c_str(), snapshot.values[i]);
+            }
+            std::fflush(stdout);
+        }
+
+        if (!once)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+    } while (!once);
+
+    return 0;
+}
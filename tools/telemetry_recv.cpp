@@ -0,0 +1,103 @@
+/*
+ *   xpu-telemetry-recv - Receive and print a TelemetryStreamer UDP stream
+ *
+ *   Usage: xpu-telemetry-recv [--count frames] port
+ */
+
+#include <XPlaneUtilities/TelemetryStream.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using XPlaneUtilities::TelemetryFrameDecoder;
+using XPlaneUtilities::TelemetryUpdate;
+
+static void printUsage(const char* argv0)
+{
+    std::fprintf(stderr, "Usage: %s [--count frames] port\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+    long maxFrames = -1;
+    int port = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+        {
+            maxFrames = std::atol(argv[++i]);
+        }
+        else if (argv[i][0] != '-')
+        {
+            port = std::atoi(argv[i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (port <= 0 || port > 65535)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        std::perror("socket");
+        return 1;
+    }
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        std::perror("bind");
+        close(fd);
+        return 1;
+    }
+
+    TelemetryFrameDecoder decoder;
+    std::vector<TelemetryUpdate> updates;
+    std::uint8_t buffer[65536];
+
+    for (long frames = 0; maxFrames < 0 || frames < maxFrames; ++frames)
+    {
+        ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+        if (len < 0)
+        {
+            std::perror("recv");
+            break;
+        }
+
+        updates.clear();
+        if (!decoder.decode(buffer, static_cast<std::size_t>(len), updates))
+        {
+            std::fprintf(stderr, "Malformed frame (%zd bytes)\n", len);
+            continue;
+        }
+
+        for (const TelemetryUpdate& update : updates)
+        {
+            std::printf("%10llu %-56s %.9g\n",
+                        static_cast<unsigned long long>(decoder.lastTimestampMs()),
+                        decoder.channelName(update.channel).c_str(), update.value);
+        }
+        std::fflush(stdout);
+    }
+
+    close(fd);
+    return 0;
+}